@@ -32,11 +32,18 @@
 // Image Processing Libraries
 #include "ocr/base_types.hpp"
 #include "ocr/BMP_Loader.hpp"
+#include "ocr/Buffer_Pool.hpp"
 #include "ocr/Image.hpp"
 #include "ocr/Kernel_Image_Operator.hpp"
+#include "ocr/Pixel_Image.hpp"
 #include "ocr/input.hpp"
 #include "ocr/Feature_Loader.hpp"
 #include "ocr/Feature_Database.hpp"
+#include "ocr/Recognition_Pipeline.hpp"
+#include "ocr/Recognition_Server.hpp"
+#include "ocr/Recognizer.hpp"
+#include "ocr/Thread_Pool.hpp"
+#include "ocr/Traversal.hpp"
 
 // RapidJSON for loading/storing JSON elements
 #include <rapidjson/rapidjson.h>
@@ -48,17 +55,23 @@
 #include <dirent.h>
 
 // Data structures
+#include <algorithm>
 #include <list>
+#include <map>
 #include <vector>
 #include <string>
 
 // Standard Libraries (writing/math)
 #include <iostream>
 #include <fstream>
+#include <cstddef>
 #include <cstdlib>
 #include <cmath>
 #include <string>
+#include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <csignal>
 
 #ifndef M_PI
 #  define M_PI 3.14159265359
@@ -89,6 +102,11 @@ typedef std::vector<std::pair<std::string,ocr::Kernel_Image_Operator*>> kernel_c
 const int X_DIVS = 5;
 const int Y_DIVS = 5;
 
+// Pages are streamed through the filters, thresholds and labeling this many
+// rows at a time, so that memory use does not grow with the page size.
+// Labeling reads a halo of the same height, which bounds the tallest glyph.
+const std::size_t BAND_ROWS = 512;
+
 //----------------------------------------------------------------------------
 // Globals
 //----------------------------------------------------------------------------
@@ -96,8 +114,10 @@ const int Y_DIVS = 5;
 kernel_collection             g_kernels;
 ocr::feature_collection  g_scanned_image_features;
 ocr::boundary_collection g_scanned_image_boundaries;
-ocr::Image*              g_scanned_image;
+std::size_t              g_scanned_image_width;
+std::size_t              g_scanned_image_height;
 ocr::Feature_Database    g_feature_db;
+ocr::Recognition_Server* g_server = nullptr;
 
 //----------------------------------------------------------------------------
 // Prototypes
@@ -114,8 +134,9 @@ void generate_gaussian_filter( void );
 
 // Phase II
 void generate_feature_database( void );
-void load_feature_database_from_file( const char* );
+void load_feature_database_into( const std::string&, ocr::Feature_Database& );
 void load_feature_database( void );
+void convert_feature_database( void );
 void scan_for_features( void );
 
 // Phase III
@@ -126,6 +147,13 @@ void convert_color_to_grayscale( void );
 void convert_grayscale_to_binary_static( void );
 void convert_grayscale_to_binary_adaptive( void );
 
+// Batch Mode
+void print_usage( const char* );
+bool collect_batch_inputs( const std::string&, std::vector<std::string>& );
+std::string batch_output_name( const std::string& );
+void stop_server( int );
+int  run_batch( int, char** );
+
 //----------------------------------------------------------------------------
 // Definitions
 //----------------------------------------------------------------------------
@@ -176,6 +204,7 @@ void display_menu( int menu ){
               << "2 - Load feature database\n"
               << "3 - Scan image for features\n"
               << "4 - Analyze features\n"
+              << "5 - Convert feature database to binary (*.fdbx)\n"
               << "0 - Return to main menu\n"
               << "---------------------------------------------------\n";
     break;
@@ -207,7 +236,7 @@ namespace ocr {
 
     std::string infile  = ocr::get_string_input("Enter input file: ", "Error, invalid input");
 
-    ocr::Image* image;
+    ocr::Binary_Image* image;
     int status = ocr::load_bmp_image_binary( infile.c_str(), &image );
 
     if( status != ocr::IS_SUCCESS ){
@@ -220,7 +249,20 @@ namespace ocr {
 
     //-------------------=-----------------------------------------------------
 
-    Image active_buffer = Image(*image);
+    // Thin a byte per pixel with a one pixel border of background around
+    // it, so that every neighbour can be read without checking the edges
+    const std::size_t width  = image->width();
+    const std::size_t height = image->height();
+
+    Gray_Image active_buffer( width, height, ocr::aligned_layout(1) );
+    for( std::size_t y = 0; y < height; ++y ){
+      ubyte* row = active_buffer.row(y);
+
+      for( std::size_t x = 0; x < width; ++x ){
+        row[x] = image->at(x,y);
+      }
+    }
+    active_buffer.fill_border( ocr::border_constant, 0 );
 
     ocr::destroy_image( &image );
 
@@ -234,19 +276,32 @@ namespace ocr {
     bool prime_pass = false;
     do{
       deletion_made = false;
-      for( std::size_t x = 0; x < active_buffer.width(); ++x ){
-        for( std::size_t y = 0; y < active_buffer.height(); ++y ){
+
+      // The pixels to delete are only marked during a pass, so the order
+      // that they are visited in does not change the result; each row is
+      // read along with the rows either side of it, while they are cached
+      const ocr::Gray_Image::const_view_type view = active_buffer.view();
+      ocr::for_each_row_window<1>( view, [&]( std::size_t y, const ubyte* const* rows ){
+        const ubyte* above = rows[0];
+        const ubyte* row   = rows[1];
+        const ubyte* below = rows[2];
+
+        for( std::size_t x = 0; x < width; ++x ){
+
+          const ubyte* up = above + x;
+          const ubyte* p1 = row + x;
+          const ubyte* dn = below + x;
 
           // Only interested if the pixel is already set
-          if( active_buffer.at_binary(x,y) ){
-            ubyte p2 = active_buffer.at_binary( x  , y-1 );
-            ubyte p3 = active_buffer.at_binary( x+1, y-1 );
-            ubyte p4 = active_buffer.at_binary( x+1, y   );
-            ubyte p5 = active_buffer.at_binary( x+1, y+1 );
-            ubyte p6 = active_buffer.at_binary( x  , y+1 );
-            ubyte p7 = active_buffer.at_binary( x-1, y+1 );
-            ubyte p8 = active_buffer.at_binary( x-1, y   );
-            ubyte p9 = active_buffer.at_binary( x-1, y-1 );
+          if( *p1 ){
+            ubyte p2 = up[ 0];
+            ubyte p3 = up[ 1];
+            ubyte p4 = p1[ 1];
+            ubyte p5 = dn[ 1];
+            ubyte p6 = dn[ 0];
+            ubyte p7 = dn[-1];
+            ubyte p8 = p1[-1];
+            ubyte p9 = up[-1];
 
             ubyte a = (int) (p2 < p3) + (int) (p3 < p4) + (int) (p4 < p5) +
                       (int) (p5 < p6) + (int) (p6 < p7) + (int) (p7 < p8) +
@@ -276,12 +331,12 @@ namespace ocr {
             }
           }
         } // end for
-      } // end for
+      } ); // end for
 
       // Update the image
       marked_collection::iterator iter = marked.begin();
       for( ;iter!=marked.end(); ++iter ){
-        active_buffer.set_binary(iter->first, iter->second,0);
+        active_buffer.set(iter->first, iter->second,0);
       }
       marked.clear();
 
@@ -289,7 +344,16 @@ namespace ocr {
       prime_pass = !prime_pass;
     }while(deletion_made);
 
-    if( !ocr::save_bmp_image( outfile.c_str(), &active_buffer ) ){
+    Binary_Image thinned( width, height );
+    for( std::size_t y = 0; y < height; ++y ){
+      const ubyte* row = active_buffer.row(y);
+
+      for( std::size_t x = 0; x < width; ++x ){
+        thinned.set( x, y, row[x] );
+      }
+    }
+
+    if( !ocr::save_bmp_image( outfile.c_str(), thinned ) ){
       std::cout << "Error saving output file\n";
       ocr::get_any_input("Press enter to continue...\n");
       return;
@@ -559,8 +623,14 @@ void apply_filters(){
   std::string infile  = ocr::get_string_input("Enter input file: ", "Error, invalid input");
   std::string outfile = ocr::get_string_input("Enter output file: ", "Error, invalid input");
 
-  ocr::Image* image;
-  int status = ocr::load_bmp_image_color( infile.c_str(), &image );
+  ocr::Kernel_Image_Operator* op = g_kernels[index].second;
+
+  // Only the one image is being filtered, so spread each band over every core
+  op->set_threads( 0 );
+
+  // Each band carries enough rows around it for the filter's kernel
+  ocr::BMP_Band_Reader reader;
+  int status = reader.open( infile.c_str(), ocr::PC_COLOR, BAND_ROWS, op->halo() );
 
   if( status != ocr::IS_SUCCESS ){
     std::cout << "Error loading input file\n";
@@ -568,18 +638,21 @@ void apply_filters(){
     return;
   }
 
-  ocr::Kernel_Image_Operator* op = g_kernels[index].second;
+  ocr::BMP_Band_Writer writer;
+  bool written = writer.open( outfile.c_str(), reader.width(), reader.height() );
 
-  ocr::Image out = op->operate(*image);
+  while( written && reader.next() ){
+    ocr::Image out = op->operate_band( reader.band(), reader.core_offset(), reader.core_rows() );
 
-  if( !ocr::save_bmp_image( outfile.c_str(), &out ) ){
-    ocr::destroy_image( &image );
+    written = writer.write( out, reader.core_first() );
+  }
+
+  if( !writer.close() || !written ){
     std::cout << "Error saving output file\n";
     ocr::get_any_input("Press enter to continue...\n");
     return;
   }
 
-  ocr::destroy_image( &image );
   std::cout << "File successfully output to '" << outfile << "'.\n";
   ocr::get_any_input("Press enter to continue...\n");
 }
@@ -816,10 +889,33 @@ void generate_feature_database(){
   ocr::get_any_input("Press enter to continue...\n");
 }
 
-void load_feature_database_from_file( const char* filename ){
-  std::ifstream file(filename);
+//
+// Feature database files are read and parsed on a pool of worker threads,
+// each into its own entry, and then merged into the database in the order
+// they were listed, so that the result does not depend on thread timing.
+//
+struct feature_database_file{
+  std::string             path;     ///< Path to the file
+  std::string             name;     ///< Name announced when merging, if any
+  ocr::Image*             glyph;    ///< The parsed glyph; null if not parsed
+  ocr::feature_collection features; ///< The parsed feature vectors
+  std::string             log;      ///< Messages printed when merging
+};
+
+void read_feature_database_file( feature_database_file& entry ){
+  entry.glyph = nullptr;
+
+  // Binary databases are mapped in place when merged; nothing to parse
+  if(string_ends_with(entry.path,".fdbx")){
+    return;
+  }
+
+  std::ostringstream log;
+
+  std::ifstream file(entry.path);
   if(!file.good()){
-    std::cout << " o Unable to open file " << filename << "\n";
+    log << " o Unable to open file " << entry.path << "\n";
+    entry.log = log.str();
     return;
   }
 
@@ -835,21 +931,23 @@ void load_feature_database_from_file( const char* filename ){
 
   // Extract Image
 
-  ocr::Image image(width,height);
+  ocr::Image* image = new ocr::Image(width,height);
 
-  char* line = new char[width+1];
+  std::vector<char> line(width+1);
 
   for( std::size_t y = 0; y < height; ++y ){
-    file.getline( line, width + 1 );
+    file.getline( &line[0], width + 1 );
     if( (std::size_t) file.gcount() != width + 1 ){
-      std::cout << " o Invalid Glyph (inconsistent width). Unable to read database.\n";
+      log << " o Invalid Glyph (inconsistent width). Unable to read database.\n";
+      entry.log = log.str();
+      ocr::destroy_image( &image );
       return;
     }
 
     // Generate the image row
 
     for( std::size_t x = 0; x < width; ++x ){
-      image.set_binary( x, y, line[x] == '1' );
+      image->set_binary( x, y, line[x] == '1' );
     }
   }
 
@@ -859,9 +957,7 @@ void load_feature_database_from_file( const char* filename ){
 
   file.get(); // ignore the \n in the file
 
-  ocr::feature_collection features;
-
-  std::cout << " o " << no_of_vectors << " features loaded\n";
+  log << " o " << no_of_vectors << " features loaded\n";
   for( std::size_t i = 0; i < no_of_vectors; ++i ){
     ocr::Feature_Vector::feature_collection feat_values;
     for( std::size_t j = 0; j < vector_length; ++j ){
@@ -870,55 +966,136 @@ void load_feature_database_from_file( const char* filename ){
       feat_values.push_back(value);
     }
     ocr::Feature_Vector feature(feat_values);
-    //std::cout << "  - " << (i+1) << ": " << feature << std::endl;
-    features.push_back(feature);
+    entry.features.push_back(feature);
   }
 
-  // Add them to the global features database
-  g_feature_db.insert( image, features );
-
   //--------------------------------------------------------------------------
 
   file.close();
-}
 
-void load_feature_database(){
+  entry.glyph = image;
+  entry.log   = log.str();
+}
 
-  std::cout << "Please enter either the feature database file (*.fdb), or a directory containing them to load.\n";
+void load_feature_database_files( std::vector<feature_database_file>& files, ocr::Feature_Database& db ){
 
-  std::string inpath = ocr::get_string_input("Enter input path: ", "Error, invalid input");
+  // Parse every file at once, one per worker
+  if( files.size() > 1 ){
+    ocr::Thread_Pool pool( std::min( files.size(), ocr::Thread_Pool::default_size() ) );
 
-  // Open feature database file (*.fdb) if specified, or directory otherwise
-  if(string_ends_with(inpath,".fdb")){
-    load_feature_database_from_file( inpath.c_str() );
+    for( feature_database_file& entry : files ){
+      pool.submit( [&entry]{ read_feature_database_file( entry ); } );
+    }
+    pool.wait();
   }else{
-    DIR *dir;
-    struct dirent *entry;
-    if((dir = opendir( inpath.c_str() )) == NULL) {
-      std::cout << "Error opening directory '" << inpath << "'\n";
-      ocr::get_any_input("Press enter to continue...\n");
-      return;
+    for( feature_database_file& entry : files ){
+      read_feature_database_file( entry );
     }
+  }
 
-    while ((entry = readdir(dir)) != NULL) {
-      // Only open files, not previous directory or current one
-      if( !(strcmp( entry->d_name, "." ) == 0 || strcmp( entry->d_name, ".." ) == 0) &&
-          string_ends_with( entry->d_name, ".fdb" ) ){
+  //--------------------------------------------------------------------------
 
-        std::string filepath = inpath;
-        if(string_ends_with( inpath, "/" ) || string_ends_with( inpath, "\\")){
-          filepath += entry->d_name;
-        }else{
-          filepath += "/";
-          filepath += entry->d_name;
-        }
+  // Merge the results into the database in order
+  for( feature_database_file& entry : files ){
+    if(!entry.name.empty()){
+      std::cout << "Loading " << entry.name << ".\n";
+    }
+    std::cout << entry.log;
 
-        std::cout << "Loading " << entry->d_name << ".\n";
-        load_feature_database_from_file( filepath.c_str() );
+    if(string_ends_with(entry.path,".fdbx")){
+      if(db.load( entry.path.c_str() )){
+        std::cout << " o Mapped binary database " << entry.path << "\n";
+      }else{
+        std::cout << " o Invalid binary database " << entry.path << "\n";
       }
+    }else if(entry.glyph){
+      db.insert( *entry.glyph, entry.features );
+      ocr::destroy_image( &entry.glyph );
     }
+  }
+}
 
-    closedir(dir);
+void load_feature_database_into( const std::string& inpath, ocr::Feature_Database& db ){
+
+  std::vector<feature_database_file> files;
+
+  // Open feature database file (*.fdb, *.fdbx) if specified, or directory otherwise
+  if(string_ends_with(inpath,".fdb") || string_ends_with(inpath,".fdbx")){
+    feature_database_file entry;
+    entry.path = inpath;
+    files.push_back( entry );
+
+    load_feature_database_files( files, db );
+    return;
+  }
+
+  DIR *dir;
+  struct dirent *entry;
+  if((dir = opendir( inpath.c_str() )) == NULL) {
+    std::cout << "Error opening directory '" << inpath << "'\n";
+    return;
+  }
+
+  while ((entry = readdir(dir)) != NULL) {
+    // Only open files, not previous directory or current one
+    if( !(strcmp( entry->d_name, "." ) == 0 || strcmp( entry->d_name, ".." ) == 0) &&
+        (string_ends_with( entry->d_name, ".fdb" ) || string_ends_with( entry->d_name, ".fdbx" )) ){
+
+      feature_database_file file;
+      file.path = inpath;
+      if(string_ends_with( inpath, "/" ) || string_ends_with( inpath, "\\")){
+        file.path += entry->d_name;
+      }else{
+        file.path += "/";
+        file.path += entry->d_name;
+      }
+      file.name = entry->d_name;
+
+      files.push_back( file );
+    }
+  }
+
+  closedir(dir);
+
+  load_feature_database_files( files, db );
+}
+
+void load_feature_database(){
+
+  std::cout << "Please enter either the feature database file (*.fdb, *.fdbx), or a directory containing them to load.\n";
+
+  std::string inpath = ocr::get_string_input("Enter input path: ", "Error, invalid input");
+
+  load_feature_database_into( inpath, g_feature_db );
+
+  ocr::get_any_input("Press enter to continue...\n");
+}
+
+void convert_feature_database(){
+
+  std::cout << "Please enter either the feature database file (*.fdb), or a directory containing them,\n"
+               "followed by the binary database file (*.fdbx) to write them all to.\n";
+
+  std::string inpath  = ocr::get_string_input("Enter input path: ", "Error, invalid input");
+
+  ocr::Feature_Database db;
+  load_feature_database_into( inpath, db );
+
+  if(!db.size()){
+    std::cout << "No feature databases found! Unable to convert.\n";
+    ocr::get_any_input("Press enter to continue...\n");
+    return;
+  }
+
+  std::string outfile = ocr::get_string_input("Enter output file (*.fdbx): ", "Error, invalid input");
+  if(!string_ends_with(outfile,".fdbx")){
+    outfile += ".fdbx";
+  }
+
+  if(!db.save( outfile.c_str() )){
+    std::cout << "Error: Unable to write " << outfile << "\n";
+  }else{
+    std::cout << "Wrote " << db.size() << " glyph classes to '" << outfile << "'.\n";
   }
 
   ocr::get_any_input("Press enter to continue...\n");
@@ -928,9 +1105,9 @@ void scan_for_features(){
   std::cout << "Please enter the path to the binary image.\n";
   std::string infile  = ocr::get_string_input("Enter input file: ", "Error, invalid input");
 
-  ocr::Image* image;
-
-  int status = ocr::load_bmp_image_binary( infile.c_str(), &image );
+  // The halo lets every glyph that starts in a band be labeled whole
+  ocr::BMP_Band_Reader reader;
+  int status = reader.open( infile.c_str(), ocr::PC_BINARY, BAND_ROWS, BAND_ROWS );
 
   if( status != ocr::IS_SUCCESS ){
     std::cout << "Error loading input file\n";
@@ -939,21 +1116,23 @@ void scan_for_features(){
   }
 
   // Error checking: Only allow 1 globally stored scanned image.
-  if(g_scanned_image_boundaries.size() || g_scanned_image_features.size() || g_scanned_image){
+  if(g_scanned_image_boundaries.size() || g_scanned_image_features.size() || g_scanned_image_width){
     std::cout << "Clearing previously scanned image data." << std::endl;
     g_scanned_image_boundaries.clear();
     g_scanned_image_features.clear();
-
-    if(g_scanned_image){
-      ocr::destroy_image(&g_scanned_image);
-    }
   }
 
-  g_scanned_image = image;
+  g_scanned_image_width  = reader.width();
+  g_scanned_image_height = reader.height();
 
   ocr::feature_collection&  vec    = g_scanned_image_features;
   ocr::boundary_collection& bounds = g_scanned_image_boundaries;
-  ocr::load_features( *g_scanned_image, vec, bounds, X_DIVS, Y_DIVS );
+
+  while( reader.next() ){
+    ocr::load_band_features( reader.band(), reader.band_first(),
+                             reader.core_offset(), reader.core_rows(),
+                             vec, bounds, X_DIVS, Y_DIVS );
+  }
 
   // Print newly discovered glyph
   int current = 1;
@@ -975,7 +1154,7 @@ void scan_for_features(){
 //-----------------------------------------------------------------------------
 
 void analyze_features(){
-  if(!(g_scanned_image_boundaries.size() && g_scanned_image_features.size() && g_scanned_image)){
+  if(!(g_scanned_image_boundaries.size() && g_scanned_image_features.size() && g_scanned_image_width)){
     std::cout << "Error: No image scanned. Please scan image first.\n";
     ocr::get_any_input("Press enter to continue...\n");
     return;
@@ -992,12 +1171,11 @@ void analyze_features(){
     path += ".bmp";
   }
 
-  ocr::Image result( g_scanned_image->width(), g_scanned_image->height() );
-  result.fill_binary(0);
+  ocr::Binary_Image result( g_scanned_image_width, g_scanned_image_height );
 
   g_feature_db.analyze( result, g_scanned_image_boundaries, g_scanned_image_features );
 
-  ocr::save_bmp_image( path.c_str(), &result );
+  ocr::save_bmp_image( path.c_str(), result );
 
   ocr::get_any_input("Press enter to continue...\n");
 }
@@ -1022,7 +1200,7 @@ void convert_color_to_grayscale(){
 
   std::string outfile = ocr::get_string_input("Enter output file: ", "Error, invalid input");
 
-  if( !ocr::save_bmp_image( outfile.c_str(), image ) ){
+  if( !ocr::save_bmp_image( outfile.c_str(), image, ocr::PC_GRAYSCALE ) ){
     std::cout << "Error saving output file\n";
   }else{
     std::cout << "File successfully output to '" << outfile << "'.\n";
@@ -1038,8 +1216,8 @@ void convert_grayscale_to_binary_static(){
                "for producing a binary image.\n";
   std::string infile  = ocr::get_string_input("Enter input file: ", "Error, invalid input");
 
-  ocr::Image* image;
-  int status = ocr::load_bmp_image_grayscale( infile.c_str(), &image );
+  ocr::BMP_Band_Reader reader;
+  int status = reader.open( infile.c_str(), ocr::PC_GRAYSCALE, BAND_ROWS );
 
   if( status != ocr::IS_SUCCESS ){
     std::cout << "Error loading input file\n";
@@ -1055,27 +1233,30 @@ void convert_grayscale_to_binary_static(){
     threshold = ocr::get_int_input("Threshold (0-255): ","Error, invalid input");
   }
 
-  for( std::size_t i = 0; i < image->width(); ++i ){
-    for( std::size_t j = 0; j < image->height(); ++j ){
-      ocr::Image::pixel_type out_pixel;
-      ocr::Image::pixel_type pixel = image->at(i,j);
+  ocr::BMP_Band_Writer writer;
+  bool written = writer.open( outfile.c_str(), reader.width(), reader.height(), ocr::PC_BINARY );
+
+  // Each pixel only depends on itself, so the bands need no halo
+  while( written && reader.next() ){
+    ocr::Image& band = reader.band();
+
+    ocr::for_each_pixel( band.view(), [threshold]( ocr::Image::pixel_type& pixel ){
       ocr::ubyte out = ((((pixel.r + pixel.g + pixel.b) / 3) > threshold) ? 255 : 0);
 
-      out_pixel.r = out;
-      out_pixel.g = out;
-      out_pixel.b = out;
+      pixel.r = out;
+      pixel.g = out;
+      pixel.b = out;
+    } );
 
-      image->set(i,j,out_pixel);
-    }
+    written = writer.write( band, reader.core_first() );
   }
 
-  if( !ocr::save_bmp_image( outfile.c_str(), image ) ){
+  if( !writer.close() || !written ){
     std::cout << "Error saving output file\n";
   }else{
     std::cout << "File successfully output to '" << outfile << "'.\n";
   }
 
-  ocr::destroy_image( &image );
   ocr::get_any_input("Press enter to continue...\n");
 }
 
@@ -1086,7 +1267,7 @@ void convert_grayscale_to_binary_adaptive(){
                "Note: larger thresholds take longer to compute.\n";
   std::string infile  = ocr::get_string_input("Enter input file: ", "Error, invalid input");
 
-  ocr::Image* image;
+  ocr::Gray_Image* image;
   int status = ocr::load_bmp_image_grayscale( infile.c_str(), &image );
 
   if( status != ocr::IS_SUCCESS ){
@@ -1103,65 +1284,432 @@ void convert_grayscale_to_binary_adaptive(){
     neighborhood = ocr::get_int_input("Neighborhood (5-100): ","Error, invalid input");
   }
 
-  ocr::u32 x_neighborhood = neighborhood;
-  ocr::u32 y_neighborhood = neighborhood;
+  const std::size_t width  = image->width();
+  const std::size_t height = image->height();
+  const std::size_t size   = neighborhood;
+
+  ocr::Binary_Image out_image( width, height );
+
+  // Each pixel is compared against the average of the neighborhood that
+  // starts at it, clipped to the image. The neighborhoods are summed row
+  // by row: the column sums slide down a row at a time, and the sum across
+  // them slides along each row a column at a time
+  std::vector<ocr::u32> columns( width, 0 );
+  for( std::size_t y = 0; y < size && y < height; ++y ){
+    const ocr::ubyte* row = image->row( y );
+
+    for( std::size_t x = 0; x < width; ++x ){
+      columns[x] += row[x];
+    }
+  }
+
+  ocr::for_each_row( image->view(), [&]( std::size_t y, const ocr::ubyte* row ){
+    const ocr::u32 y_neighborhood = (ocr::u32) ((y + size >= height) ? height - y : size);
+
+    ocr::u32 sum = 0;
+    for( std::size_t x = 0; x < size && x < width; ++x ){
+      sum += columns[x];
+    }
+
+    for( std::size_t x = 0; x < width; ++x ){
+      const ocr::u32 x_neighborhood = (ocr::u32) ((x + size >= width) ? width - x : size);
+      const ocr::u32 avg            = sum / (x_neighborhood * y_neighborhood);
+
+      out_image.set( x, y, ( row[x] < avg ) ? 1 : 0 );
+
+      sum -= columns[x];
+      if( x + size < width ){
+        sum += columns[x + size];
+      }
+    }
+
+    // Slide the column sums down to the neighborhoods of the next row
+    const ocr::ubyte* entering = (y + size < height) ? image->row( y + size ) : 0;
+    for( std::size_t x = 0; x < width; ++x ){
+      columns[x] -= row[x];
+      if( entering ){
+        columns[x] += entering[x];
+      }
+    }
+  } );
+
+  if( !ocr::save_bmp_image( outfile.c_str(), out_image ) ){
+    std::cout << "Error saving output file\n";
+  }else{
+    std::cout << "File successfully output to '" << outfile << "'.\n";
+  }
+
+  ocr::destroy_image( &image );
+  ocr::get_any_input("Press enter to continue...\n");
+
+}
+
+//-----------------------------------------------------------------------------
+// Batch Mode
+//-----------------------------------------------------------------------------
 
-  ocr::Image out_image( image->width(), image->height() );
+void print_usage( const char* program ){
+  std::cout <<
+    "Usage: " << program << " -d <database> [options] <input>...\n"
+    "\n"
+    "Recognizes every input page against the database without any menus.\n"
+    "Inputs may be bitmaps, directories of bitmaps, or patterns such as\n"
+    "'pages/*.bmp'.\n"
+    "\n"
+    "Options:\n"
+    "  -d, --database <path>   *.fdb, *.fdbx or a directory of them (repeatable)\n"
+    "  -f, --filter <path>     *.kernel or a directory of them, applied to every\n"
+    "                          page in the order loaded (repeatable)\n"
+    "  -t, --threshold <0-255> gray level at and below which a pixel is ink\n"
+    "  -l, --list <file>       read further inputs from a file, one per line\n"
+    "                          ('-' reads standard input)\n"
+    "  -o, --output <dir>      write each recognized page to <dir>/<name>.bmp;\n"
+    "                          inputs that share a <name> are refused\n"
+    "  -s, --serve <socket>    instead of recognizing inputs, keep the database\n"
+    "                          and filters loaded and answer requests on a Unix\n"
+    "                          socket until interrupted\n"
+    "  -r, --root <dir>        with --serve, the directory FILE requests may\n"
+    "                          read from; without it, only DATA is answered\n"
+    "  -j, --jobs <n>          requests answered at once (default: one per core)\n"
+    "  -h, --help              print this message\n"
+    "\n"
+    "One line is printed per page, in order: the input, the number of glyphs\n"
+    "found, the time from decoding to output and the output written,\n"
+    "separated by tabs. Pages are decoded, filtered, labeled, classified and\n"
+    "written by concurrent stages.\n"
+    "\n"
+    "A server answers one request per line on each connection:\n"
+    "  FILE <path>     recognize a bitmap at <path> under the --root directory\n"
+    "  DATA <length>   recognize the <length> bitmap bytes that follow\n"
+    "  QUIT            close the connection\n"
+    "with 'OK <glyphs> <milliseconds> <length>' followed by the recognized page\n"
+    "as a <length> byte bitmap, or 'ERROR <message>'. The socket is only open\n"
+    "to the user running the server.\n";
+}
 
-  // Perform the calculation
-  for( std::size_t x_seg = 0; x_seg < image->width(); ++x_seg ){
+//-----------------------------------------------------------------------------
 
-    if(x_seg + neighborhood >= image->width()){
-      x_neighborhood = image->width() - x_seg;
+bool wildcard_match( const char* pattern, const char* str ){
+  const char* star  = nullptr; // last '*' seen in the pattern
+  const char* retry = nullptr; // where in str that '*' resumes matching
+
+  while( *str ){
+    if( *pattern == '?' || *pattern == *str ){
+      ++pattern;
+      ++str;
+    }else if( *pattern == '*' ){
+      star  = pattern++;
+      retry = str;
+    }else if( star ){
+      pattern = star + 1;
+      str     = ++retry;
     }else{
-      x_neighborhood = neighborhood;
+      return false;
+    }
+  }
+  while( *pattern == '*' ){
+    ++pattern;
+  }
+  return (*pattern == '\0');
+}
+
+//-----------------------------------------------------------------------------
+
+bool collect_batch_inputs( const std::string& path, std::vector<std::string>& inputs ){
+
+  std::size_t slash = path.find_last_of("/\\");
+  std::string directory;
+  std::string pattern;
+
+  if( path.find_first_of("*?") != std::string::npos ){
+    // Patterns only apply to the last component of the path
+    directory = (slash == std::string::npos) ? std::string(".") : path.substr( 0, slash );
+    pattern   = (slash == std::string::npos) ? path : path.substr( slash + 1 );
+  }else{
+    DIR* dir = opendir( path.c_str() );
+    if( dir == NULL ){
+      inputs.push_back( path );
+      return true;
     }
+    closedir(dir);
 
-    for( std::size_t y_seg = 0; y_seg < image->height(); ++y_seg ){
+    directory = path;
+    pattern   = "*.bmp";
+  }
 
-      if(y_seg + neighborhood >= image->height()){
-        y_neighborhood = image->height() - y_seg;
+  DIR *dir;
+  struct dirent *entry;
+  if((dir = opendir( directory.c_str() )) == NULL) {
+    return false;
+  }
+
+  // Directory order is arbitrary, so sort for a repeatable job
+  std::vector<std::string> found;
+  while ((entry = readdir(dir)) != NULL) {
+    if( !(strcmp( entry->d_name, "." ) == 0 || strcmp( entry->d_name, ".." ) == 0) &&
+        wildcard_match( pattern.c_str(), entry->d_name ) ){
+      if( string_ends_with( directory, "/" ) || string_ends_with( directory, "\\" ) ){
+        found.push_back( directory + entry->d_name );
       }else{
-        y_neighborhood = neighborhood;
+        found.push_back( directory + "/" + entry->d_name );
       }
+    }
+  }
+  closedir(dir);
 
-      // Calculate the segment average
-      ocr::u32 avg = 0;
-      for( std::size_t i = 0; i < x_neighborhood; ++i ){
-        for( std::size_t j = 0; j < y_neighborhood; ++j ){
-          ocr::Image::pixel_type pixel = image->at( x_seg + i, y_seg + j );
+  std::sort( found.begin(), found.end() );
+  inputs.insert( inputs.end(), found.begin(), found.end() );
+  return !found.empty();
+}
 
-          avg += pixel.r;
-        }
-      }
-      avg /= (x_neighborhood*y_neighborhood);
+//-----------------------------------------------------------------------------
 
-      // Calculate the thresholded image
-      for( std::size_t i = 0; i < x_neighborhood; ++i ){
-        for( std::size_t j = 0; j < y_neighborhood; ++j ){
-          ocr::Image::pixel_type pixel = image->at( x_seg + i, y_seg + j );
-          ocr::ubyte out = (( pixel.r >= avg ) ? 255 : 0);
+std::string batch_output_name( const std::string& input ){
+  std::size_t slash = input.find_last_of("/\\");
+  std::string name  = (slash == std::string::npos) ? input : input.substr( slash + 1 );
+  if( string_ends_with( name, ".bmp" ) ){
+    name.erase( name.size() - 4 );
+  }
+  return name + ".bmp";
+}
 
-          ocr::Image::pixel_type out_pixel;
-          out_pixel.r = out;
-          out_pixel.g = out;
-          out_pixel.b = out;
+//-----------------------------------------------------------------------------
+
+void stop_server( int ){
+  if( g_server ){
+    g_server->stop();
+  }
+}
 
-          out_image.set( x_seg + i, y_seg + j, out_pixel );
+//-----------------------------------------------------------------------------
+
+int run_batch( int argc, char** argv ){
+
+  std::vector<std::string> databases;
+  std::vector<std::string> filters;
+  std::vector<std::string> paths;
+  std::string output;
+  std::string socket;
+  std::string root;
+  int threshold = -1;
+  int jobs      = 0;
+
+  for( int i = 1; i < argc; ++i ){
+    std::string arg = argv[i];
+    bool has_value  = (i + 1 < argc);
+
+    if( arg == "-h" || arg == "--help" ){
+      print_usage( argv[0] );
+      return 0;
+    }else if( (arg == "-d" || arg == "--database") && has_value ){
+      databases.push_back( argv[++i] );
+    }else if( (arg == "-f" || arg == "--filter") && has_value ){
+      filters.push_back( argv[++i] );
+    }else if( (arg == "-o" || arg == "--output") && has_value ){
+      output = argv[++i];
+    }else if( (arg == "-s" || arg == "--serve") && has_value ){
+      socket = argv[++i];
+    }else if( (arg == "-r" || arg == "--root") && has_value ){
+      root = argv[++i];
+    }else if( (arg == "-j" || arg == "--jobs") && has_value ){
+      std::stringstream ss( argv[++i] );
+      if( !(ss >> jobs) || !ss.eof() || jobs < 1 ){
+        std::cerr << "Error: jobs must be at least 1.\n";
+        return 2;
+      }
+    }else if( (arg == "-t" || arg == "--threshold") && has_value ){
+      std::stringstream ss( argv[++i] );
+      if( !(ss >> threshold) || !ss.eof() || threshold < 0 || threshold > 255 ){
+        std::cerr << "Error: threshold must be between 0 and 255.\n";
+        return 2;
+      }
+    }else if( (arg == "-l" || arg == "--list") && has_value ){
+      std::string list = argv[++i];
+      std::ifstream file;
+      if( list != "-" ){
+        file.open( list );
+        if( !file.good() ){
+          std::cerr << "Error: unable to open list '" << list << "'.\n";
+          return 2;
         }
       }
+      std::istream& in = (list == "-") ? std::cin : file;
+      std::string line;
+      while( std::getline( in, line ) ){
+        if( !line.empty() && line[line.size()-1] == '\r' ){
+          line.erase( line.size() - 1 );
+        }
+        if( !line.empty() ){
+          paths.push_back( line );
+        }
+      }
+    }else if( arg.size() > 1 && arg[0] == '-' ){
+      std::cerr << "Error: unknown or incomplete option '" << arg << "'.\n";
+      print_usage( argv[0] );
+      return 2;
+    }else{
+      paths.push_back( arg );
     }
   }
 
-  if( !ocr::save_bmp_image( outfile.c_str(), &out_image ) ){
-    std::cout << "Error saving output file\n";
-  }else{
-    std::cout << "File successfully output to '" << outfile << "'.\n";
+  if( databases.empty() ){
+    std::cerr << "Error: no feature database given.\n";
+    print_usage( argv[0] );
+    return 2;
+  }
+  if( !socket.empty() && !paths.empty() ){
+    std::cerr << "Error: inputs cannot be given to a server.\n";
+    return 2;
+  }
+  if( socket.empty() && !root.empty() ){
+    std::cerr << "Error: a root only applies to a server.\n";
+    return 2;
   }
 
-  ocr::destroy_image( &image );
-  ocr::get_any_input("Press enter to continue...\n");
+  //---------------------------------------------------------------------------
+  // Load the database and filters once for the whole job
+  //---------------------------------------------------------------------------
+
+  // The loaders report their progress on std::cout; keep that off of the
+  // results so that they can be piped on.
+  std::streambuf* results = std::cout.rdbuf( std::cerr.rdbuf() );
+
+  for( const std::string& path : databases ){
+    load_feature_database_into( path, g_feature_db );
+  }
+  for( const std::string& path : filters ){
+    if(string_ends_with(path,".kernel")){
+      std::cout << " * Opening " << path << ":\n";
+      ocr::load_kernel_from_file( path, g_kernels );
+    }else{
+      ocr::load_kernels_from_dir( path, g_kernels );
+    }
+  }
+
+  std::cout.rdbuf( results );
+
+  if( !g_feature_db.size() ){
+    std::cerr << "Error: no features in database.\n";
+    return 2;
+  }
+
+  ocr::Recognizer recognizer( g_feature_db, X_DIVS, Y_DIVS );
+  recognizer.set_threshold( threshold );
+  for( kernel_collection::iterator iter = g_kernels.begin(); iter != g_kernels.end(); ++iter ){
+    recognizer.add_filter( *iter->second );
+  }
+
+  //---------------------------------------------------------------------------
+  // Serve requests, if asked to
+  //---------------------------------------------------------------------------
+
+  if( !socket.empty() ){
+    ocr::Recognition_Server server( recognizer, (std::size_t) jobs );
+
+    if( !root.empty() && !server.set_root( root.c_str() ) ){
+      std::cerr << "Error: '" << root << "' is not a directory.\n";
+      return 2;
+    }
+    if( !server.listen( socket.c_str() ) ){
+      std::cerr << "Error: unable to listen on '" << socket << "'.\n";
+      return 2;
+    }
+
+    g_server = &server;
+    std::signal( SIGINT,  &stop_server );
+    std::signal( SIGTERM, &stop_server );
+
+    std::cerr << "Listening on '" << socket << "' with "
+              << g_feature_db.size() << " glyph classes.\n";
+    server.serve();
+
+    g_server = nullptr;
+    return 0;
+  }
+
+  std::vector<std::string> inputs;
+  for( const std::string& path : paths ){
+    if( !collect_batch_inputs( path, inputs ) ){
+      std::cerr << "Warning: nothing matches '" << path << "'.\n";
+    }
+  }
 
+  // Outputs are named after their inputs alone, so two inputs of the same
+  // name in different directories would overwrite each other's output
+  if( !output.empty() ){
+    std::map<std::string,std::string> named;
+
+    for( const std::string& input : inputs ){
+      std::pair<std::map<std::string,std::string>::iterator,bool> entry =
+        named.insert( std::make_pair( batch_output_name( input ), input ) );
+
+      if( !entry.second && entry.first->second != input ){
+        std::cerr << "Error: '" << entry.first->second << "' and '" << input
+                  << "' would both be written to '" << output << "/"
+                  << entry.first->first << "'.\n";
+        return 2;
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Recognize every page
+  //---------------------------------------------------------------------------
+
+  // Pages stream through decode, prepare, extract and classify stages that
+  // run at once; the output stage below runs here, on this thread
+  typedef ocr::Recognition_Pipeline pipeline_type;
+
+  int failures = 0;
+
+  pipeline_type pipeline( recognizer );
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  pipeline.run( inputs, [&]( pipeline_type::page& page ){
+    const std::string& input = page.input;
+
+    if( page.status != ocr::IS_SUCCESS ){
+      std::cerr << "Error: unable to load '" << input << "'.\n";
+      ++failures;
+      return;
+    }
+
+    std::string written = "-";
+    if( !output.empty() ){
+      written = output + "/" + batch_output_name( input );
+
+      if( !ocr::save_bmp_image( written.c_str(), *page.result ) ){
+        std::cerr << "Error: unable to write '" << written << "'.\n";
+        written = "-";
+        ++failures;
+      }
+    }
+
+    std::cout << input << '\t' << page.bounds.size() << '\t'
+              << std::fixed << std::setprecision(2) << page.milliseconds << " ms\t"
+              << written << '\n';
+  } );
+
+  std::chrono::duration<double,std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+  // The busiest stage is the one holding the job back
+  std::cerr << std::fixed << std::setprecision(2)
+            << inputs.size() << " pages in " << elapsed.count() << " ms"
+            << " (busy: decode "  << pipeline.busy( pipeline_type::stage_decode )   << " ms"
+            << ", prepare "       << pipeline.busy( pipeline_type::stage_prepare )  << " ms"
+            << ", extract "       << pipeline.busy( pipeline_type::stage_extract )  << " ms"
+            << ", classify "      << pipeline.busy( pipeline_type::stage_classify ) << " ms"
+            << ", output "        << pipeline.busy( pipeline_type::stage_output )   << " ms)\n";
+
+  // Every buffer after the first page's should have been reused
+  const ocr::Buffer_Pool& pool = ocr::Buffer_Pool::global();
+  std::cerr << "Buffers: " << pool.allocations() << " allocated, "
+            << pool.reuses() << " reused\n";
+
+  std::cout << std::flush;
+
+  return (failures == 0) ? 0 : 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -1170,7 +1718,13 @@ void convert_grayscale_to_binary_adaptive(){
 
 int main( int argc, char** argv ){
 
-  g_scanned_image = nullptr;
+  g_scanned_image_width  = 0;
+  g_scanned_image_height = 0;
+
+  // Any argument selects batch mode; the menus only run with none
+  if( argc > 1 ){
+    return run_batch( argc, argv );
+  }
 
   int menu_option = 0; // start on main menu
 
@@ -1240,6 +1794,9 @@ int main( int argc, char** argv ){
       case 4:
         analyze_features();
         break;
+      case 5:
+        convert_feature_database();
+        break;
       }
       break;
 
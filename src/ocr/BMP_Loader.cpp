@@ -13,12 +13,21 @@
  *
  * Sep 23, 2015: 
  * - BMP_Loader.cpp created
+ *
+ * Oct 17, 2026:
+ * - Palettized bitmaps with an index past the end of their color table
+ *   are rejected
  */
 #include "BMP_Loader.hpp"
 #include "base_types.hpp"
 #include "Image.hpp"
+#include "Mapped_File.hpp"
+#include "simd.hpp"
 
+#include <algorithm> // std::min
 #include <cmath>
+#include <cstdint>   // std::uint64_t
+#include <cstring>   // std::memcpy
 #include <fstream>
 #include <ostream>
 
@@ -33,7 +42,7 @@ namespace ocr {
     u32 size;      ///< 4 bytes: Size of the bmp file in bytes
     u16 reserved1; ///< 2 bytes: reserved for the program that makes the bitmap
     u16 reserved2; ///< 2 bytes: reserved for the program that makes the bitmap
-    u16 offset;    ///< 2 bytes: offset from 0 to pixel map
+    u32 offset;    ///< 4 bytes: offset from 0 to pixel map
   } bmp_file_header;
 
   //---------------------------------------------------------------------------
@@ -77,60 +86,632 @@ namespace ocr {
 
   //---------------------------------------------------------------------------
 
-  static void read_bmp_headers( ubyte* buffer,
+  ///
+  /// @brief Reads a little-endian field of type @p T at any alignment
+  ///
+  template<typename T>
+  static inline T read_field( const ubyte* buffer ){
+    T value;
+    std::memcpy( &value, buffer, sizeof(T) );
+    return value;
+  }
+
+  //---------------------------------------------------------------------------
+
+  static void read_bmp_headers( const ubyte* buffer,
                                 bmp_file_header* file_header,
                                 bmp_info_header_* info_header ){
 
-    // Read file header
+    // Read file header; its fields are not aligned, and the buffer may have
+    // come off the network, so every field is copied out
     file_header->type[0]   = (u16) buffer[0]; // ( (buffer[0] << 8) | buffer[1] );
     file_header->type[1]   = (u16) buffer[1];
-    //file_header.type   = (*(u16*)(buffer + 0x00));
-    file_header->size      = (*(u32*)(buffer + 0x02));
-    file_header->reserved1 = (*(u16*)(buffer + 0x06));
-    file_header->reserved2 = (*(u16*)(buffer + 0x08));
-    file_header->offset    = (*(u32*)(buffer + 0x0A));
+    file_header->size      = read_field<u32>( buffer + 0x02 );
+    file_header->reserved1 = read_field<u16>( buffer + 0x06 );
+    file_header->reserved2 = read_field<u16>( buffer + 0x08 );
+    file_header->offset    = read_field<u32>( buffer + 0x0A );
 
     // Read info_header
-    info_header->size      = (*(u32*)(buffer + 0x0E));
-    info_header->width     = (*(s32*)(buffer + 0x12));
-    info_header->height    = (*(s32*)(buffer + 0x16));
-    info_header->planes    = (*(u16*)(buffer + 0x1A));
-    info_header->bpp       = (*(u16*)(buffer + 0x1C));
+    info_header->size      = read_field<u32>( buffer + 0x0E );
+    info_header->width     = read_field<s32>( buffer + 0x12 );
+    info_header->height    = read_field<s32>( buffer + 0x16 );
+    info_header->planes    = read_field<u16>( buffer + 0x1A );
+    info_header->bpp       = read_field<u16>( buffer + 0x1C );
 
-    info_header->compression  = (*(u32*)(buffer + 0x1E));
-    info_header->image_size   = (*(u32*)(buffer + 0x22));
-    info_header->x_resolution = (*(u32*)(buffer + 0x26));
-    info_header->y_resolution = (*(u32*)(buffer + 0x2A));
+    info_header->compression  = read_field<u32>( buffer + 0x1E );
+    info_header->image_size   = read_field<u32>( buffer + 0x22 );
+    info_header->x_resolution = read_field<s32>( buffer + 0x26 );
+    info_header->y_resolution = read_field<s32>( buffer + 0x2A );
 
-    info_header->colors           = (*(u32*)(buffer + 0x2E));
-    info_header->important_colors = (*(u32*)(buffer + 0x32));
+    info_header->colors           = read_field<u32>( buffer + 0x2E );
+    info_header->important_colors = read_field<u32>( buffer + 0x32 );
 
   }
 
   //---------------------------------------------------------------------------
-  // Load images
+  // Pixel Conversions
   //---------------------------------------------------------------------------
 
-  int load_bmp_image_color( const char* filename, Image** image ){
+  ///
+  /// @brief Converts a single pixel, writing the 3 bytes of the image pixel
+  ///
+  static void convert_pixel( pixel_conversion conversion,
+                             ubyte r, ubyte g, ubyte b,
+                             ubyte* dst ){
+    switch(conversion){
+
+    case PC_GRAYSCALE:
+      dst[0] = dst[1] = dst[2] = (ubyte) (((u32) r + g + b) / 3);
+      break;
+
+    case PC_BINARY:
+      dst[0] = dst[1] = dst[2] = (ubyte) (((r | g | b) == 0) ? 0 : 255);
+      break;
+
+    default:
+      dst[0] = r;
+      dst[1] = g;
+      dst[2] = b;
+      break;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Row Decoders
+  //---------------------------------------------------------------------------
+
+  //
+  // Each decoder converts one stored row of the bitmap into one row of the
+  // image's RGB pixels. They are written as flat loops over bytes (rather
+  // than through Image::set) so that the compiler turns them into shuffles
+  // over many pixels at once.
+  //
+
+  ///
+  /// @brief State shared by the decoders for the rows of one bitmap
+  ///
+  struct row_context{
+    const ubyte* table;     ///< Palettized rows: the output bytes for every
+                            ///< possible source byte
+    u32          masks[3];  ///< Masked rows: the red, green and blue masks
+    u32          shifts[3]; ///< Masked rows: the shift of each mask
+    u32          maxima[3]; ///< Masked rows: the largest value of each channel
+    pixel_conversion conversion; ///< Masked rows: the conversion to apply
+  };
+
+  typedef void (*row_decoder)( const row_context& context,
+                               const ubyte* src,
+                               ubyte* dst,
+                               std::size_t width );
+
+  static_assert( sizeof(Image::pixel_type) == 3,
+                 "row decoders write the image as packed 3-byte pixels" );
+
+  //---------------------------------------------------------------------------
+
+  template<std::size_t Step>
+  OCR_TARGET_CLONES
+  static void decode_row_color( const row_context&,
+                                const ubyte* OCR_RESTRICT src,
+                                ubyte* OCR_RESTRICT dst,
+                                std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+      dst[3*col]   = src[Step*col+2];
+      dst[3*col+1] = src[Step*col+1];
+      dst[3*col+2] = src[Step*col];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<std::size_t Step>
+  OCR_TARGET_CLONES
+  static void decode_row_grayscale( const row_context&,
+                                    const ubyte* OCR_RESTRICT src,
+                                    ubyte* OCR_RESTRICT dst,
+                                    std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+      const u32 sum = (u32) src[Step*col] + src[Step*col+1] + src[Step*col+2];
+
+      // (sum * 0xAAAB) >> 17 is exactly sum / 3 for every sum up to 765
+      const ubyte average = (ubyte) ((sum * 0xAAABu) >> 17);
+
+      dst[3*col]   = average;
+      dst[3*col+1] = average;
+      dst[3*col+2] = average;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<std::size_t Step>
+  OCR_TARGET_CLONES
+  static void decode_row_binary( const row_context&,
+                                 const ubyte* OCR_RESTRICT src,
+                                 ubyte* OCR_RESTRICT dst,
+                                 std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+
+      // Only pure black is ink; everything else is background
+      const ubyte value = (ubyte)
+        (((src[Step*col] | src[Step*col+1] | src[Step*col+2]) == 0) ? 0 : 255);
+
+      dst[3*col]   = value;
+      dst[3*col+1] = value;
+      dst[3*col+2] = value;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // Palettized rows pack 8/Bits pixels into every byte. The context's table
+  // holds the converted output of all of them for each of the 256 possible
+  // bytes, so a whole byte of pixels is decoded with one fixed-size copy;
+  // for 1 bit bilevel scans that is 8 pixels straight into their binary
+  // form, with no per-pixel work at all.
+  //
+  template<std::size_t Bits>
+  static void decode_row_indexed( const row_context& context,
+                                  const ubyte* OCR_RESTRICT src,
+                                  ubyte* OCR_RESTRICT dst,
+                                  std::size_t width ){
+    const std::size_t pixels_per_byte = 8 / Bits;
+    const std::size_t bytes_per_entry = 3 * pixels_per_byte;
+    const std::size_t whole_bytes     = width / pixels_per_byte;
+    const std::size_t remainder       = width % pixels_per_byte;
+
+    for( std::size_t i = 0; i < whole_bytes; ++i ){
+      std::memcpy( dst, context.table + src[i] * bytes_per_entry, bytes_per_entry );
+      dst += bytes_per_entry;
+    }
+
+    // The last byte of the row may only be partially used
+    if( remainder ){
+      std::memcpy( dst, context.table + src[whole_bytes] * bytes_per_entry, 3 * remainder );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // 32 bit rows with arbitrary channel masks (BI_BITFIELDS). The common
+  // BGRX/BGRA layout never gets here; it uses the byte decoders above.
+  //
+  static void decode_row_masked( const row_context& context,
+                                 const ubyte* OCR_RESTRICT src,
+                                 ubyte* OCR_RESTRICT dst,
+                                 std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col, src += 4, dst += 3 ){
+      const u32 pixel = (u32) src[0]         | ((u32) src[1] << 8) |
+                        ((u32) src[2] << 16) | ((u32) src[3] << 24);
+      ubyte channels[3];
+
+      for( std::size_t c = 0; c < 3; ++c ){
+        const u32 value = (pixel & context.masks[c]) >> context.shifts[c];
+
+        // Rescale channels that are not 8 bits wide to 0-255; a channel
+        // wider than 24 bits would overflow 32 bits once scaled
+        channels[c] = (ubyte) (context.maxima[c] ? ((std::uint64_t) value * 255u) / context.maxima[c] : 0);
+      }
+
+      convert_pixel( context.conversion, channels[0], channels[1], channels[2], dst );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Fills in the lookup table used by decode_row_indexed
+  ///
+  /// @param view       the palettized bitmap
+  /// @param conversion the conversion to apply to each palette entry
+  /// @param table      the table to fill; 256 entries of 8/bpp pixels
+  ///
+  static void build_index_table( const bmp_view& view,
+                                 pixel_conversion conversion,
+                                 ubyte* table ){
+    // Convert every palette entry once; open_bmp_view() has rejected any
+    // bitmap that indexes past them
+    ubyte palette[256][3] = {};
+
+    for( u32 i = 0; i < view.colors; ++i ){
+      const ubyte* entry = view.palette + 4 * i; // stored as BGRX
+      convert_pixel( conversion, entry[2], entry[1], entry[0], palette[i] );
+    }
+
+    // Expand each byte into the pixels it packs, most significant bits first
+    const u32 bits            = view.bpp;
+    const u32 pixels_per_byte = 8 / bits;
+    const u32 index_mask      = (1u << bits) - 1;
+
+    for( u32 byte = 0; byte < 256; ++byte ){
+      ubyte* entry = table + byte * 3 * pixels_per_byte;
+
+      for( u32 k = 0; k < pixels_per_byte; ++k ){
+        const u32 index = (byte >> (8 - bits * (k + 1))) & index_mask;
+        std::memcpy( entry + 3 * k, palette[index], 3 );
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Fills in the channel masks used by decode_row_masked
+  ///
+  static void build_mask_table( const bmp_view& view,
+                                pixel_conversion conversion,
+                                row_context* context ){
+    const u32 masks[3] = { view.red_mask, view.green_mask, view.blue_mask };
+
+    for( std::size_t c = 0; c < 3; ++c ){
+      u32 shift = 0;
+      while( masks[c] && !((masks[c] >> shift) & 1u) ){
+        ++shift;
+      }
+      context->masks[c]  = masks[c];
+      context->shifts[c] = shift;
+      context->maxima[c] = masks[c] >> shift;
+    }
+    context->conversion = conversion;
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @struct ocr::bmp_decoder
+  ///
+  /// @brief The decoder matching the layout of one bitmap, along with the
+  ///        state it needs
+  ///
+  struct bmp_decoder{
+    ubyte       table[256 * 3 * 8]; ///< One entry per byte, up to 8 pixels each
+    row_context context;            ///< The state passed to the decoder
+    row_decoder decode;             ///< The decoder for each stored row
+  };
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Selects the decoder for the rows of a bitmap
+  ///
+  /// @param view       the bitmap to decode
+  /// @param conversion the conversion to apply to every pixel
+  /// @param decoder    the decoder to set up
+  /// @return true if the bitmap's layout can be decoded
+  ///
+  static bool init_decoder( const bmp_view& view,
+                            pixel_conversion conversion,
+                            bmp_decoder* decoder ){
+    decoder->context.table = decoder->table;
+    decoder->decode        = NULL;
+
+    const bool bgr_order = (view.red_mask   == 0x00ff0000u) &&
+                           (view.green_mask == 0x0000ff00u) &&
+                           (view.blue_mask  == 0x000000ffu);
+
+    switch(view.bpp){
+
+    case 1:
+    case 4:
+    case 8:
+      build_index_table( view, conversion, decoder->table );
+      decoder->decode = (view.bpp == 1) ? &decode_row_indexed<1> :
+                        (view.bpp == 4) ? &decode_row_indexed<4> :
+                                          &decode_row_indexed<8>;
+      break;
+
+    case 24:
+      decoder->decode = (conversion == PC_GRAYSCALE) ? &decode_row_grayscale<3> :
+                        (conversion == PC_BINARY)    ? &decode_row_binary<3>    :
+                                                       &decode_row_color<3>;
+      break;
+
+    case 32:
+      if(bgr_order){
+        decoder->decode = (conversion == PC_GRAYSCALE) ? &decode_row_grayscale<4> :
+                          (conversion == PC_BINARY)    ? &decode_row_binary<4>    :
+                                                         &decode_row_color<4>;
+      }else{
+        build_mask_table( view, conversion, &decoder->context );
+        decoder->decode = &decode_row_masked;
+      }
+      break;
+
+    default:
+      return false;
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Decodes a range of the bitmap's rows into image pixels
+  ///
+  /// @param decoder the decoder for the bitmap
+  /// @param view    the bitmap to decode
+  /// @param first   the first row to decode, counting from the top
+  /// @param count   the number of rows to decode
+  /// @param data    the pixels to write; @p count rows of the bitmap's width
+  ///
+  static void decode_rows( const bmp_decoder& decoder,
+                           const bmp_view& view,
+                           std::size_t first,
+                           std::size_t count,
+                           Image::pixel_type* data ){
+    const std::size_t width = view.width;
+
+    // Visit the rows in the order they are stored in the file, so that the
+    // mapping is paged in sequentially.
+    for( std::size_t i = 0; i < count; ++i ){
+      const std::size_t row = (view.stride < 0) ? (count - i - 1) : i;
+
+      decoder.decode( decoder.context,
+                      view.pixels + (std::ptrdiff_t) (first + row) * view.stride,
+                      (ubyte*) (data + row * width),
+                      width );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Decodes every row of an open view into a new image
+  ///
+  /// @param view       the view of the bitmap; closed before returning
+  /// @param image      the image to create
+  /// @param conversion the conversion to apply to every pixel
+  /// @return the status of the load
+  ///
+  static int load_bmp_image( bmp_view& view,
+                             Image** image,
+                             pixel_conversion conversion ){
+    bmp_decoder decoder;
+
+    if( !init_decoder( view, conversion, &decoder ) ){
+      close_bmp_view( &view );
+      return IS_TYPE_INVALID;
+    }
+
+    //-------------------------------------------------------------------------
+
+    const std::size_t width  = view.width;
+    const std::size_t height = view.height;
+
+    // A new image's rows are packed, so they decode as one array
+    *image = new Image( width, height );
+
+    decode_rows( decoder, view, 0, height, (*image)->ptr() );
+
+    close_bmp_view( &view );
+
+    return IS_SUCCESS;
+  }
+
+  ///
+  /// @brief Loads a bitmap, converting every row with the decoder matching
+  ///        the bitmap's layout
+  ///
+  /// @param filename   the bitmap to load
+  /// @param image      the image to create
+  /// @param conversion the conversion to apply to every pixel
+  /// @return the status of the load
+  ///
+  static int load_bmp_image( const char* filename,
+                             Image** image,
+                             pixel_conversion conversion ){
+    bmp_view view;
+
+    int status;
+    if( (status = open_bmp_view( filename, &view )) != IS_SUCCESS ){
+      return status;
+    }
+    return load_bmp_image( view, image, conversion );
+  }
+
+  ///
+  /// @brief Loads a bitmap held in memory
+  ///
+  /// @param data       the bytes of the bitmap file
+  /// @param size       the number of bytes at @p data
+  /// @param image      the image to create
+  /// @param conversion the conversion to apply to every pixel
+  /// @return the status of the load
+  ///
+  static int load_bmp_image( const ubyte* data,
+                             std::size_t size,
+                             Image** image,
+                             pixel_conversion conversion ){
+    bmp_view view;
+
+    int status;
+    if( (status = open_bmp_view( data, size, &view )) != IS_SUCCESS ){
+      return status;
+    }
+    return load_bmp_image( view, image, conversion );
+  }
+
+  //
+  // Single channel images are decoded a few rows at a time into a small
+  // scratch buffer of RGB pixels, each row of which is then narrowed into
+  // the image. The scratch stays in cache, so the image is the only memory
+  // the load streams through: a third of a color image's for grayscale, and
+  // a twenty-fourth for packed binary.
+  //
+
+  OCR_TARGET_CLONES
+  static void narrow_row_gray8( const Image::pixel_type* OCR_RESTRICT src,
+                                ubyte* OCR_RESTRICT dst,
+                                std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+      dst[col] = src[col].r;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  static void narrow_row_packed( const Image::pixel_type* OCR_RESTRICT src,
+                                 ubyte* OCR_RESTRICT dst,
+                                 std::size_t width ){
+    const std::size_t whole_bytes = width / 8;
+    const std::size_t remainder   = width % 8;
+
+    // Binary decoding leaves ink as 0 and background as 255 in every channel
+    for( std::size_t i = 0; i < whole_bytes; ++i, src += 8 ){
+      ubyte packed = 0;
+      for( std::size_t k = 0; k < 8; ++k ){
+        packed = (ubyte) ((packed << 1) | (src[k].r == 0));
+      }
+      dst[i] = packed;
+    }
+    if( remainder ){
+      ubyte packed = 0;
+      for( std::size_t k = 0; k < remainder; ++k ){
+        packed = (ubyte) ((packed << 1) | (src[k].r == 0));
+      }
+      dst[whole_bytes] = (ubyte) (packed << (8 - remainder));
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Decodes every row of an open view into a single channel image
+  ///
+  /// @param view       the view of the bitmap; closed before returning
+  /// @param image      the image to create
+  /// @param conversion the conversion to apply to every pixel
+  /// @param narrow     narrows each decoded row into the image
+  /// @return the status of the load
+  ///
+  template<typename Image_Type>
+  static int load_bmp_narrow( bmp_view& view,
+                              Image_Type** image,
+                              pixel_conversion conversion,
+                              void (*narrow)( const Image::pixel_type*, ubyte*, std::size_t ) ){
     typedef Image::pixel_type pixel_type;
 
-    std::fstream file;
-    file.open(filename, std::ios::in | std::ios::binary );
+    bmp_decoder decoder;
 
-    // If file doesn't open, throw exception
-    if(!file.is_open()){
+    if( !init_decoder( view, conversion, &decoder ) ){
+      close_bmp_view( &view );
+      return IS_TYPE_INVALID;
+    }
+
+    const std::size_t width  = view.width;
+    const std::size_t height = view.height;
+    const std::size_t chunk  = std::max<std::size_t>( 1, (64u << 10) / (width * sizeof(pixel_type)) );
+
+    Image_Type* out     = new Image_Type( width, height );
+    pixel_type* scratch = new pixel_type[ width * std::min( chunk, height ) ];
+
+    for( std::size_t first = 0; first < height; first += chunk ){
+      const std::size_t count = std::min( chunk, height - first );
+
+      decode_rows( decoder, view, first, count, scratch );
+
+      for( std::size_t row = 0; row < count; ++row ){
+        narrow( scratch + row * width, (ubyte*) out->row( first + row ), width );
+      }
+    }
+
+    delete [] scratch;
+    close_bmp_view( &view );
+
+    *image = out;
+
+    return IS_SUCCESS;
+  }
+
+  //---------------------------------------------------------------------------
+  // Bitmap Views
+  //---------------------------------------------------------------------------
+
+  int open_bmp_view( const char* filename, bmp_view* view ){
+    Mapped_File* file = new Mapped_File();
+
+    if(!file->open( filename )){
+      delete file;
       return IS_FILE_NOT_FOUND;
     }
 
-    bmp_file_header file_header;
-    bmp_info_header info_header;
-    ubyte           buffer[54];
+    int status;
+    if( (status = open_bmp_view( file->data(), file->size(), view )) != IS_SUCCESS ){
+      delete file;
+      return status;
+    }
 
-    file.read( (char*) buffer, sizeof(buffer) );
+    view->file = file;
+    return IS_SUCCESS;
+  }
 
-    //-------------------------------------------------------------------------
-    // Read headers
-    //-------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Checks that every pixel of a palettized bitmap indexes an entry
+  ///        of its color table
+  ///
+  /// @param rows     the first stored row
+  /// @param row_size the bytes in each stored row, padding included
+  /// @param height   the number of rows
+  /// @param width    the pixels in each row
+  /// @param bpp      the bits per pixel (1, 4 or 8)
+  /// @param colors   the number of entries in the color table
+  /// @return true if no pixel indexes past the end of the table
+  ///
+  static bool indices_in_palette( const ubyte* rows,
+                                  std::size_t row_size,
+                                  std::size_t height,
+                                  std::size_t width,
+                                  u32 bpp,
+                                  u32 colors ){
+    const u32 pixels_per_byte = 8 / bpp;
+    const u32 index_mask      = (1u << bpp) - 1;
+
+    // Whether each byte packs only valid indices
+    bool valid[256];
+    for( u32 byte = 0; byte < 256; ++byte ){
+      valid[byte] = true;
+      for( u32 k = 0; k < pixels_per_byte; ++k ){
+        if( ((byte >> (8 - bpp * (k + 1))) & index_mask) >= colors ){
+          valid[byte] = false;
+        }
+      }
+    }
+
+    // The unused bits of a row's last byte are padding, and read as index 0
+    const std::size_t whole_bytes = width / pixels_per_byte;
+    const std::size_t remainder   = width % pixels_per_byte;
+    const ubyte       last_mask   = (ubyte) (0xff00u >> (remainder * bpp));
+
+    for( std::size_t y = 0; y < height; ++y ){
+      const ubyte* row = rows + y * row_size;
+
+      for( std::size_t i = 0; i < whole_bytes; ++i ){
+        if( !valid[row[i]] ){
+          return false;
+        }
+      }
+      if( remainder && !valid[row[whole_bytes] & last_mask] ){
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  int open_bmp_view( const ubyte* buffer, std::size_t size, bmp_view* view ){
+
+    // Must at least contain both headers
+    if( size < bmp_file_header_size + bmp_info_header_size ){
+      return IS_TYPE_INVALID;
+    }
+
+    bmp_file_header file_header;
+    bmp_info_header info_header;
 
     read_bmp_headers( buffer, &file_header, &info_header );
 
@@ -141,174 +722,557 @@ namespace ocr {
       return IS_TYPE_INVALID;
     }
 
-    // If compression is BI_BITFIELDS, seek ahead past the bit mask
-    if(info_header.compression == BI_BITFIELDS ){
-      file.seekg( bmp_file_header_size + bmp_info_header_size + bmp_bit_mask_size );
+    const u16 bpp         = info_header.bpp;
+    const u32 compression = info_header.compression;
+
+    // Palettized bitmaps (1, 4 or 8 bit) and 24 bit bitmaps are stored
+    // uncompressed; 32 bit bitmaps may also describe their channels with
+    // bit masks.
+    const bool is_indexed = (bpp == 1) || (bpp == 4) || (bpp == 8);
+    const bool is_masked  = (bpp == 32) &&
+                            ((compression == BI_BITFIELDS) || (compression == BI_ALPHABITFIELDS));
+
+    if( !(is_indexed || bpp == 24 || bpp == 32) ||
+        !(compression == BI_RGB || is_masked) ||
+        (info_header.size < bmp_info_header_size) ||
+        (info_header.width <= 0) || (info_header.height == 0) ){
+      return IS_TYPE_INVALID;
     }
 
-    pixel_type* data = new pixel_type[ info_header.width * info_header.height ];
+    // A top-down height is negated below, which the most negative height
+    // would overflow
+    if( info_header.height < -0x7fffffff ){
+      return IS_TYPE_INVALID;
+    }
 
-    // 24 & 32 bit bitmaps store data immediately after headers; no table
-    if(( info_header.bpp == 24) || (info_header.bpp == 32)){
-      // Size of each row (account for padding)
-      u32 row_size = ((info_header.width * 3 + 3) & ~3);
+    // Any color table follows the info header (and the bit masks, which
+    // trail the basic 40 byte info header when BI_BITFIELDS is used)
+    std::size_t table_offset = bmp_file_header_size + info_header.size;
+    if( is_masked && info_header.size == bmp_info_header_size ){
+      table_offset += (compression == BI_ALPHABITFIELDS) ? bmp_bit_mask_size + 4 : bmp_bit_mask_size;
+    }
 
-      // Allocate storage for the row
-      ubyte* row_buffer = new ubyte[row_size];
+    // Channel masks; 32 bit BI_RGB bitmaps are implicitly BGRX
+    u32 masks[3] = { 0x00ff0000u, 0x0000ff00u, 0x000000ffu };
+    if( is_masked ){
+      const std::size_t mask_offset = bmp_file_header_size + bmp_info_header_size;
+      if( size < mask_offset + bmp_bit_mask_size ){
+        return IS_TYPE_INVALID;
+      }
+      masks[0] = read_field<u32>( buffer + mask_offset + 0 );
+      masks[1] = read_field<u32>( buffer + mask_offset + 4 );
+      masks[2] = read_field<u32>( buffer + mask_offset + 8 );
+    }
 
-      // Read each pixel from pixel buffer; store in data
-      for( s32 row = 0; row < info_header.height; ++row ){
-        file.read( (char*) row_buffer, row_size );
+    // The color table has 2^bpp entries unless the header says otherwise
+    u32 colors = 0;
+    if( is_indexed ){
+      colors = info_header.colors;
+      if( colors == 0 || colors > (1u << bpp) ){
+        colors = (1u << bpp);
+      }
+      if( table_offset > size || (size - table_offset) / 4 < colors ){
+        return IS_TYPE_INVALID;
+      }
+    }
 
-        for( s32 col = 0; col < info_header.width; ++col ){
+    // Pixel data follows the headers and color table, unless the file
+    // header says otherwise
+    std::size_t offset = table_offset + 4 * colors;
+    if( file_header.offset >= bmp_file_header_size + bmp_info_header_size ){
+      offset = file_header.offset;
+    }
 
-          // Bitmaps store data from bottom up
-          const u32 index = (((info_header.height - row - 1) * info_header.width) + col);
+    // A negative height denotes a top-down bitmap
+    const bool        top_down = (info_header.height < 0);
+    const s32         height   = top_down ? -info_header.height : info_header.height;
+    const std::size_t row_size = (((std::size_t) info_header.width * info_header.bpp + 31) / 32) * 4;
 
-          // Bitmap stores in BGR format
-          data[index].r = row_buffer[3*col+2];
-          data[index].g = row_buffer[3*col+1];
-          data[index].b = row_buffer[3*col];
-        }
-      }
+    // Ensure every row is actually inside the file
+    if( offset > size || (size - offset) / row_size < (std::size_t) height ){
+      return IS_TYPE_INVALID;
+    }
 
-      delete [] row_buffer;
-    }else{
-      file.close();
+    const ubyte* rows = buffer + offset;
+
+    // A table shorter than 2^bpp leaves indices with no color; those only
+    // come from a corrupt or hostile file
+    if( is_indexed && colors < (1u << bpp) &&
+        !indices_in_palette( rows, row_size, height, info_header.width, bpp, colors ) ){
       return IS_TYPE_INVALID;
     }
-    file.close();
 
-    *image = new Image( info_header.width, info_header.height, data );
+    //-------------------------------------------------------------------------
+
+    if(top_down){
+      view->pixels = rows;
+      view->stride = (std::ptrdiff_t) row_size;
+    }else{
+      // Bitmaps store data from bottom up; walk backwards from the last row
+      view->pixels = rows + (height - 1) * row_size;
+      view->stride = -((std::ptrdiff_t) row_size);
+    }
+    view->width  = info_header.width;
+    view->height = height;
+    view->bpp    = bpp;
+    view->file   = NULL;
+
+    view->palette    = is_indexed ? buffer + table_offset : NULL;
+    view->colors     = colors;
+    view->red_mask   = masks[0];
+    view->green_mask = masks[1];
+    view->blue_mask  = masks[2];
 
     return IS_SUCCESS;
   }
 
   //---------------------------------------------------------------------------
 
+  void close_bmp_view( bmp_view* view ){
+    delete view->file;
+    view->file    = NULL;
+    view->pixels  = NULL;
+    view->palette = NULL;
+  }
+
+  //---------------------------------------------------------------------------
+  // Load images
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_color( const char* filename, Image** image ){
+    return load_bmp_image( filename, image, PC_COLOR );
+  }
+
+  //---------------------------------------------------------------------------
+
   int load_bmp_image_grayscale( const char* filename, Image** image ){
-    typedef Image::pixel_type pixel_type;
+    return load_bmp_image( filename, image, PC_GRAYSCALE );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_binary( const char* filename, Image** image ){
+    return load_bmp_image( filename, image, PC_BINARY );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_color( const ubyte* data, std::size_t size, Image** image ){
+    return load_bmp_image( data, size, image, PC_COLOR );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_grayscale( const ubyte* data, std::size_t size, Image** image ){
+    return load_bmp_image( data, size, image, PC_GRAYSCALE );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_binary( const ubyte* data, std::size_t size, Image** image ){
+    return load_bmp_image( data, size, image, PC_BINARY );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int load_bmp_image_grayscale( const char* filename, Gray_Image** image ){
+    bmp_view view;
 
     int status;
-    if( (status = load_bmp_image_color( filename, image )) != IS_SUCCESS ){
+    if( (status = open_bmp_view( filename, &view )) != IS_SUCCESS ){
       return status;
     }
-    for( std::size_t i = 0; i < (*image)->width(); ++i){
-      for( std::size_t j = 0; j < (*image)->height(); ++j ){
-        pixel_type old_pixel = (*image)->at(i,j);
-        pixel_type new_pixel;
+    return load_bmp_narrow( view, image, PC_GRAYSCALE, &narrow_row_gray8 );
+  }
 
-        u32 average = (old_pixel.r + old_pixel.g + old_pixel.b) / 3;
+  //---------------------------------------------------------------------------
 
-        new_pixel.r = (ubyte) average;
-        new_pixel.g = (ubyte) average;
-        new_pixel.b = (ubyte) average;
+  int load_bmp_image_grayscale( const ubyte* data, std::size_t size, Gray_Image** image ){
+    bmp_view view;
 
-        (*image)->set( i, j, new_pixel );
-      }
+    int status;
+    if( (status = open_bmp_view( data, size, &view )) != IS_SUCCESS ){
+      return status;
     }
+    return load_bmp_narrow( view, image, PC_GRAYSCALE, &narrow_row_gray8 );
+  }
+
+  //---------------------------------------------------------------------------
 
-    return status;
+  int load_bmp_image_binary( const char* filename, Binary_Image** image ){
+    bmp_view view;
+
+    int status;
+    if( (status = open_bmp_view( filename, &view )) != IS_SUCCESS ){
+      return status;
+    }
+    return load_bmp_narrow( view, image, PC_BINARY, &narrow_row_packed );
   }
 
   //---------------------------------------------------------------------------
 
-  int load_bmp_image_binary( const char* filename, Image** image ){
-    typedef Image::pixel_type pixel_type;
+  int load_bmp_image_binary( const ubyte* data, std::size_t size, Binary_Image** image ){
+    bmp_view view;
 
     int status;
-    if( (status = load_bmp_image_color( filename, image )) != IS_SUCCESS ){
+    if( (status = open_bmp_view( data, size, &view )) != IS_SUCCESS ){
       return status;
     }
-    for( std::size_t i = 0; i < (*image)->width(); ++i){
-      for( std::size_t j = 0; j < (*image)->height(); ++j ){
-        pixel_type old_pixel = (*image)->at(i,j);
-        pixel_type new_pixel;
+    return load_bmp_narrow( view, image, PC_BINARY, &narrow_row_packed );
+  }
+
+  //---------------------------------------------------------------------------
+
+  void destroy_image( Gray_Image** image ){
+    delete (*image);
+    (*image) = NULL;
+  }
+
+  void destroy_image( Binary_Image** image ){
+    delete (*image);
+    (*image) = NULL;
+  }
+
+  //---------------------------------------------------------------------------
+  // Row Encoders
+  //---------------------------------------------------------------------------
+
+  //
+  // Each encoder packs one row of the image's RGB pixels into one stored row
+  // of the bitmap, mirroring the row decoders above: 24 bit BGR, 8 bit
+  // indices into a gray ramp, or 1 bit indices into a black/white table.
+  //
+
+  typedef void (*row_encoder)( const ubyte* src,
+                               ubyte* dst,
+                               std::size_t width );
+
+  //---------------------------------------------------------------------------
+
+  OCR_TARGET_CLONES
+  static void encode_row_color( const ubyte* OCR_RESTRICT src,
+                                ubyte* OCR_RESTRICT dst,
+                                std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+      dst[3*col]   = src[3*col+2];
+      dst[3*col+1] = src[3*col+1];
+      dst[3*col+2] = src[3*col];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  OCR_TARGET_CLONES
+  static void encode_row_grayscale( const ubyte* OCR_RESTRICT src,
+                                    ubyte* OCR_RESTRICT dst,
+                                    std::size_t width ){
+    for( std::size_t col = 0; col < width; ++col ){
+      const u32 sum = (u32) src[3*col] + src[3*col+1] + src[3*col+2];
+
+      // The palette is a gray ramp, so the index is the intensity itself
+      dst[col] = (ubyte) ((sum * 0xAAABu) >> 17);
+    }
+  }
 
-        // To load an image in binary,
-        ubyte value = (((old_pixel.r + old_pixel.g + old_pixel.b) == 0) ? 0 : 255);
+  //---------------------------------------------------------------------------
 
-        new_pixel.r = value;
-        new_pixel.g = value;
-        new_pixel.b = value;
+  static void encode_row_binary( const ubyte* OCR_RESTRICT src,
+                                 ubyte* OCR_RESTRICT dst,
+                                 std::size_t width ){
+    const std::size_t whole_bytes = width / 8;
+    const std::size_t remainder   = width % 8;
+
+    // Index 0 (black) is ink; everything else is background (index 1)
+    for( std::size_t i = 0; i < whole_bytes; ++i, src += 24 ){
+      ubyte packed = 0;
+      for( std::size_t k = 0; k < 8; ++k ){
+        const ubyte white = (ubyte) ((src[3*k] | src[3*k+1] | src[3*k+2]) != 0);
+        packed = (ubyte) ((packed << 1) | white);
+      }
+      dst[i] = packed;
+    }
 
-        (*image)->set( i, j, new_pixel );
+    // The last byte of the row may only be partially used
+    if( remainder ){
+      ubyte packed = 0;
+      for( std::size_t k = 0; k < remainder; ++k ){
+        const ubyte white = (ubyte) ((src[3*k] | src[3*k+1] | src[3*k+2]) != 0);
+        packed |= (ubyte) (white << (7 - k));
       }
+      dst[whole_bytes] = packed;
     }
+  }
+
+  //---------------------------------------------------------------------------
 
-    return status;
+  //
+  // Single channel images are stored as their bitmaps store them: a gray
+  // byte is its own index into the gray ramp, and a packed binary row is the
+  // complement of a 1 bit row (a set bit is ink, where index 0 is black).
+  //
+
+  static void encode_row_gray8( const ubyte* OCR_RESTRICT src,
+                                ubyte* OCR_RESTRICT dst,
+                                std::size_t width ){
+    std::memcpy( dst, src, width );
   }
 
   //---------------------------------------------------------------------------
-  // Save Image
+
+  OCR_TARGET_CLONES
+  static void encode_row_packed( const ubyte* OCR_RESTRICT src,
+                                 ubyte* OCR_RESTRICT dst,
+                                 std::size_t width ){
+    const std::size_t bytes = (width + 7) / 8;
+
+    for( std::size_t i = 0; i < bytes; ++i ){
+      dst[i] = (ubyte) ~src[i];
+    }
+    // Bits past the last pixel stay clear, as the other encoders leave them
+    if( width & 7 ){
+      dst[bytes - 1] &= (ubyte) (0xff00u >> (width & 7));
+    }
+  }
+
   //---------------------------------------------------------------------------
 
-  bool save_bmp_image( const char* filename, Image* image ){
-    typedef Image::pixel_type pixel_type;
+  ///
+  /// @struct ocr::bmp_encoding
+  ///
+  /// @brief The layout of a bitmap written for one of the pixel conversions
+  ///
+  struct bmp_encoding{
+    u16         bpp;      ///< Bits per pixel of the stored rows
+    u32         colors;   ///< Number of entries in the color table
+    std::size_t row_size; ///< Size of each stored row, including padding
+    row_encoder encode;   ///< The encoder for each stored row
+  };
 
-    std::fstream file;
-    file.open(filename, std::ios::out | std::ios::binary );
+  //---------------------------------------------------------------------------
 
-    // If file doesn't open, throw exception
-    if(!file.is_open()){
-      return false;
+  static bmp_encoding select_encoding( pixel_conversion format,
+                                       std::size_t width ){
+    bmp_encoding encoding;
+
+    switch(format){
+
+    case PC_GRAYSCALE:
+      encoding.bpp    = 8;
+      encoding.colors = 256;
+      encoding.encode = &encode_row_grayscale;
+      break;
+
+    case PC_BINARY:
+      encoding.bpp    = 1;
+      encoding.colors = 2;
+      encoding.encode = &encode_row_binary;
+      break;
+
+    default:
+      encoding.bpp    = 24;
+      encoding.colors = 0;
+      encoding.encode = &encode_row_color;
+      break;
     }
+    encoding.row_size = ((width * encoding.bpp + 31) / 32) * 4;
 
-    //-------------------------------------------------------------------------
+    return encoding;
+  }
 
-    u32 row_size   = ((image->width() * 3 + 3) & ~3);
-    u32 image_size = (image->height() * row_size);
-    ubyte buffer[54];
+  //---------------------------------------------------------------------------
+  // Save Image
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Writes the headers and color table of an uncompressed bottom-up
+  ///        bitmap
+  ///
+  /// @param file     the stream to write to
+  /// @param encoding the layout of the bitmap's rows
+  /// @param width    the width of the bitmap in pixels
+  /// @param height   the height of the bitmap in pixels
+  ///
+  static void write_bmp_headers( std::ostream& file,
+                                 const bmp_encoding& encoding,
+                                 std::size_t width,
+                                 std::size_t height ){
+    const u32 offset     = (u32) (bmp_file_header_size + bmp_info_header_size + 4 * encoding.colors);
+    const u32 image_size = (u32) (height * encoding.row_size);
+
+    ubyte buffer[bmp_file_header_size + bmp_info_header_size];
 
     // Write file header
     (*(u8* )(buffer + 0x00)) = 'B';
     (*(u8* )(buffer + 0x01)) = 'M';
-    (*(u32*)(buffer + 0x02)) = image_size + bmp_file_header_size + bmp_info_header_size;
+    (*(u32*)(buffer + 0x02)) = image_size + offset;
     (*(u16*)(buffer + 0x06)) = 0;
     (*(u16*)(buffer + 0x08)) = 0;
-    (*(u32*)(buffer + 0x0A)) = bmp_file_header_size + bmp_info_header_size;
+    (*(u32*)(buffer + 0x0A)) = offset;
 
     // Write info header
     (*(u32*)(buffer + 0x0E)) = bmp_info_header_size;  // header size
-    (*(s32*)(buffer + 0x12)) = image->width();        // image width
-    (*(s32*)(buffer + 0x16)) = image->height();       // image height
+    (*(s32*)(buffer + 0x12)) = (s32) width;           // image width
+    (*(s32*)(buffer + 0x16)) = (s32) height;          // image height
     (*(u16*)(buffer + 0x1A)) = 1;                     // planes
-    (*(u16*)(buffer + 0x1C)) = 24;                    // bpp
+    (*(u16*)(buffer + 0x1C)) = encoding.bpp;          // bpp
 
-    (*(u32*)(buffer + 0x1E)) = BI_RGB;     // Compression
-    (*(u32*)(buffer + 0x22)) = image_size; // Image size
-    (*(u32*)(buffer + 0x26)) = 0;          // x resolution
-    (*(u32*)(buffer + 0x2A)) = 0;          // y resolution
+    (*(u32*)(buffer + 0x1E)) = BI_RGB;          // Compression
+    (*(u32*)(buffer + 0x22)) = image_size;      // Image size
+    (*(u32*)(buffer + 0x26)) = 0;               // x resolution
+    (*(u32*)(buffer + 0x2A)) = 0;               // y resolution
 
-    (*(u32*)(buffer + 0x2E)) = 0;          // colors
-    (*(u32*)(buffer + 0x32)) = 0;          // important colors
+    (*(u32*)(buffer + 0x2E)) = encoding.colors; // colors
+    (*(u32*)(buffer + 0x32)) = 0;               // important colors
 
-    // write the headers to the file
     file.write( (char*) buffer, sizeof(buffer) );
 
     //-------------------------------------------------------------------------
 
-    // Allocate data array for saving new image
-    ubyte* row_buffer = new ubyte[row_size];
+    // Palettized bitmaps are a gray ramp; for 2 colors that is black, white
+    if( encoding.colors ){
+      ubyte palette[256 * 4];
+      const u32 step = 255 / (encoding.colors - 1);
 
-    pixel_type temp;
+      for( u32 i = 0; i < encoding.colors; ++i ){
+        palette[4*i]   =
+        palette[4*i+1] =
+        palette[4*i+2] = (ubyte) (i * step);
+        palette[4*i+3] = 0;
+      }
+      file.write( (char*) palette, 4 * encoding.colors );
+    }
+  }
 
-    for( u32 row = 0; row < image->height(); ++row ){
-      for( u32 col = 0; col < image->width(); ++col ){
+  //---------------------------------------------------------------------------
 
-        // BMP saves rows of from bottom-up
-        temp = image->at( col, image->height() - row - 1 );
-        row_buffer[col*3+2] = temp.r;
-        row_buffer[col*3+1] = temp.g;
-        row_buffer[col*3]   = temp.b;
+  ///
+  /// @brief Writes rows of pixels, bottom-up, as one contiguous run of
+  ///        stored rows
+  ///
+  /// Rows are encoded into a buffer of up to a megabyte, which is written
+  /// out whenever it fills up.
+  ///
+  /// @param file     the stream to write to, positioned at the run
+  /// @param encoding the layout of the stored rows
+  /// @param pixels   the first byte of the top row to write
+  /// @param stride   the bytes from one row of @p pixels to the next
+  /// @param width    the width of each row in pixels
+  /// @param rows     the number of rows to write
+  ///
+  static void write_bmp_rows( std::ostream& file,
+                              const bmp_encoding& encoding,
+                              const ubyte* pixels,
+                              std::size_t stride,
+                              std::size_t width,
+                              std::size_t rows ){
+    const std::size_t row_size = encoding.row_size;
+    const std::size_t chunk    = std::max<std::size_t>( 1, (1u << 20) / row_size );
+    const std::size_t buffered = std::min( chunk, rows );
+
+    ubyte* buffer = new ubyte[buffered * row_size];
+
+    for( std::size_t i = 0; i < rows; ){
+      const std::size_t count = std::min( buffered, rows - i );
+
+      for( std::size_t k = 0; k < count; ++k, ++i ){
+        // BMP saves rows from the bottom up
+        const ubyte* src = pixels + (rows - i - 1) * stride;
+        ubyte*       dst = buffer + k * row_size;
+
+        // Padding is written as zeros; the encoders only write the pixels
+        std::memset( dst + row_size - 4, 0, 4 );
+        encoding.encode( src, dst, width );
       }
-      file.write( (char*) row_buffer, row_size );
+      file.write( (char*) buffer, (std::streamsize) (count * row_size) );
     }
 
-    delete [] row_buffer;
+    delete [] buffer;
+  }
+
+  static void write_bmp_rows( std::ostream& file,
+                              const bmp_encoding& encoding,
+                              const Image& image ){
+    write_bmp_rows( file, encoding, (const ubyte*) image.ptr(),
+                    image.stride() * sizeof(Image::pixel_type),
+                    image.width(), image.height() );
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool save_bmp_image( const char* filename, Image* image, pixel_conversion format ){
+    std::fstream file;
+    file.open(filename, std::ios::out | std::ios::binary );
+
+    // If file doesn't open, throw exception
+    if(!file.is_open()){
+      return false;
+    }
 
+    const bool good = save_bmp_image( file, *image, format );
     file.close();
-    return true;
+    return good;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool save_bmp_image( std::ostream& stream, const Image& image, pixel_conversion format ){
+    const bmp_encoding encoding = select_encoding( format, image.width() );
+
+    write_bmp_headers( stream, encoding, image.width(), image.height() );
+    write_bmp_rows( stream, encoding, image );
+
+    return stream.good();
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Opens @p filename and saves @p image to it as a bitmap
+  ///
+  template<typename Image_Type>
+  static bool save_bmp_file( const char* filename, const Image_Type& image ){
+    std::fstream file;
+    file.open(filename, std::ios::out | std::ios::binary );
+
+    if(!file.is_open()){
+      return false;
+    }
+
+    const bool good = save_bmp_image( file, image );
+    file.close();
+    return good;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool save_bmp_image( const char* filename, const Gray_Image& image ){
+    return save_bmp_file( filename, image );
+  }
+
+  bool save_bmp_image( std::ostream& stream, const Gray_Image& image ){
+    bmp_encoding encoding = select_encoding( PC_GRAYSCALE, image.width() );
+    encoding.encode = &encode_row_gray8;
+
+    write_bmp_headers( stream, encoding, image.width(), image.height() );
+    write_bmp_rows( stream, encoding, image.ptr(), image.stride(), image.width(), image.height() );
+
+    return stream.good();
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool save_bmp_image( const char* filename, const Binary_Image& image ){
+    return save_bmp_file( filename, image );
+  }
+
+  bool save_bmp_image( std::ostream& stream, const Binary_Image& image ){
+    bmp_encoding encoding = select_encoding( PC_BINARY, image.width() );
+    encoding.encode = &encode_row_packed;
+
+    write_bmp_headers( stream, encoding, image.width(), image.height() );
+    write_bmp_rows( stream, encoding, image.ptr(), image.row_bytes(), image.width(), image.height() );
+
+    return stream.good();
   }
 
   //---------------------------------------------------------------------------
@@ -321,6 +1285,189 @@ namespace ocr {
   }
 
   //---------------------------------------------------------------------------
+  // Band Reader
+  //---------------------------------------------------------------------------
+
+  BMP_Band_Reader::BMP_Band_Reader()
+    : m_decoder(NULL),
+      m_band(NULL),
+      m_band_rows(0),
+      m_halo_rows(0),
+      m_band_first(0),
+      m_core_first(0),
+      m_core_rows(0),
+      m_next(0)
+  {
+    m_view.file   = NULL;
+    m_view.width  = 0;
+    m_view.height = 0;
+  }
+
+  BMP_Band_Reader::~BMP_Band_Reader(){
+    close();
+  }
+
+  //---------------------------------------------------------------------------
+
+  int BMP_Band_Reader::open( const char* filename,
+                             pixel_conversion conversion,
+                             size_type band_rows,
+                             size_type halo_rows ){
+    close();
+
+    int status;
+    if( (status = open_bmp_view( filename, &m_view )) != IS_SUCCESS ){
+      return status;
+    }
+
+    m_decoder = new bmp_decoder();
+
+    if( !init_decoder( m_view, conversion, m_decoder ) ){
+      close();
+      return IS_TYPE_INVALID;
+    }
+
+    m_band_rows = (band_rows ? band_rows : 1);
+    m_halo_rows = halo_rows;
+    return IS_SUCCESS;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void BMP_Band_Reader::close(){
+    if( m_view.file ){
+      close_bmp_view( &m_view );
+    }
+    delete m_decoder;
+    delete m_band;
+
+    m_view.width  = 0;
+    m_view.height = 0;
+    m_decoder     = NULL;
+    m_band        = NULL;
+    m_band_first  = 0;
+    m_core_first  = 0;
+    m_core_rows   = 0;
+    m_next        = 0;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool BMP_Band_Reader::next(){
+    const size_type page_height = height();
+
+    if( !m_decoder || m_next >= page_height ){
+      return false;
+    }
+
+    // Core rows, and the halo around them clipped to the page
+    m_core_first = m_next;
+    m_core_rows  = std::min( m_band_rows, page_height - m_core_first );
+    m_band_first = m_core_first - std::min( m_halo_rows, m_core_first );
+    m_next       = m_core_first + m_core_rows;
+
+    const size_type band_last = std::min( page_height, m_next + m_halo_rows );
+    const size_type rows      = band_last - m_band_first;
+
+    // Only the first and last bands of a page differ in height
+    if( !m_band || m_band->height() != rows ){
+      delete m_band;
+      m_band = new Image( width(), rows );
+    }
+
+    decode_rows( *m_decoder, m_view, m_band_first, rows, m_band->ptr() );
+
+    //-------------------------------------------------------------------------
+
+    // Rows above the next band's halo will never be read again
+    const size_type done = (m_next < page_height)
+                         ? m_next - std::min( m_halo_rows, m_next )
+                         : page_height;
+
+    if( done > 0 ){
+      const ubyte*      top_row  = m_view.pixels;
+      const ubyte*      last_row = m_view.pixels + (std::ptrdiff_t) (done - 1) * m_view.stride;
+      const std::size_t row_size = (std::size_t) (m_view.stride < 0 ? -m_view.stride : m_view.stride);
+
+      // Bottom-up bitmaps store the top rows at the end of the file
+      const ubyte* first = (m_view.stride < 0) ? last_row : top_row;
+      m_view.file->release( first, done * row_size );
+    }
+
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  // Band Writer
+  //---------------------------------------------------------------------------
+
+  BMP_Band_Writer::BMP_Band_Writer()
+    : m_width(0),
+      m_height(0),
+      m_format(PC_COLOR)
+  {
+
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool BMP_Band_Writer::open( const char* filename,
+                              size_type width,
+                              size_type height,
+                              pixel_conversion format ){
+    if( m_file.is_open() ){
+      m_file.close();
+    }
+    m_file.clear();
+    m_file.open( filename, std::ios::out | std::ios::binary );
+
+    if(!m_file.is_open()){
+      return false;
+    }
+
+    m_width  = width;
+    m_height = height;
+    m_format = format;
+
+    write_bmp_headers( m_file, select_encoding( format, width ), width, height );
+
+    return m_file.good();
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool BMP_Band_Writer::write( const Image& band, size_type first ){
+    if( !m_file.is_open() || band.width() != m_width ||
+        first > m_height || band.height() > m_height - first ){
+      return false;
+    }
+
+    const bmp_encoding encoding = select_encoding( m_format, m_width );
+
+    // The band's rows are stored bottom-up, as one contiguous run that ends
+    // where the row above the band would start
+    const std::size_t offset = bmp_file_header_size + bmp_info_header_size +
+                               4 * encoding.colors +
+                               (m_height - first - band.height()) * encoding.row_size;
+
+    m_file.seekp( (std::streamoff) offset );
+    write_bmp_rows( m_file, encoding, band );
+
+    return m_file.good();
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool BMP_Band_Writer::close(){
+    if(!m_file.is_open()){
+      return false;
+    }
+    const bool good = m_file.good();
+    m_file.close();
+    return good;
+  }
+
+  //---------------------------------------------------------------------------
 
 }  // namespace ocr
 
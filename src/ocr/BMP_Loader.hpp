@@ -21,9 +21,17 @@
 # pragma once
 #endif
 
+#include "base_types.hpp"
+#include "Pixel_Image.hpp"
+
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <fstream> // std::fstream
+
 namespace ocr {
 
   class Image;
+  class Mapped_File;
+  struct bmp_decoder;
 
   typedef enum image_status_{
     IS_SUCCESS        = 0,
@@ -31,16 +39,399 @@ namespace ocr {
     IS_TYPE_INVALID   = 2
   } image_load_status;
 
+  typedef enum pixel_conversion_{
+    PC_COLOR,     ///< Keep the color of each pixel
+    PC_GRAYSCALE, ///< Average the channels of each pixel
+    PC_BINARY     ///< Only pure black pixels are ink; all others are background
+  } pixel_conversion;
+
+  ///
+  /// @struct ocr::bmp_view
+  ///
+  /// @brief A view of the pixel rows of a bitmap, addressed in place inside
+  ///        a memory mapping of the file.
+  ///
+  /// Palettized rows are exposed as the packed indices stored in the file,
+  /// most significant bits first, along with the color table to look them
+  /// up in. Bitmaps are usually stored bottom-up; rather than reordering them,
+  /// @c pixels points at the top-most row and @c stride is negative, so that
+  /// row @c y always starts at <tt>pixels + y * stride</tt>.
+  ///
+  struct bmp_view{
+    const ubyte*   pixels; ///< The first byte of the top-most row
+    std::ptrdiff_t stride; ///< Byte offset from one row to the next one down
+    s32            width;  ///< Width of the bitmap in pixels
+    s32            height; ///< Height of the bitmap in pixels
+    u16            bpp;    ///< Bits per pixel of the stored rows (1, 4, 8, 24 or 32)
+    Mapped_File*   file;   ///< The mapping that owns the pixel data, if any
+
+    const ubyte*   palette;    ///< BGRX color table of 1, 4 and 8 bit bitmaps
+    u32            colors;     ///< Number of entries in the color table
+    u32            red_mask;   ///< Mask of the red bits of a 32 bit pixel
+    u32            green_mask; ///< Mask of the green bits of a 32 bit pixel
+    u32            blue_mask;  ///< Mask of the blue bits of a 32 bit pixel
+  };
+
+  ///
+  /// @brief Maps a bitmap file and exposes its rows without copying them
+  ///
+  /// @param filename the path to the bitmap
+  /// @param view     the view to populate
+  /// @return the status of the load (an image_load_status)
+  ///
+  int open_bmp_view( const char* filename, bmp_view* view );
+
+  ///
+  /// @brief Exposes the rows of a bitmap already held in memory
+  ///
+  /// The view points into @p data, which must outlive it; closing the view
+  /// releases nothing.
+  ///
+  /// @param data the bytes of the bitmap file
+  /// @param size the number of bytes at @p data
+  /// @param view the view to populate
+  /// @return the status of the load (an image_load_status)
+  ///
+  int open_bmp_view( const ubyte* data, std::size_t size, bmp_view* view );
+
+  ///
+  /// @brief Releases the mapping held by a view opened by open_bmp_view
+  ///
+  /// @param view the view to close
+  ///
+  void close_bmp_view( bmp_view* view );
+
   int load_bmp_image_color( const char* filename, Image** image );
 
   int load_bmp_image_grayscale( const char* filename, Image** image );
 
   int load_bmp_image_binary( const char* filename, Image** image );
 
-  bool save_bmp_image( const char* filename, Image* image );
+  ///
+  /// @brief Loads a bitmap held in memory, such as one received over a socket
+  ///
+  /// @param data  the bytes of the bitmap file
+  /// @param size  the number of bytes at @p data
+  /// @param image the image to create
+  /// @return the status of the load (an image_load_status)
+  ///
+  int load_bmp_image_color( const ubyte* data, std::size_t size, Image** image );
+
+  int load_bmp_image_grayscale( const ubyte* data, std::size_t size, Image** image );
+
+  int load_bmp_image_binary( const ubyte* data, std::size_t size, Image** image );
+
+  ///
+  /// @brief Loads a bitmap as one byte of gray per pixel
+  ///
+  /// @param filename the path to the bitmap
+  /// @param image    the image to create
+  /// @return the status of the load (an image_load_status)
+  ///
+  int load_bmp_image_grayscale( const char* filename, Gray_Image** image );
+
+  int load_bmp_image_grayscale( const ubyte* data, std::size_t size, Gray_Image** image );
+
+  ///
+  /// @brief Loads a bitmap as one packed bit per pixel, where only pure
+  ///        black is ink
+  ///
+  /// @param filename the path to the bitmap
+  /// @param image    the image to create
+  /// @return the status of the load (an image_load_status)
+  ///
+  int load_bmp_image_binary( const char* filename, Binary_Image** image );
+
+  int load_bmp_image_binary( const ubyte* data, std::size_t size, Binary_Image** image );
+
+  ///
+  /// @brief Saves an image as an uncompressed bitmap
+  ///
+  /// @p format picks the layout written: PC_COLOR writes 24 bit pixels,
+  /// PC_GRAYSCALE an 8 bit gray ramp of the averaged channels, and PC_BINARY
+  /// 1 bit black/white pixels where only pure black is ink. Loading the file
+  /// back with the matching loader gives the same image as converting the
+  /// original.
+  ///
+  /// @param filename the path to the bitmap
+  /// @param image    the image to save
+  /// @param format   the conversion that decides the bitmap's layout
+  /// @return true if the bitmap was written
+  ///
+  bool save_bmp_image( const char* filename,
+                       Image* image,
+                       pixel_conversion format = PC_COLOR );
+
+  ///
+  /// @brief Writes an image as an uncompressed bitmap to a stream
+  ///
+  /// @param stream the stream to write the bitmap file to
+  /// @param image  the image to save
+  /// @param format the conversion that decides the bitmap's layout
+  /// @return true if the stream is still good once the bitmap is written
+  ///
+  bool save_bmp_image( std::ostream& stream,
+                       const Image& image,
+                       pixel_conversion format = PC_COLOR );
+
+  ///
+  /// @brief Saves a grayscale image as an 8 bit bitmap
+  ///
+  bool save_bmp_image( const char* filename, const Gray_Image& image );
+
+  bool save_bmp_image( std::ostream& stream, const Gray_Image& image );
+
+  ///
+  /// @brief Saves a binary image as a 1 bit black/white bitmap
+  ///
+  bool save_bmp_image( const char* filename, const Binary_Image& image );
+
+  bool save_bmp_image( std::ostream& stream, const Binary_Image& image );
 
   void destroy_image( Image** image );
 
+  void destroy_image( Gray_Image** image );
+
+  void destroy_image( Binary_Image** image );
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::BMP_Band_Reader
+  ///
+  /// @brief Reads a bitmap as a sequence of fixed-height bands of rows, so
+  ///        that only one band of the page is ever decoded at a time.
+  ///
+  /// Each band holds up to @c band_rows "core" rows, plus up to @c halo_rows
+  /// rows of context above and below them for operations that read
+  /// neighbouring rows (convolution, labeling). Halo rows are clipped at the
+  /// top and bottom of the page, so a page no taller than one band is read
+  /// as a single band that is identical to the whole image.
+  ///
+  /// Rows that no later band needs are released from the mapping as the
+  /// reader advances, so peak memory is bounded by the band size rather
+  /// than the page size.
+  /////////////////////////////////////////////////////////////////////////////
+  class BMP_Band_Reader  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::size_t size_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    BMP_Band_Reader();
+
+    ~BMP_Band_Reader();
+
+    //-------------------------------------------------------------------------
+    // Reading
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Opens a bitmap to be read in bands
+    ///
+    /// @param filename   the path to the bitmap
+    /// @param conversion the conversion to apply to every pixel
+    /// @param band_rows  the number of core rows in each band (at least 1)
+    /// @param halo_rows  the number of context rows above and below the core
+    /// @return the status of the load (an image_load_status)
+    ///
+    int open( const char* filename,
+              pixel_conversion conversion,
+              size_type band_rows,
+              size_type halo_rows = 0 );
+
+    ///
+    /// @brief Closes the bitmap and frees the band
+    ///
+    void close();
+
+    ///
+    /// @brief Decodes the next band of the page
+    ///
+    /// @return true if a band was read; false once the page is exhausted
+    ///
+    bool next();
+
+    //-------------------------------------------------------------------------
+    // Band Access
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns the current band, including its halo rows
+    ///
+    /// Row 0 of the band is row band_first() of the page.
+    ///
+    /// @return the current band
+    ///
+    const Image& band() const;
+    Image& band();
+
+    ///
+    /// @brief Returns the page row of the first row of the band
+    ///
+    size_type band_first() const;
+
+    ///
+    /// @brief Returns the page row of the first core row of the band
+    ///
+    size_type core_first() const;
+
+    ///
+    /// @brief Returns the band row of the first core row of the band
+    ///
+    size_type core_offset() const;
+
+    ///
+    /// @brief Returns the number of core rows in the band
+    ///
+    size_type core_rows() const;
+
+    ///
+    /// @brief Returns the width of the page in pixels
+    ///
+    size_type width() const;
+
+    ///
+    /// @brief Returns the height of the page in pixels
+    ///
+    size_type height() const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    BMP_Band_Reader( const BMP_Band_Reader& );
+    BMP_Band_Reader& operator = ( const BMP_Band_Reader& );
+
+    bmp_view     m_view;       ///< The mapped bitmap
+    bmp_decoder* m_decoder;    ///< The decoder for the bitmap's rows
+    Image*       m_band;       ///< The current band
+    size_type    m_band_rows;  ///< Core rows per band
+    size_type    m_halo_rows;  ///< Context rows above and below the core
+    size_type    m_band_first; ///< Page row of the first row of the band
+    size_type    m_core_first; ///< Page row of the first core row
+    size_type    m_core_rows;  ///< Number of core rows in the band
+    size_type    m_next;       ///< Page row of the next band's first core row
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::BMP_Band_Writer
+  ///
+  /// @brief Writes a bitmap a band of rows at a time, in any order.
+  ///
+  /// The file is laid out up front from the page size, so each band is
+  /// written straight to where its rows belong; the output is identical to
+  /// what save_bmp_image writes for the whole page in the same format.
+  /////////////////////////////////////////////////////////////////////////////
+  class BMP_Band_Writer  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::size_t size_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor
+    //-------------------------------------------------------------------------
+  public:
+
+    BMP_Band_Writer();
+
+    //-------------------------------------------------------------------------
+    // Writing
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Creates the bitmap and writes its headers
+    ///
+    /// @param filename the path to the bitmap
+    /// @param width    the width of the page in pixels
+    /// @param height   the height of the page in pixels
+    /// @param format   the layout to write, as for save_bmp_image
+    /// @return true if the file was created
+    ///
+    bool open( const char* filename,
+               size_type width,
+               size_type height,
+               pixel_conversion format = PC_COLOR );
+
+    ///
+    /// @brief Writes every row of @p band as the page rows starting at
+    ///        @p first
+    ///
+    /// @param band  the rows to write; must be as wide as the page
+    /// @param first the page row of the first row of the band
+    /// @return true if the rows were written
+    ///
+    bool write( const Image& band, size_type first );
+
+    ///
+    /// @brief Closes the bitmap
+    ///
+    /// @return true if every row was written successfully
+    ///
+    bool close();
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    std::fstream     m_file;   ///< The bitmap being written
+    size_type        m_width;  ///< Width of the page in pixels
+    size_type        m_height; ///< Height of the page in pixels
+    pixel_conversion m_format; ///< The layout being written
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline const Image& BMP_Band_Reader::band() const{
+    return *m_band;
+  }
+
+  inline Image& BMP_Band_Reader::band(){
+    return *m_band;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::band_first() const{
+    return m_band_first;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::core_first() const{
+    return m_core_first;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::core_offset() const{
+    return m_core_first - m_band_first;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::core_rows() const{
+    return m_core_rows;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::width() const{
+    return m_view.width;
+  }
+
+  inline BMP_Band_Reader::size_type BMP_Band_Reader::height() const{
+    return m_view.height;
+  }
+
 }  // namespace ocr
 
 
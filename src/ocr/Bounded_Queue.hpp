@@ -0,0 +1,193 @@
+/**
+ * @file Bounded_Queue.hpp
+ *
+ * @brief This header defines a fixed-capacity, lock-free queue for handing
+ *        work from one thread to another.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Bounded_Queue.hpp created
+ */
+#ifndef OCR_BOUNDED_QUEUE_HPP_
+#define OCR_BOUNDED_QUEUE_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include <atomic>  // std::atomic
+#include <chrono>  // std::chrono
+#include <cstddef> // std::size_t
+#include <thread>  // std::this_thread
+#include <vector>  // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Bounded_Queue
+  ///
+  /// @brief A ring buffer passing values from exactly one producer thread to
+  ///        exactly one consumer thread without locks
+  ///
+  /// The producer only ever writes @c m_tail and the consumer only ever
+  /// writes @c m_head, so each side publishes its progress with a single
+  /// release store. A full queue makes push() wait, which holds a fast
+  /// producer back to the pace of its consumer.
+  ///
+  /// @tparam T the type of the values; must be cheap to copy
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class Bounded_Queue  {
+
+    //-------------------------------------------------------------------------
+    // Constructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a queue that holds at most @p capacity values
+    ///
+    /// @param capacity the number of values held before push() waits
+    ///
+    explicit Bounded_Queue( std::size_t capacity );
+
+    //-------------------------------------------------------------------------
+    // Producer
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Adds a value if there is room for it
+    ///
+    /// @param value the value to add
+    /// @return true if the value was added
+    ///
+    bool try_push( const T& value );
+
+    ///
+    /// @brief Adds a value, waiting for room if the queue is full
+    ///
+    /// @param value the value to add
+    ///
+    void push( const T& value );
+
+    //-------------------------------------------------------------------------
+    // Consumer
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Removes the oldest value if there is one
+    ///
+    /// @param value receives the removed value
+    /// @return true if a value was removed
+    ///
+    bool try_pop( T& value );
+
+    ///
+    /// @brief Removes the oldest value, waiting for one if the queue is empty
+    ///
+    /// @return the removed value
+    ///
+    T pop();
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    Bounded_Queue( const Bounded_Queue& );
+    Bounded_Queue& operator = ( const Bounded_Queue& );
+
+    static void backoff( unsigned& attempts );
+
+    std::vector<T>           m_slots; ///< One more slot than the capacity
+    std::atomic<std::size_t> m_head;  ///< Next slot to pop; written by the consumer
+    std::atomic<std::size_t> m_tail;  ///< Next slot to push; written by the producer
+  };
+
+  //---------------------------------------------------------------------------
+  // Definitions
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  Bounded_Queue<T>::Bounded_Queue( std::size_t capacity )
+    : m_slots( (capacity ? capacity : 1) + 1 ),
+      m_head(0),
+      m_tail(0)
+  {
+
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  bool Bounded_Queue<T>::try_push( const T& value ){
+    const std::size_t tail = m_tail.load( std::memory_order_relaxed );
+    const std::size_t next = (tail + 1 == m_slots.size()) ? 0 : tail + 1;
+
+    if( next == m_head.load( std::memory_order_acquire ) ){
+      return false;
+    }
+    m_slots[tail] = value;
+    m_tail.store( next, std::memory_order_release );
+    return true;
+  }
+
+  template<typename T>
+  void Bounded_Queue<T>::push( const T& value ){
+    unsigned attempts = 0;
+    while( !try_push( value ) ){
+      backoff( attempts );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  bool Bounded_Queue<T>::try_pop( T& value ){
+    const std::size_t head = m_head.load( std::memory_order_relaxed );
+
+    if( head == m_tail.load( std::memory_order_acquire ) ){
+      return false;
+    }
+    value = m_slots[head];
+    m_head.store( (head + 1 == m_slots.size()) ? 0 : head + 1, std::memory_order_release );
+    return true;
+  }
+
+  template<typename T>
+  T Bounded_Queue<T>::pop(){
+    T value;
+    unsigned attempts = 0;
+    while( !try_pop( value ) ){
+      backoff( attempts );
+    }
+    return value;
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  void Bounded_Queue<T>::backoff( unsigned& attempts ){
+    // Stages run for milliseconds per page, so after a short spin it is
+    // cheaper to give the core away than to keep polling
+    if( attempts < 64 ){
+      ++attempts;
+      std::this_thread::yield();
+    }else{
+      std::this_thread::sleep_for( std::chrono::microseconds(100) );
+    }
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_BOUNDED_QUEUE_HPP_ */
@@ -0,0 +1,191 @@
+/**
+ * @file Buffer_Pool.cpp
+ *
+ * @brief This source defines the buffer pool.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Buffer_Pool.cpp created
+ * - A full pool evicts its least recently released buffers
+ */
+#include "Buffer_Pool.hpp"
+
+#include <cstdint> // std::uintptr_t
+#include <cstdlib> // std::malloc, std::free
+#include <new>     // std::bad_alloc
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Aligned Allocation
+  //---------------------------------------------------------------------------
+
+  //
+  // The pointer returned by malloc is kept just before the aligned block, so
+  // that the block can be freed without knowing its alignment.
+  //
+
+  static ubyte* allocate_aligned( std::size_t bytes, std::size_t alignment ){
+    if( alignment < sizeof(void*) ){
+      alignment = sizeof(void*);
+    }
+
+    void* raw = std::malloc( bytes + alignment + sizeof(void*) );
+    if( !raw ){
+      throw std::bad_alloc();
+    }
+
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>( raw ) + sizeof(void*);
+    start = (start + alignment - 1) & ~(std::uintptr_t) (alignment - 1);
+
+    ubyte* buffer = reinterpret_cast<ubyte*>( start );
+    reinterpret_cast<void**>( buffer )[-1] = raw;
+
+    return buffer;
+  }
+
+  static void free_aligned( ubyte* buffer ){
+    std::free( reinterpret_cast<void**>( buffer )[-1] );
+  }
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor
+  //---------------------------------------------------------------------------
+
+  Buffer_Pool::Buffer_Pool( std::size_t capacity )
+    : m_cached(0),
+      m_capacity(capacity),
+      m_allocations(0),
+      m_reuses(0)
+  {
+
+  }
+
+  Buffer_Pool::~Buffer_Pool(){
+    clear();
+  }
+
+  //---------------------------------------------------------------------------
+  // Buffers
+  //---------------------------------------------------------------------------
+
+  ubyte* Buffer_Pool::acquire( std::size_t bytes, std::size_t alignment ){
+    if( bytes < MIN_POOLED_SIZE ){
+      return allocate_aligned( bytes, alignment );
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+
+      // The most recently released buffer of a size is the likeliest to
+      // still be cached
+      free_map::iterator iter = m_free.upper_bound( key_type( bytes, alignment ) );
+      if( iter != m_free.begin() && (--iter)->first == key_type( bytes, alignment ) ){
+        ubyte* buffer = iter->second->second;
+
+        m_released.erase( iter->second );
+        m_free.erase( iter );
+        m_cached -= bytes;
+        ++m_reuses;
+        return buffer;
+      }
+      ++m_allocations;
+    }
+    return allocate_aligned( bytes, alignment );
+  }
+
+  void Buffer_Pool::release( ubyte* buffer, std::size_t bytes, std::size_t alignment ){
+    if( !buffer ){
+      return;
+    }
+    if( bytes >= MIN_POOLED_SIZE ){
+      std::lock_guard<std::mutex> lock( m_mutex );
+
+      if( bytes <= m_capacity ){
+        trim( m_capacity - bytes );
+
+        const key_type key( bytes, alignment );
+        m_released.push_back( lru_list::value_type( key, buffer ) );
+        m_free.insert( free_map::value_type( key, --m_released.end() ) );
+        m_cached += bytes;
+        return;
+      }
+    }
+    free_aligned( buffer );
+  }
+
+  void Buffer_Pool::clear(){
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    trim( 0 );
+  }
+
+  //---------------------------------------------------------------------------
+  // Capacity
+  //---------------------------------------------------------------------------
+
+  void Buffer_Pool::set_capacity( std::size_t capacity ){
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_capacity = capacity;
+    trim( capacity );
+  }
+
+  std::size_t Buffer_Pool::capacity() const{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_capacity;
+  }
+
+  std::size_t Buffer_Pool::cached() const{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_cached;
+  }
+
+  std::size_t Buffer_Pool::allocations() const{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_allocations;
+  }
+
+  std::size_t Buffer_Pool::reuses() const{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_reuses;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Buffer_Pool::trim( std::size_t capacity ){
+    // The buffers released least recently go first; their sizes are the
+    // likeliest to have fallen out of use
+    while( m_cached > capacity && !m_released.empty() ){
+      const lru_list::iterator oldest = m_released.begin();
+
+      free_map::iterator iter = m_free.lower_bound( oldest->first );
+      while( iter->second != oldest ){
+        ++iter;
+      }
+
+      m_cached -= oldest->first.first;
+      free_aligned( oldest->second );
+      m_free.erase( iter );
+      m_released.erase( oldest );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Global Pool
+  //---------------------------------------------------------------------------
+
+  Buffer_Pool& Buffer_Pool::global(){
+    // Never destroyed, so that images outliving main can still be released
+    static Buffer_Pool* pool = new Buffer_Pool();
+    return *pool;
+  }
+
+}  // namespace ocr
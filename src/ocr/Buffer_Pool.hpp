@@ -0,0 +1,314 @@
+/**
+ * @file Buffer_Pool.hpp
+ *
+ * @brief This header defines a pool that recycles the large buffers behind
+ *        images and other per-page scratch memory.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Buffer_Pool.hpp created
+ * - A full pool evicts its least recently released buffers
+ * - Added Scratch_Buffer, for scratch drawn from the pool
+ */
+#ifndef OCR_BUFFER_POOL_HPP_
+#define OCR_BUFFER_POOL_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+#include "Image_Layout.hpp"
+
+#include <cstddef>     // std::size_t
+#include <list>        // std::list
+#include <map>         // std::multimap
+#include <memory>      // std::uninitialized_fill_n
+#include <mutex>       // std::mutex
+#include <new>         // placement new
+#include <type_traits> // std::is_trivial, std::is_trivially_destructible
+#include <utility>     // std::pair
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Buffer_Pool
+  ///
+  /// @brief Keeps released buffers, keyed by their size and alignment, to
+  ///        hand back out instead of allocating again
+  ///
+  /// Recognizing a page allocates the same handful of buffers as the page
+  /// before it: the decoded page, its binary image, the label map, the
+  /// filter buffers and the result. Once each size has been seen, a
+  /// recognizer drawing its buffers from a pool makes no large allocations
+  /// at all. Buffers smaller than MIN_POOLED_SIZE are not worth keeping
+  /// and go straight to the heap.
+  ///
+  /// A buffer released into a full pool evicts the buffers released least
+  /// recently until it fits, so that when the sizes in use change, such as
+  /// on a job of mixed page sizes, the pool comes to hold the new sizes
+  /// rather than the first ones it saw. Only a buffer larger than the
+  /// whole capacity is freed outright. The pool is safe to use from any
+  /// number of threads.
+  /////////////////////////////////////////////////////////////////////////////
+  class Buffer_Pool  {
+
+    //-------------------------------------------------------------------------
+    // Public Constants
+    //-------------------------------------------------------------------------
+  public:
+
+    static const std::size_t MIN_POOLED_SIZE  = 4096;
+    static const std::size_t DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a pool that keeps up to @p capacity bytes
+    ///
+    /// @param capacity the bytes of released buffers to keep
+    ///
+    explicit Buffer_Pool( std::size_t capacity = DEFAULT_CAPACITY );
+
+    ///
+    /// @brief Frees every buffer the pool is keeping
+    ///
+    /// Buffers still acquired must not be released after the pool is gone.
+    ///
+    ~Buffer_Pool();
+
+    //-------------------------------------------------------------------------
+    // Buffers
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns a buffer of @p bytes bytes, reusing a released one of
+    ///        the same size and alignment if the pool has one
+    ///
+    /// @param bytes     the size of the buffer
+    /// @param alignment the alignment of the buffer; a power of two
+    /// @return the buffer, whose contents are unspecified
+    ///
+    ubyte* acquire( std::size_t bytes, std::size_t alignment );
+
+    ///
+    /// @brief Returns a buffer to the pool, evicting the buffers released
+    ///        least recently if it would not otherwise fit
+    ///
+    /// @param buffer    the buffer from acquire; null is ignored
+    /// @param bytes     the size it was acquired with
+    /// @param alignment the alignment it was acquired with
+    ///
+    void release( ubyte* buffer, std::size_t bytes, std::size_t alignment );
+
+    ///
+    /// @brief Frees every buffer the pool is keeping
+    ///
+    void clear();
+
+    //-------------------------------------------------------------------------
+    // Capacity
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Sets the bytes of released buffers to keep, freeing buffers
+    ///        until the pool is within it
+    ///
+    void set_capacity( std::size_t capacity );
+
+    std::size_t capacity() const;
+
+    ///
+    /// @brief Returns the bytes of released buffers being kept
+    ///
+    std::size_t cached() const;
+
+    ///
+    /// @brief Returns the number of pooled-size buffers that had to be
+    ///        allocated, rather than reused
+    ///
+    std::size_t allocations() const;
+
+    ///
+    /// @brief Returns the number of buffers handed out again
+    ///
+    std::size_t reuses() const;
+
+    //-------------------------------------------------------------------------
+    // Global Pool
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns the pool that image storage is drawn from
+    ///
+    static Buffer_Pool& global();
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    Buffer_Pool( const Buffer_Pool& );
+    Buffer_Pool& operator = ( const Buffer_Pool& );
+
+    typedef std::pair<std::size_t,std::size_t>          key_type;  ///< (bytes, alignment)
+    typedef std::list<std::pair<key_type,ubyte*>>        lru_list;  ///< Oldest first
+    typedef std::multimap<key_type,lru_list::iterator>   free_map;
+
+    void trim( std::size_t capacity );
+
+    mutable std::mutex m_mutex;       ///< Guards every member below
+    lru_list           m_released;    ///< Released buffers, in release order
+    free_map           m_free;        ///< Released buffers, by size
+    std::size_t        m_cached;      ///< Bytes of released buffers
+    std::size_t        m_capacity;    ///< Most bytes of released buffers kept
+    std::size_t        m_allocations; ///< Pooled-size buffers allocated
+    std::size_t        m_reuses;      ///< Buffers handed out again
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Scratch_Buffer
+  ///
+  /// @brief An array drawn from the global pool for as long as it is in
+  ///        scope, in place of a std::vector used as scratch
+  ///
+  /// An operation on a tiled page runs once per tile, and a std::vector of
+  /// scratch in it would allocate and free on every tile; drawn from the
+  /// pool, the scratch is only allocated the first time each size is seen.
+  /// The values are default-initialized, so those of a trivial type are
+  /// unspecified until written.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class Scratch_Buffer  {
+
+    static_assert( std::is_trivially_destructible<T>::value,
+                   "Scratch_Buffer never destroys its values" );
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Draws an array of @p count values from the pool
+    ///
+    /// @param count the values in the array
+    ///
+    explicit Scratch_Buffer( std::size_t count );
+
+    ///
+    /// @brief Draws an array of @p count copies of @p value from the pool
+    ///
+    /// @param count the values in the array
+    /// @param value the value to copy
+    ///
+    Scratch_Buffer( std::size_t count, const T& value );
+
+    ///
+    /// @brief Returns the array to the pool
+    ///
+    ~Scratch_Buffer();
+
+    //-------------------------------------------------------------------------
+    // Element Access
+    //-------------------------------------------------------------------------
+  public:
+
+    T* data();
+
+    const T* data() const;
+
+    std::size_t size() const;
+
+    T& operator[]( std::size_t i );
+
+    const T& operator[]( std::size_t i ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    Scratch_Buffer( const Scratch_Buffer& );
+    Scratch_Buffer& operator = ( const Scratch_Buffer& );
+
+    static const std::size_t ALIGNMENT = (alignof(T) > VECTOR_ALIGNMENT) ? alignof(T) : VECTOR_ALIGNMENT;
+
+    T*          m_data; ///< The values
+    std::size_t m_size; ///< The number of values
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  inline Scratch_Buffer<T>::Scratch_Buffer( std::size_t count )
+    : m_data(reinterpret_cast<T*>( Buffer_Pool::global().acquire( count * sizeof(T), ALIGNMENT ) )),
+      m_size(count)
+  {
+    if( !std::is_trivial<T>::value ){
+      for( std::size_t i = 0; i < count; ++i ){
+        new (m_data + i) T();
+      }
+    }
+  }
+
+  template<typename T>
+  inline Scratch_Buffer<T>::Scratch_Buffer( std::size_t count, const T& value )
+    : m_data(reinterpret_cast<T*>( Buffer_Pool::global().acquire( count * sizeof(T), ALIGNMENT ) )),
+      m_size(count)
+  {
+    std::uninitialized_fill_n( m_data, count, value );
+  }
+
+  template<typename T>
+  inline Scratch_Buffer<T>::~Scratch_Buffer(){
+    Buffer_Pool::global().release( reinterpret_cast<ubyte*>( m_data ), m_size * sizeof(T), ALIGNMENT );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  inline T* Scratch_Buffer<T>::data(){
+    return m_data;
+  }
+
+  template<typename T>
+  inline const T* Scratch_Buffer<T>::data() const{
+    return m_data;
+  }
+
+  template<typename T>
+  inline std::size_t Scratch_Buffer<T>::size() const{
+    return m_size;
+  }
+
+  template<typename T>
+  inline T& Scratch_Buffer<T>::operator[]( std::size_t i ){
+    return m_data[i];
+  }
+
+  template<typename T>
+  inline const T& Scratch_Buffer<T>::operator[]( std::size_t i ) const{
+    return m_data[i];
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_BUFFER_POOL_HPP_ */
@@ -0,0 +1,278 @@
+/**
+ * @file FFT.cpp
+ *
+ * @brief This source defines the mixed-radix fast Fourier transform.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - FFT.cpp created
+ * - Columns are gathered a cache line of them at a time
+ */
+
+#include "FFT.hpp"
+#include "Traversal.hpp"
+
+#include <algorithm> // std::copy
+#include <cmath>     // std::cos, std::sin
+#include <utility>   // std::swap
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Constructor
+  //---------------------------------------------------------------------------
+
+  FFT::FFT( std::size_t size )
+    : m_size(size)
+  {
+    static const f64 TAU = 6.283185307179586476925286766559;
+
+    // Factor the size, radix 4 first as it is the cheapest per value
+    std::vector<std::size_t> radices;
+    std::size_t              rest = size;
+
+    while( rest % 4 == 0 ){ radices.push_back( 4 ); rest /= 4; }
+    while( rest % 2 == 0 ){ radices.push_back( 2 ); rest /= 2; }
+    for( std::size_t p = 3; p * p <= rest; p += 2 ){
+      while( rest % p == 0 ){ radices.push_back( p ); rest /= p; }
+    }
+    if( rest > 1 ){
+      radices.push_back( rest );
+    }
+
+    //-------------------------------------------------------------------------
+
+    std::size_t length = size;
+    for( std::size_t i = 0; i < radices.size(); ++i ){
+      stage s;
+      s.radix  = radices[i];
+      s.length = length;
+
+      const std::size_t m = length / s.radix;
+      s.twiddles.resize( m * s.radix );
+      for( std::size_t q = 0; q < m; ++q ){
+        for( std::size_t u = 0; u < s.radix; ++u ){
+          const f64 angle = -TAU * (f64) (q * u) / (f64) length;
+          s.twiddles[q * s.radix + u] = complex_type( std::cos( angle ), std::sin( angle ) );
+        }
+      }
+      s.roots.resize( s.radix );
+      for( std::size_t k = 0; k < s.radix; ++k ){
+        const f64 angle = -TAU * (f64) k / (f64) s.radix;
+        s.roots[k] = complex_type( std::cos( angle ), std::sin( angle ) );
+      }
+
+      m_stages.push_back( s );
+      length = m;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Transforms
+  //---------------------------------------------------------------------------
+
+  std::size_t FFT::fast_size( std::size_t n ){
+    for( std::size_t size = (n ? n : 1); ; ++size ){
+      std::size_t rest = size;
+      while( rest % 2 == 0 ){ rest /= 2; }
+      while( rest % 3 == 0 ){ rest /= 3; }
+      while( rest % 5 == 0 ){ rest /= 5; }
+      if( rest == 1 ){
+        return size;
+      }
+    }
+  }
+
+  std::size_t FFT::size() const{
+    return m_size;
+  }
+
+  //---------------------------------------------------------------------------
+
+  // The inverse transform is the forward transform with every root of unity
+  // conjugated
+  static inline FFT::complex_type turn( const FFT::complex_type& value,
+                                        const FFT::complex_type& root,
+                                        bool inverse ){
+    return fft_multiply( value, inverse ? std::conj( root ) : root );
+  }
+
+  //
+  // Each stage splits its length n into radix interleaved sequences of
+  // m = n / radix values, takes the radix-point DFT across them, and
+  // multiplies in the twiddle factors; the s sequences left by the stages
+  // before it are carried along side by side, at stride s. The values move
+  // between the data and the scratch at every stage, and end in order.
+  //
+  template<bool Inverse>
+  void FFT::transform( complex_type* data, complex_type* scratch ) const{
+    complex_type* x = data;
+    complex_type* y = scratch;
+    std::size_t   s = 1;
+
+    for( std::size_t st = 0; st < m_stages.size(); ++st ){
+      const std::size_t   radix = m_stages[st].radix;
+      const std::size_t   m     = m_stages[st].length / radix;
+      const std::size_t   step  = s * m;
+      const complex_type* w     = &m_stages[st].twiddles[0];
+      const complex_type* r     = &m_stages[st].roots[0];
+
+      for( std::size_t q = 0; q < m; ++q, w += radix ){
+        for( std::size_t k = 0; k < s; ++k ){
+          const complex_type* in  = x + k + s * q;
+          complex_type*       out = y + k + s * radix * q;
+
+          switch( radix ){
+
+          case 2:{
+            const complex_type a0 = in[0];
+            const complex_type a1 = in[step];
+
+            out[0] = a0 + a1;
+            out[s] = turn( a0 - a1, w[1], Inverse );
+            break;
+          }
+
+          //-------------------------------------------------------------------
+
+          case 4:{
+            const complex_type sum02  = in[0] + in[2 * step];
+            const complex_type diff02 = in[0] - in[2 * step];
+            const complex_type sum13  = in[step] + in[3 * step];
+            const complex_type diff   = in[step] - in[3 * step];
+
+            // The odd difference turned by -i, or by +i for the inverse
+            const complex_type diff13 = Inverse ? complex_type( -diff.imag(), diff.real() )
+                                                : complex_type( diff.imag(), -diff.real() );
+
+            out[0]     = sum02 + sum13;
+            out[s]     = turn( diff02 + diff13, w[1], Inverse );
+            out[2 * s] = turn( sum02 - sum13, w[2], Inverse );
+            out[3 * s] = turn( diff02 - diff13, w[3], Inverse );
+            break;
+          }
+
+          //-------------------------------------------------------------------
+
+          case 3:{
+            const complex_type r1   = Inverse ? std::conj( r[1] ) : r[1];
+            const complex_type sum  = in[step] + in[2 * step];
+            const complex_type diff = in[step] - in[2 * step];
+
+            // The sum's share, and the difference's turned by i
+            const complex_type even = in[0] + sum * r1.real();
+            const complex_type odd  = complex_type( -diff.imag(), diff.real() ) * r1.imag();
+
+            out[0]     = in[0] + sum;
+            out[s]     = turn( even + odd, w[1], Inverse );
+            out[2 * s] = turn( even - odd, w[2], Inverse );
+            break;
+          }
+
+          //-------------------------------------------------------------------
+
+          case 5:{
+            const complex_type r1     = Inverse ? std::conj( r[1] ) : r[1];
+            const complex_type r2     = Inverse ? std::conj( r[2] ) : r[2];
+            const complex_type sum14  = in[step] + in[4 * step];
+            const complex_type diff14 = in[step] - in[4 * step];
+            const complex_type sum23  = in[2 * step] + in[3 * step];
+            const complex_type diff23 = in[2 * step] - in[3 * step];
+
+            // The roots pair off as conjugates, so the sums take their real
+            // parts and the differences, turned by i, their imaginary parts
+            const complex_type even1 = in[0] + sum14 * r1.real() + sum23 * r2.real();
+            const complex_type even2 = in[0] + sum14 * r2.real() + sum23 * r1.real();
+            const complex_type turn1 = diff14 * r1.imag() + diff23 * r2.imag();
+            const complex_type turn2 = diff14 * r2.imag() - diff23 * r1.imag();
+            const complex_type odd1  = complex_type( -turn1.imag(), turn1.real() );
+            const complex_type odd2  = complex_type( -turn2.imag(), turn2.real() );
+
+            out[0]     = in[0] + sum14 + sum23;
+            out[s]     = turn( even1 + odd1, w[1], Inverse );
+            out[2 * s] = turn( even2 + odd2, w[2], Inverse );
+            out[3 * s] = turn( even2 - odd2, w[3], Inverse );
+            out[4 * s] = turn( even1 - odd1, w[4], Inverse );
+            break;
+          }
+
+          //-------------------------------------------------------------------
+
+          default:{
+            for( std::size_t u = 0; u < radix; ++u ){
+              complex_type sum = in[0];
+              for( std::size_t t = 1; t < radix; ++t ){
+                sum += turn( in[t * step], r[(t * u) % radix], Inverse );
+              }
+              out[u * s] = turn( sum, w[u], Inverse );
+            }
+            break;
+          }
+          }
+        }
+      }
+
+      std::swap( x, y );
+      s *= radix;
+    }
+
+    if( x != data ){
+      std::copy( x, x + m_size, data );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  void FFT::forward( complex_type* data, complex_type* scratch ) const{
+    transform<false>( data, scratch );
+  }
+
+  void FFT::inverse( complex_type* data, complex_type* scratch ) const{
+    transform<true>( data, scratch );
+  }
+
+  //---------------------------------------------------------------------------
+  // 2-D Transforms
+  //---------------------------------------------------------------------------
+
+  std::size_t fft_2d_scratch( const FFT& rows, const FFT& columns ){
+    return rows.size() + (column_block<FFT::complex_type>() + 1) * columns.size();
+  }
+
+  void fft_2d( const FFT& rows,
+               const FFT& columns,
+               FFT::complex_type* data,
+               FFT::complex_type* scratch,
+               bool inverse ){
+    const std::size_t width  = rows.size();
+    const std::size_t height = columns.size();
+
+    FFT::complex_type* column_scratch = scratch + width;
+    FFT::complex_type* gathered       = column_scratch + height;
+
+    for( std::size_t y = 0; y < height; ++y ){
+      if( inverse ){
+        rows.inverse( data + y * width, scratch );
+      }else{
+        rows.forward( data + y * width, scratch );
+      }
+    }
+
+    // Each column is gathered to be transformed contiguously
+    for_each_column( data, width, height, width, gathered, [&]( FFT::complex_type* column, std::size_t ){
+      if( inverse ){
+        columns.inverse( column, column_scratch );
+      }else{
+        columns.forward( column, column_scratch );
+      }
+    } );
+  }
+
+} // namespace ocr
@@ -0,0 +1,199 @@
+/**
+ * @file FFT.hpp
+ *
+ * @brief This header defines a self-contained mixed-radix fast Fourier
+ *        transform, for convolving images with large kernels.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - FFT.hpp created
+ * - fft_2d() sizes its own scratch
+ */
+#ifndef OCR_FFT_HPP_
+#define OCR_FFT_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+
+#include <complex> // std::complex
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::FFT
+  ///
+  /// @brief A plan for the discrete Fourier transform of one length
+  ///
+  /// The length is factored into radices of 4, 2, 3 and 5, and then any
+  /// other primes, and the transform is computed one radix at a time by
+  /// Stockham's self-sorting algorithm, which needs no bit-reversal pass.
+  /// Lengths with only the factors 2, 3 and 5, such as fast_size() picks,
+  /// run in O(n log n); any other prime factor p costs O(n p).
+  ///
+  /// A plan is immutable once built, so one plan may transform on several
+  /// threads at once, each with its own scratch.
+  /////////////////////////////////////////////////////////////////////////////
+  class FFT  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::complex<f64> complex_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Plans transforms of @p size values
+    ///
+    /// @param size the length of the transform; at least 1
+    ///
+    explicit FFT( std::size_t size );
+
+    //-------------------------------------------------------------------------
+    // Transforms
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns the smallest length of at least @p n with no prime
+    ///        factors other than 2, 3 and 5
+    ///
+    static std::size_t fast_size( std::size_t n );
+
+    ///
+    /// @brief Returns the length of the transform
+    ///
+    std::size_t size() const;
+
+    ///
+    /// @brief Transforms @p data in place, with exp(-2 pi i jk / n)
+    ///
+    /// @param data    the size() values to transform
+    /// @param scratch size() values of scratch
+    ///
+    void forward( complex_type* data, complex_type* scratch ) const;
+
+    ///
+    /// @brief Transforms @p data in place, with exp(+2 pi i jk / n)
+    ///
+    /// The result is not divided by size(), so a forward transform followed
+    /// by an inverse one multiplies the values by size().
+    ///
+    /// @param data    the size() values to transform
+    /// @param scratch size() values of scratch
+    ///
+    void inverse( complex_type* data, complex_type* scratch ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Member Types
+    //-------------------------------------------------------------------------
+  private:
+
+    ///
+    /// @struct stage
+    ///
+    /// @brief One radix of the transform, and its twiddle factors
+    ///
+    struct stage{
+      std::size_t radix;                 ///< The radix of this stage
+      std::size_t length;                ///< The length transformed by it
+      std::vector<complex_type> twiddles; ///< length / radix by radix factors
+      std::vector<complex_type> roots;    ///< The radix roots of unity
+    };
+
+    //-------------------------------------------------------------------------
+    // Private Methods
+    //-------------------------------------------------------------------------
+  private:
+
+    ///
+    /// @brief Runs every stage over @p data, conjugating the roots of unity
+    ///        for the @p Inverse transform
+    ///
+    template<bool Inverse>
+    void transform( complex_type* data, complex_type* scratch ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    std::size_t        m_size;   ///< The length of the transform
+    std::vector<stage> m_stages; ///< The radices, in the order applied
+  };
+
+  //---------------------------------------------------------------------------
+  // 2-D Transforms
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Returns the values of scratch that fft_2d() needs
+  ///
+  /// The columns are gathered a cache line of them at a time, so the
+  /// scratch holds that many columns as well as a row.
+  ///
+  /// @param rows    the plan for each row
+  /// @param columns the plan for each column
+  ///
+  std::size_t fft_2d_scratch( const FFT& rows, const FFT& columns );
+
+  ///
+  /// @brief Transforms the rows, and then the columns, of a row-major array
+  ///        of @p rows.size() columns and @p columns.size() rows
+  ///
+  /// @param rows    the plan for each row
+  /// @param columns the plan for each column
+  /// @param data    the array to transform in place
+  /// @param scratch fft_2d_scratch() values of scratch
+  /// @param inverse whether to take the inverse transform
+  ///
+  void fft_2d( const FFT& rows,
+               const FFT& columns,
+               FFT::complex_type* data,
+               FFT::complex_type* scratch,
+               bool inverse );
+
+  ///
+  /// @brief Multiplies @p lhs by @p rhs
+  ///
+  /// std::complex multiplies through a library call that recovers infinite
+  /// and NaN products, unless built with -fcx-limited-range; the values
+  /// transformed here are always finite, so the product is written out.
+  ///
+  /// @param lhs the left value
+  /// @param rhs the right value
+  /// @return the product
+  ///
+  FFT::complex_type fft_multiply( const FFT::complex_type& lhs,
+                                  const FFT::complex_type& rhs );
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline FFT::complex_type fft_multiply( const FFT::complex_type& lhs,
+                                         const FFT::complex_type& rhs ){
+    return FFT::complex_type( lhs.real() * rhs.real() - lhs.imag() * rhs.imag(),
+                              lhs.real() * rhs.imag() + lhs.imag() * rhs.real() );
+  }
+
+} // namespace ocr
+
+#endif /* OCR_FFT_HPP_ */
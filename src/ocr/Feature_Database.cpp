@@ -13,30 +13,313 @@
  *
  * Nov 21, 2015: 
  * - Feature_Database.cpp created
+ *
+ * Oct 17, 2026:
+ * - Classes with an empty glyph are rejected on load
+ * - Header and class fields are copied in and out rather than type punned
  */
 #include "Feature_Database.hpp"
+#include "Mapped_File.hpp"
 
-#include <cmath> // std::floor
-#include <list>  // std::list
+#include <algorithm> // std::min
+#include <cmath>     // std::floor
+#include <cstring>   // std::memcmp, std::memcpy
+#include <fstream>   // std::ofstream
+#include <list>      // std::list
 
 namespace ocr {
 
+  //---------------------------------------------------------------------------
+  // Binary Format
+  //---------------------------------------------------------------------------
+
+  static const ubyte       fdb_magic[8]      = { 'O','C','R','-','F','D','B','\0' };
+  static const u32         fdb_version       = 1;
+  static const std::size_t fdb_header_size   = 64;
+  static const std::size_t fdb_class_size    = 24;
+  static const std::size_t fdb_alignment     = 64; ///< Alignment of the vector rows, in bytes
+  static const std::size_t fdb_row_alignment = fdb_alignment / sizeof(f32);
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Returns the number of bytes in each packed row of a glyph
+  ///
+  static inline std::size_t glyph_row_bytes( std::size_t width ){
+    return (width + 7) / 8;
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Reads a little-endian field of type @p T at any alignment
+  ///
+  template<typename T>
+  static inline T read_field( const ubyte* buffer ){
+    T value;
+    std::memcpy( &value, buffer, sizeof(T) );
+    return value;
+  }
+
+  ///
+  /// @brief Writes a little-endian field of type @p T at any alignment
+  ///
+  template<typename T>
+  static inline void write_field( ubyte* buffer, T value ){
+    std::memcpy( buffer, &value, sizeof(T) );
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Rounds @p value up to a multiple of @p multiple
+  ///
+  static inline std::size_t round_up( std::size_t value, std::size_t multiple ){
+    return ((value + multiple - 1) / multiple) * multiple;
+  }
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor
+  //---------------------------------------------------------------------------
+
   Feature_Database::Feature_Database(){}
 
+  Feature_Database::~Feature_Database(){
+    for( std::size_t i = 0; i < m_files.size(); ++i ){
+      delete m_files[i];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Access
+  //---------------------------------------------------------------------------
+
   Feature_Database& Feature_Database::insert( const Image& glyph, feature_collection& features ){
-    cluster result = std::make_pair( glyph, features );
+    return insert( glyph.view(), features );
+  }
+
+  Feature_Database& Feature_Database::insert( const Image::const_view_type& glyph, feature_collection& features ){
+    const std::size_t width     = glyph.width();
+    const std::size_t height    = glyph.height();
+    const std::size_t row_bytes = glyph_row_bytes( width );
+    const std::size_t length    = features.empty() ? 0 : features.front().size();
+
+    // Pack the glyph, one bit per pixel
+    m_owned_glyphs.push_back( std::vector<ubyte>( row_bytes * height + 1, 0 ) );
+    std::vector<ubyte>& bits = m_owned_glyphs.back();
 
-    m_clusters.push_back( result );
+    for( std::size_t y = 0; y < height; ++y ){
+      for( std::size_t x = 0; x < width; ++x ){
+        if( glyph.row( y )[x].r == 0 ){
+          bits[y * row_bytes + x / 8] |= (ubyte) (0x80 >> (x % 8));
+        }
+      }
+    }
+
+    // Copy the vectors into one contiguous matrix
+    m_owned_vectors.push_back( std::vector<f32>( features.size() * length + 1, 0.0f ) );
+    std::vector<f32>& matrix = m_owned_vectors.back();
+
+    for( std::size_t i = 0; i < features.size(); ++i ){
+      const Feature_Vector& vector = features[i];
+      for( std::size_t j = 0; j < length && j < vector.size(); ++j ){
+        matrix[i * length + j] = (f32) vector[j];
+      }
+    }
+
+    glyph_class entry;
+    entry.glyph_width  = width;
+    entry.glyph_height = height;
+    entry.glyph        = &bits[0];
+    entry.vectors      = &matrix[0];
+    entry.count        = features.size();
+    entry.length       = length;
+    entry.stride       = length;
+
+    m_classes.push_back( entry );
 
     return (*this);
   }
 
-  void Feature_Database::analyze( Image& image,
-                                  boundary_collection& bounds,
-                                  feature_collection& features )
+  //---------------------------------------------------------------------------
+
+  bool Feature_Database::load( const char* filename ){
+    Mapped_File* file = new Mapped_File();
+
+    if(!file->open( filename )){
+      delete file;
+      return false;
+    }
+
+    const ubyte*      buffer = file->data();
+    const std::size_t size   = file->size();
+
+    if( size < fdb_header_size ||
+        std::memcmp( buffer, fdb_magic, sizeof(fdb_magic) ) != 0 ||
+        read_field<u32>( buffer + 0x08 ) != fdb_version ){
+      delete file;
+      return false;
+    }
+
+    const std::size_t class_count   = read_field<u32>( buffer + 0x0C );
+    const std::size_t length        = read_field<u32>( buffer + 0x10 );
+    const std::size_t stride        = read_field<u32>( buffer + 0x14 );
+    const std::size_t vector_count  = read_field<u32>( buffer + 0x18 );
+    const std::size_t class_offset  = read_field<u32>( buffer + 0x1C );
+    const std::size_t glyph_offset  = read_field<u32>( buffer + 0x20 );
+    const std::size_t vector_offset = read_field<u32>( buffer + 0x24 );
+
+    // Ensure every section is inside the file, and the vectors are aligned
+    // for f32 access (the mapping itself starts on a page boundary)
+    if( stride < length ||
+        class_offset > size || (size - class_offset) / fdb_class_size < class_count ||
+        glyph_offset > size ||
+        vector_offset > size || (vector_offset % sizeof(f32)) != 0 ||
+        (stride && (size - vector_offset) / (stride * sizeof(f32)) < vector_count) ){
+      delete file;
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+
+    const f32* matrix = (const f32*) (buffer + vector_offset);
+
+    std::vector<glyph_class> classes;
+    classes.reserve( class_count );
+
+    for( std::size_t i = 0; i < class_count; ++i ){
+      const ubyte* entry = buffer + class_offset + i * fdb_class_size;
+
+      const std::size_t width  = read_field<u32>( entry + 0x00 );
+      const std::size_t height = read_field<u32>( entry + 0x04 );
+      const std::size_t glyph  = read_field<u32>( entry + 0x08 );
+      const std::size_t first  = read_field<u32>( entry + 0x0C );
+      const std::size_t count  = read_field<u32>( entry + 0x10 );
+
+      const std::size_t glyph_size = glyph_row_bytes( width ) * height;
+
+      // A glyph of no pixels would point at the end of the file, which
+      // analyze() still reads
+      if( width == 0 || height == 0 ||
+          glyph > size - glyph_offset || glyph_size > size - glyph_offset - glyph ||
+          first > vector_count || count > vector_count - first ){
+        delete file;
+        return false;
+      }
+
+      glyph_class result;
+      result.glyph_width  = width;
+      result.glyph_height = height;
+      result.glyph        = buffer + glyph_offset + glyph;
+      result.vectors      = matrix + first * stride;
+      result.count        = count;
+      result.length       = length;
+      result.stride       = stride;
+
+      classes.push_back( result );
+    }
+
+    m_classes.insert( m_classes.end(), classes.begin(), classes.end() );
+    m_files.push_back( file );
+
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Feature_Database::save( const char* filename ) const{
+
+    // All of the vectors are rows of one matrix, so they must share a length
+    const std::size_t length = m_classes.empty() ? 0 : m_classes.front().length;
+    std::size_t vector_count = 0;
+    std::size_t glyph_size   = 0;
+
+    for( std::size_t i = 0; i < m_classes.size(); ++i ){
+      if( m_classes[i].length != length && m_classes[i].count ){
+        return false;
+      }
+      vector_count += m_classes[i].count;
+      glyph_size   += glyph_row_bytes( m_classes[i].glyph_width ) * m_classes[i].glyph_height;
+    }
+
+    const std::size_t stride        = round_up( length, fdb_row_alignment );
+    const std::size_t class_offset  = fdb_header_size;
+    const std::size_t glyph_offset  = class_offset + m_classes.size() * fdb_class_size;
+    const std::size_t vector_offset = round_up( glyph_offset + glyph_size, fdb_alignment );
+
+    std::ofstream file( filename, std::ios::out | std::ios::binary );
+    if(!file.good()){
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+
+    ubyte header[fdb_header_size] = {};
+
+    std::memcpy( header, fdb_magic, sizeof(fdb_magic) );
+    write_field<u32>( header + 0x08, fdb_version );
+    write_field<u32>( header + 0x0C, (u32) m_classes.size() );
+    write_field<u32>( header + 0x10, (u32) length );
+    write_field<u32>( header + 0x14, (u32) stride );
+    write_field<u32>( header + 0x18, (u32) vector_count );
+    write_field<u32>( header + 0x1C, (u32) class_offset );
+    write_field<u32>( header + 0x20, (u32) glyph_offset );
+    write_field<u32>( header + 0x24, (u32) vector_offset );
+
+    file.write( (char*) header, sizeof(header) );
+
+    // Class table
+    std::size_t glyph = 0;
+    std::size_t first = 0;
+
+    for( std::size_t i = 0; i < m_classes.size(); ++i ){
+      const glyph_class& c = m_classes[i];
+      ubyte entry[fdb_class_size] = {};
+
+      write_field<u32>( entry + 0x00, (u32) c.glyph_width );
+      write_field<u32>( entry + 0x04, (u32) c.glyph_height );
+      write_field<u32>( entry + 0x08, (u32) glyph );
+      write_field<u32>( entry + 0x0C, (u32) first );
+      write_field<u32>( entry + 0x10, (u32) c.count );
+
+      file.write( (char*) entry, sizeof(entry) );
+
+      glyph += glyph_row_bytes( c.glyph_width ) * c.glyph_height;
+      first += c.count;
+    }
+
+    // Glyphs, followed by padding up to the aligned vectors
+    for( std::size_t i = 0; i < m_classes.size(); ++i ){
+      const glyph_class& c = m_classes[i];
+      file.write( (const char*) c.glyph, glyph_row_bytes( c.glyph_width ) * c.glyph_height );
+    }
+
+    const char padding[fdb_alignment] = {};
+    file.write( padding, vector_offset - (glyph_offset + glyph_size) );
+
+    // Vectors, each padded out to the row stride
+    std::vector<f32> row( stride, 0.0f );
+
+    for( std::size_t i = 0; i < m_classes.size(); ++i ){
+      const glyph_class& c = m_classes[i];
+
+      for( std::size_t j = 0; j < c.count; ++j ){
+        std::copy( c.vectors + j * c.stride, c.vectors + j * c.stride + length, row.begin() );
+        file.write( (const char*) &row[0], stride * sizeof(f32) );
+      }
+    }
+
+    return file.good();
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Feature_Database::analyze( Binary_Image& image,
+                                  const boundary_collection& bounds,
+                                  const feature_collection& features ) const
   {
-    feature_collection::iterator  feature_iter = features.begin();
-    boundary_collection::iterator bounds_iter  = bounds.begin();
+    feature_collection::const_iterator  feature_iter = features.begin();
+    boundary_collection::const_iterator bounds_iter  = bounds.begin();
 
     //------------------------------------------------------------------------
     // Find most likely comparison
@@ -49,18 +332,25 @@ namespace ocr {
     // Iterate through all features
     for( ; feature_iter != features.end(); ++feature_iter ){
 
-      cluster* min_cluster    = &m_clusters.front();
+      const Feature_Vector& feature = *feature_iter;
 
       min_list minimums;
 
-      for( std::size_t i =0; i < m_clusters.size() ; ++i ){
+      for( std::size_t i =0; i < m_classes.size() ; ++i ){
 
-        cluster& clust = m_clusters[i];
+        const glyph_class& clust  = m_classes[i];
+        const std::size_t  length = std::min( clust.length, feature.size() );
 
-        for( Feature_Vector& vec : clust.second ){
+        for( std::size_t v = 0; v < clust.count; ++v ){
 
-          Feature_Vector difference = (vec - (*feature_iter));
-          double diff = difference.magnitude();
+          const f32* vec = clust.vectors + v * clust.stride;
+
+          // Squared distance between the vectors
+          double diff = 0.0;
+          for( std::size_t k = 0; k < length; ++k ){
+            const double d = vec[k] - feature[k];
+            diff += d * d;
+          }
 
           // Record the minimal location if the list is empty, or if the difference is less
           if( minimums.empty() ){
@@ -87,7 +377,7 @@ namespace ocr {
 
       std::vector<size_t> most_common;
       // Initialize vector as 0
-      for( std::size_t i = 0; i < m_clusters.size(); ++i ){
+      for( std::size_t i = 0; i < m_classes.size(); ++i ){
         most_common.push_back(0);
       }
       // count most common
@@ -106,16 +396,17 @@ namespace ocr {
         }
       }
 
-      min_cluster = &m_clusters[minimal_entry_index];
+      const glyph_class* min_cluster = &m_classes[minimal_entry_index];
 
       //------------------------------------------------------------------------
       // Stretch the output glyph
       //------------------------------------------------------------------------
 
       // Data for stretching the output glyph
-      Image& glyph             = min_cluster->first;
-      const std::size_t from_height = glyph.height();
-      const std::size_t from_width  = glyph.width();
+      const ubyte*      glyph       = min_cluster->glyph;
+      const std::size_t row_bytes   = glyph_row_bytes( min_cluster->glyph_width );
+      const std::size_t from_height = min_cluster->glyph_height;
+      const std::size_t from_width  = min_cluster->glyph_width;
       const std::size_t to_height   = bounds_iter->bottom - bounds_iter->top + 1;
       const std::size_t to_width    = bounds_iter->right  - bounds_iter->left + 1;
 
@@ -132,8 +423,12 @@ namespace ocr {
           int x_out = x + bounds_iter->left - 1;
           int y_out = y + bounds_iter->top  - 1;
 
-          if( glyph.at_binary(x_in, y_in) ){
-            image.set_binary( x_out, y_out, 1 );
+          // Glyphs touching the page's first row or column start just off it
+          if( x_out < 0 || y_out < 0 ){
+            continue;
+          }
+          if( (glyph[y_in * row_bytes + x_in / 8] >> (7 - x_in % 8)) & 1 ){
+            image.set( x_out, y_out, 1 );
           }
         }
       }
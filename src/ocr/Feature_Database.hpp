@@ -21,27 +21,46 @@
 # pragma once
 #endif
 
+#include "base_types.hpp"
 #include "Feature_Vector.hpp"
 #include "Feature_Loader.hpp"
 #include "Image.hpp"
+#include "Pixel_Image.hpp"
 
-#include <utility> // std::pair
+#include <list>    // std::list
 #include <vector>  // std::vector
 #include <cstddef> // std::size_t
 
 
 namespace ocr {
 
+  class Mapped_File;
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Feature_Database
+  ///
+  /// @brief A set of glyph classes, each with the reference feature vectors
+  ///        that identify it
+  ///
+  /// Each class's vectors are rows of a contiguous matrix of floats. Classes
+  /// added with insert() own a copy of their data; classes loaded from a
+  /// binary database (*.fdbx) point straight into the mapped file, so
+  /// loading one involves no parsing or copying of the vectors at all.
+  ///
+  /// The binary format is little-endian:
+  ///
+  ///   header      64 bytes: magic "OCR-FDB\0", version, class count,
+  ///               vector length, row stride, vector count and the offsets
+  ///               of the three sections below
+  ///   classes     24 bytes per class: glyph width and height, glyph offset,
+  ///               first vector and vector count
+  ///   glyphs      1 bit per pixel, most significant bit first, each row
+  ///               padded to a whole byte; a set bit is ink
+  ///   vectors     32-bit floats, one row of @c stride floats per vector;
+  ///               the section and every row start on a 64 byte boundary
+  /////////////////////////////////////////////////////////////////////////////
   class Feature_Database  {
 
-    //------------------------------------------------------------------------
-    // Public Types
-    //------------------------------------------------------------------------
-  public:
-
-    typedef std::pair<Image, feature_collection> cluster;
-    typedef std::vector<cluster>                 cluster_collection;
-
     //------------------------------------------------------------------------
     // Constructor / Destructor
     //------------------------------------------------------------------------
@@ -49,11 +68,16 @@ namespace ocr {
 
     Feature_Database( );
 
+    ~Feature_Database( );
+
     //------------------------------------------------------------------------
     // Capacity
     //------------------------------------------------------------------------
   public:
 
+    ///
+    /// @brief Returns the number of glyph classes in the database
+    ///
     std::size_t size() const;
 
     //------------------------------------------------------------------------
@@ -64,21 +88,80 @@ namespace ocr {
     Feature_Database& insert( const Image& data, feature_collection& vector );
 
     ///
+    /// @brief Adds the glyph in @p data, such as a glyph's bounding box
+    ///        within a page, without copying it out first
     ///
+    Feature_Database& insert( const Image::const_view_type& data, feature_collection& vector );
+
+    ///
+    /// @brief Maps a binary database file and adds its classes
+    ///
+    /// The file stays mapped for as long as the database exists.
+    ///
+    /// @param filename the path to the binary database (*.fdbx)
+    /// @return true if the file was a valid binary database
     ///
-    void analyze( Image& image, boundary_collection& bounds, feature_collection& features );
+    bool load( const char* filename );
+
+    ///
+    /// @brief Writes every class of the database as a binary database
+    ///
+    /// @param filename the path to write to
+    /// @return false if the file could not be written, or the classes do
+    ///         not share one vector length
+    ///
+    bool save( const char* filename ) const;
+
+    ///
+    /// @brief Draws the closest class's glyph over each feature's boundary
+    ///
+    /// The database is only read, so any number of threads may analyze
+    /// against one database at once.
+    ///
+    /// @param image    the image to draw the recognized glyphs onto
+    /// @param bounds   the boundary of each feature, in image coordinates
+    /// @param features the features to recognize
+    ///
+    void analyze( Binary_Image& image,
+                  const boundary_collection& bounds,
+                  const feature_collection& features ) const;
+
+    //-----------------------------------------------------------------------------
+    // Private Types
+    //-----------------------------------------------------------------------------
+  private:
+
+    ///
+    /// @brief A glyph class, addressed in place in owned or mapped storage
+    ///
+    struct glyph_class{
+      std::size_t  glyph_width;  ///< Width of the glyph in pixels
+      std::size_t  glyph_height; ///< Height of the glyph in pixels
+      const ubyte* glyph;        ///< Packed glyph rows, 1 bit per pixel
+      const f32*   vectors;      ///< The first feature vector
+      std::size_t  count;        ///< Number of feature vectors
+      std::size_t  length;       ///< Components in each feature vector
+      std::size_t  stride;       ///< Floats from one vector to the next
+    };
 
     //-----------------------------------------------------------------------------
     // Private Members
     //-----------------------------------------------------------------------------
   private:
 
-    cluster_collection m_clusters;
+    // Not copyable
+    Feature_Database( const Feature_Database& );
+    Feature_Database& operator = ( const Feature_Database& );
+
+    std::vector<glyph_class>        m_classes;        ///< Every class, in insertion order
+    std::list<std::vector<ubyte> >  m_owned_glyphs;   ///< Glyphs of inserted classes
+    std::list<std::vector<f32> >    m_owned_vectors;  ///< Vectors of inserted classes
+    std::vector<Mapped_File*>       m_files;          ///< Mapped binary databases
 
   };
 
   inline std::size_t Feature_Database::size() const{
-    return m_clusters.size();
+    return m_classes.size();
   }
 
 }  // namespace ocr
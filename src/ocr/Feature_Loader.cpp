@@ -13,9 +13,13 @@
  *
  * Nov 17, 2015: 
  * - Feature_Loader.cpp created
+ *
+ * Oct 17, 2026:
+ * - The label map is one block drawn from the image storage pool
  */
 
 #include "Feature_Loader.hpp"
+#include "Image_Layout.hpp"
 
 #include <ostream> // std::ostream
 #include <cmath>   // std::floor
@@ -35,11 +39,27 @@ namespace ocr {
   // 2D Allocations
   //--------------------------------------------------------------------------
 
+  //
+  // A 2D array is one block from the image storage pool: the table of row
+  // pointers, followed by the rows. A page the same size as the last one
+  // reuses its block.
+  //
+
+  template<typename T>
+  inline std::size_t bytes_2d( std::size_t rows, std::size_t cols ){
+    return rows * sizeof(T*) + rows * cols * sizeof(T);
+  }
+
+  //--------------------------------------------------------------------------
+
   template<typename T>
   inline T** new_2d( std::size_t rows, std::size_t cols ){
-    T** result = new T*[rows];
+    ubyte* block = allocate_image_storage( bytes_2d<T>( rows, cols ), sizeof(T*) );
+
+    T** result = reinterpret_cast<T**>( block );
+    T*  cells  = reinterpret_cast<T*>( block + rows * sizeof(T*) );
     for( std::size_t i = 0; i < rows; ++i ){
-      result[i] = new T[cols];
+      result[i] = cells + i * cols;
     }
     return result;
   }
@@ -47,18 +67,34 @@ namespace ocr {
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline void delete_2d( T** ptr, std::size_t rows ){
-    for( std::size_t i = 0; i < rows; ++i ){
-      delete[] ptr[i];
-    }
-    delete [] ptr;
+  inline void delete_2d( T** ptr, std::size_t rows, std::size_t cols ){
+    free_image_storage( reinterpret_cast<ubyte*>( ptr ), bytes_2d<T>( rows, cols ), sizeof(T*) );
+  }
+
+  //--------------------------------------------------------------------------
+  // Pixel Access
+  //--------------------------------------------------------------------------
+
+  //
+  // Labeling only asks whether a pixel is ink, so it runs unchanged on color
+  // images and on packed binary ones, which are 24 times smaller to scan.
+  // Callers check the coordinates first, so these read the rows directly.
+  //
+
+  inline bool is_ink( const Image& image, int x, int y ){
+    return image.row( y )[x].r == 0;
+  }
+
+  inline bool is_ink( const Binary_Image& image, int x, int y ){
+    return (image.row( y )[x >> 3] >> (7 - (x & 7))) & 1;
   }
 
   //--------------------------------------------------------------------------
   // Recursive Expansion
   //--------------------------------------------------------------------------
 
-  void expand_map_aux( int label, int** label_map, const Image& image, int row, int col, boundary& bounds ){
+  template<typename Image_Type>
+  void expand_map_aux( int label, int** label_map, const Image_Type& image, int row, int col, boundary& bounds ){
     // Stop condition 1: out of bounds
     if( row < 0 || col < 0){
       return;
@@ -68,7 +104,7 @@ namespace ocr {
     }
 
     // Stop condition 2: Pixel is 0
-    if(!image.at_binary(col,row)) // at (x,y)
+    if(!is_ink(image,col,row)) // at (x,y)
       return;
 
     // Stop condition 3: label map already labeled
@@ -109,7 +145,8 @@ namespace ocr {
 
   //--------------------------------------------------------------------------
 
-  boundary expand_map( int label, int** label_map, const Image& image, int row, int col ){
+  template<typename Image_Type>
+  boundary expand_map( int label, int** label_map, const Image_Type& image, int row, int col ){
     boundary bound;
     // Assign the boundary to just the first pixel coordinate
     bound.left   = col;
@@ -137,11 +174,22 @@ namespace ocr {
 
   //--------------------------------------------------------------------------
 
-  void load_features( const Image& image,
-                      feature_collection&  features,
-                      boundary_collection& bounds,
-                      std::size_t horizontal_divs,
-                      std::size_t vertical_divs ){
+  ///
+  /// @brief Labels the glyphs of an image and computes the features of those
+  ///        whose top row lies in the range [@p first_row, @p last_row)
+  ///
+  /// @param row_offset the page row of the image's first row; added to the
+  ///                   boundaries that are reported
+  ///
+  template<typename Image_Type>
+  static void load_features_in_rows( const Image_Type& image,
+                                     std::size_t row_offset,
+                                     std::size_t first_row,
+                                     std::size_t last_row,
+                                     feature_collection&  features,
+                                     boundary_collection& bounds,
+                                     std::size_t horizontal_divs,
+                                     std::size_t vertical_divs ){
 
     int** label_map = new_2d<int>( image.height(), image.width() );
 
@@ -154,16 +202,18 @@ namespace ocr {
 
     int label = 1;
 
+    boundary_collection labeled;
+
     // Iterate through all pixels, expanding any discovered regions
     for( std::size_t row = 0; row < image.height(); ++row ){
       for( std::size_t col = 0; col < image.width(); ++col ){
 
-        ubyte pix = image.at_binary(col,row); // x y
+        bool pix = is_ink(image,col,row); // x y
 
         // Only expand as a map if not already labeled
         if( pix && !label_map[row][col]){
           boundary b = expand_map( label++, label_map, image, (int) row, (int) col );
-          bounds.push_back(b);
+          labeled.push_back(b);
         }
       }
     }
@@ -171,8 +221,13 @@ namespace ocr {
     //------------------------------------------------------------------------
 
     // Analyze the discovered vectors
-    boundary_collection::iterator iter = bounds.begin();
-    for( int current_label = 1; iter != bounds.end(); ++iter, ++current_label ){
+    boundary_collection::iterator iter = labeled.begin();
+    for( int current_label = 1; iter != labeled.end(); ++iter, ++current_label ){
+
+      // Glyphs that start outside of the rows are reported by another band
+      if( iter->top < (int) first_row || iter->top >= (int) last_row ){
+        continue;
+      }
 
       Feature_Vector::feature_collection feat;
 
@@ -246,9 +301,48 @@ namespace ocr {
       }
 
       features.push_back( Feature_Vector( feat ) );
+
+      boundary b = *iter;
+      b.top    += (int) row_offset;
+      b.bottom += (int) row_offset;
+      bounds.push_back( b );
     }
 
-    delete_2d(label_map, image.height() );
+    delete_2d( label_map, image.height(), image.width() );
+  }
+
+  //--------------------------------------------------------------------------
+
+  void load_features( const Image& image,
+                      feature_collection&  features,
+                      boundary_collection& bounds,
+                      std::size_t horizontal_divs,
+                      std::size_t vertical_divs ){
+    load_features_in_rows( image, 0, 0, image.height(),
+                           features, bounds, horizontal_divs, vertical_divs );
+  }
+
+  void load_features( const Binary_Image& image,
+                      feature_collection&  features,
+                      boundary_collection& bounds,
+                      std::size_t horizontal_divs,
+                      std::size_t vertical_divs ){
+    load_features_in_rows( image, 0, 0, image.height(),
+                           features, bounds, horizontal_divs, vertical_divs );
+  }
+
+  //--------------------------------------------------------------------------
+
+  void load_band_features( const Image& band,
+                           std::size_t band_first,
+                           std::size_t core_offset,
+                           std::size_t core_rows,
+                           feature_collection&  features,
+                           boundary_collection& bounds,
+                           std::size_t horizontal_divs,
+                           std::size_t vertical_divs ){
+    load_features_in_rows( band, band_first, core_offset, core_offset + core_rows,
+                           features, bounds, horizontal_divs, vertical_divs );
   }
 
 
@@ -22,6 +22,7 @@
 #endif
 
 #include "Image.hpp"
+#include "Pixel_Image.hpp"
 #include "Feature_Vector.hpp"
 
 #include <vector>
@@ -49,6 +50,38 @@ namespace ocr {
                       std::size_t horizontal_divs = 10,
                       std::size_t vertical_divs   = 10 );
 
+  ///
+  /// @brief Loads the features of the glyphs of a packed binary image
+  ///
+  void load_features( const Binary_Image& image,
+                      feature_collection&  features,
+                      boundary_collection& bounds,
+                      std::size_t horizontal_divs = 10,
+                      std::size_t vertical_divs   = 10 );
+
+  ///
+  /// @brief Loads the features of the glyphs that start in the core rows of
+  ///        a band read by BMP_Band_Reader
+  ///
+  /// Each glyph is reported by the band whose core rows hold its top row,
+  /// with its boundary in page coordinates. A glyph is only measured whole
+  /// if it fits within the band's rows below its top, so the halo should be
+  /// at least as tall as the tallest glyph.
+  ///
+  /// @param band        the band, including its halo rows
+  /// @param band_first  the page row of the band's first row
+  /// @param core_offset the band row of the first core row
+  /// @param core_rows   the number of core rows
+  ///
+  void load_band_features( const Image& band,
+                           std::size_t band_first,
+                           std::size_t core_offset,
+                           std::size_t core_rows,
+                           feature_collection&  features,
+                           boundary_collection& bounds,
+                           std::size_t horizontal_divs = 10,
+                           std::size_t vertical_divs   = 10 );
+
 }  // namespace ocr
 
 
@@ -13,10 +13,15 @@
  *
  * Sep 23, 2015: 
  * - Image.cpp created
+ *
+ * Oct 17, 2026:
+ * - Added move, assignment and construction from a view
+ * - Element access moved inline into the header
+ * - Storage follows an image_layout
  */
 #include "Image.hpp"
 
-#include <algorithm> // std::copy
+#include <algorithm> // std::copy, std::fill, std::swap
 
 namespace ocr {
 
@@ -26,118 +31,113 @@ namespace ocr {
 
   Image::Image( size_type width, size_type height )
     : m_width(width),
-      m_height(height),
-      m_data( new pixel_type[width * height] )
+      m_height(height)
   {
-
+    allocate( packed_layout() );
   }
 
-  Image::Image( size_type width, size_type height, pixel_type* data )
-    :  m_width(width),
-      m_height(height),
-      m_data(data)
+  Image::Image( size_type width, size_type height, const image_layout& layout )
+    : m_width(width),
+      m_height(height)
   {
-
+    allocate( layout );
   }
 
   Image::Image( const Image& x )
-    :  m_width(x.width()),
-      m_height(x.height()),
-      m_data(new pixel_type[m_width*m_height])
+    : m_width(x.m_width),
+      m_height(x.m_height)
   {
-    std::copy( x.m_data, x.m_data + m_width*m_height, m_data );
-  }
+    allocate( image_layout( x.m_align, x.m_border ) );
 
-#ifdef OCR_COMPILER_HAS_CPP11_RVALUE
+    const pixel_type* from = reinterpret_cast<const pixel_type*>( x.m_storage );
+    std::copy( from, from + m_count, reinterpret_cast<pixel_type*>( m_storage ) );
+  }
 
   Image::Image( Image&& x )
     : m_width(x.m_width),
       m_height(x.m_height),
+      m_stride(x.m_stride),
+      m_border(x.m_border),
+      m_align(x.m_align),
+      m_count(x.m_count),
+      m_storage(x.m_storage),
       m_data(x.m_data)
   {
-    x.m_width = 0;
-    x.m_height = 0;
-    x.m_data = nullptr;
+    x.m_width   = 0;
+    x.m_height  = 0;
+    x.m_stride  = 0;
+    x.m_border  = 0;
+    x.m_count   = 0;
+    x.m_storage = nullptr;
+    x.m_data    = nullptr;
   }
 
-#endif
-
-  //---------------------------------------------------------------------------
+  Image::Image( const const_view_type& view )
+    : m_width(view.width()),
+      m_height(view.height())
+  {
+    allocate( packed_layout() );
 
-  Image::~Image(){
-    if(m_data){
-      delete [] m_data;
+    for( size_type y = 0; y < m_height; ++y ){
+      std::copy( view.row(y), view.row(y) + m_width, row(y) );
     }
   }
 
   //---------------------------------------------------------------------------
-  // Element Access
-  //---------------------------------------------------------------------------
-
-  Image::pixel_type Image::at( int x, int y ) const{
-    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
-
-      return pixel_type(255,255,255);
-    }else{
-      pixel_type* pixel = m_data + ((y * m_width) + x);
 
-      return *pixel;
-    }
+  Image::~Image(){
+    free_image_storage( m_storage, m_count * sizeof(pixel_type), m_align );
   }
 
-  ubyte Image::at_grayscale( int x, int y ) const{
-    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+  //---------------------------------------------------------------------------
 
-      return (ubyte) 255;
-    }else{
-      pixel_type* pixel = m_data + ((y * m_width) + x);
+  void Image::allocate( const image_layout& layout ){
+    const image_geometry geometry = compute_geometry( layout, sizeof(pixel_type), m_width, m_height );
 
-      return pixel->r; // assume all colors are the same intensity
-    }
+    m_stride  = geometry.stride;
+    m_border  = layout.border;
+    m_align   = layout.alignment;
+    m_count   = geometry.count;
+    m_storage = allocate_image_storage( m_count * sizeof(pixel_type), m_align );
+    m_data    = reinterpret_cast<pixel_type*>( m_storage ) + geometry.origin;
   }
 
-  ubyte Image::at_binary( int x, int y ) const{
-    ubyte pixel = this->at_grayscale(x,y);
-
-    return pixel == 0 ? 1 : 0;
-  }
+  //---------------------------------------------------------------------------
 
-  void Image::set( size_type x, size_type y, pixel_type value ){
-    pixel_type* pixel_start = m_data + ((y * m_width) + x);
-    pixel_start->r = value.r;
-    pixel_start->g = value.g;
-    pixel_start->b = value.b;
+  Image& Image::operator = ( Image x ){
+    swap( x );
+    return (*this);
   }
 
-  void Image::set_grayscale( std::size_t x, std::size_t y, ubyte value ){
-    pixel_type* pixel_start = m_data + ((y * m_width) + x);
-    pixel_start->r =
-    pixel_start->g =
-    pixel_start->b = value;
+  void Image::swap( Image& other ){
+    std::swap( m_width,   other.m_width );
+    std::swap( m_height,  other.m_height );
+    std::swap( m_stride,  other.m_stride );
+    std::swap( m_border,  other.m_border );
+    std::swap( m_align,   other.m_align );
+    std::swap( m_count,   other.m_count );
+    std::swap( m_storage, other.m_storage );
+    std::swap( m_data,    other.m_data );
   }
 
-  void Image::set_binary( std::size_t x, std::size_t y, ubyte value ){
-    pixel_type* pixel_start = m_data + ((y * m_width) + x);
-    pixel_start->r =
-    pixel_start->g =
-    pixel_start->b = (value == 0 ? 255 : 0);
-  }
+  //---------------------------------------------------------------------------
+  // Element Access
+  //---------------------------------------------------------------------------
 
   void Image::fill( pixel_type uniform ){
-    for( uint row = 0; row < height(); ++row ){
-      for( uint col = 0; col < width(); ++col ){
-        set(col, row, uniform);
-      }
+    for( size_type y = 0; y < m_height; ++y ){
+      std::fill( row(y), row(y) + m_width, uniform );
     }
   }
 
   void Image::fill_binary( ubyte uniform ){
-    for( uint row = 0; row < height(); ++row ){
-      for( uint col = 0; col < width(); ++col ){
-        set_binary(col, row, uniform);
-      }
-    }
+    const ubyte value = (uniform == 0 ? 255 : 0);
+
+    fill( pixel_type( value, value, value ) );
   }
 
+  void Image::fill_border( border_policy policy, pixel_type value ){
+    ocr::fill_border( m_data, m_width, m_height, m_stride, m_border, policy, value );
+  }
 
 }
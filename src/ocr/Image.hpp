@@ -13,6 +13,12 @@
  *
  * Sep 21, 2015: 
  * - Image.hpp created
+ *
+ * Oct 17, 2026:
+ * - Image is movable and assignable, and lends out views of its pixels
+ * - Element access is no longer virtual; added unchecked row access
+ * - Images may have aligned, padded rows and a border
+ * - Nothing derives from Image, so its members are private
  */
 #ifndef OCR_IMAGE_HPP_
 #define OCR_IMAGE_HPP_
@@ -23,6 +29,8 @@
 
 #include "base_types.hpp"
 #include "Color.hpp"
+#include "Image_Layout.hpp"
+#include "Image_View.hpp"
 
 #include <cstddef> // std::size_t
 
@@ -33,6 +41,15 @@ namespace ocr {
   ///
   /// @brief This object is an abstract representation of an image
   ///
+  /// None of the members are virtual, so pixel access inlines into the
+  /// loops that use it. at() checks its coordinates and reads white outside
+  /// of the image; row() and set() do not check, and are what inner loops
+  /// should use once the border has been dealt with.
+  ///
+  /// By default the rows are packed end to end. An image constructed with
+  /// an aligned layout (see image_layout) starts every row on a 64 byte
+  /// boundary, with stride() pixels from one row to the next, and may keep
+  /// a border of pixels around it that row() may index into.
   /////////////////////////////////////////////////////////////////////////////
   class Image  {
 
@@ -43,61 +60,72 @@ namespace ocr {
 
     typedef std::size_t size_type;
     typedef Color_RGB pixel_type;
+    typedef Image_View<pixel_type>       view_type;
+    typedef Image_View<const pixel_type> const_view_type;
 
     //-------------------------------------------------------------------------
-    // Private Constructor
+    // Constructor / Destructor / Assignment
     //-------------------------------------------------------------------------
   public:
 
     ///
-    /// @brief Constructs an image of the specified width and height with the
-    ///        specified data.
-    ///
-    /// This constructor is private so that it can only be accessed by the
-    /// friend class, Image_Loader.
+    /// @brief Constructs a blank image of the specified width and height.
     ///
     /// @param width  The width of the image
     /// @param height The height of the image
-    /// @param data   Pointer to the data to use for the image
     ///
-    Image( size_type width, size_type height, pixel_type* data );
-
-    //-------------------------------------------------------------------------
-    // Constructor / Destructor / Assignment
-    //-------------------------------------------------------------------------
-  public:
+    Image( size_type width, size_type height );
 
     ///
-    /// @brief Constructs a blank image of the specified width and height.
+    /// @brief Constructs a blank image with rows laid out as @p layout asks
     ///
     /// @param width  The width of the image
     /// @param height The height of the image
-    /// @param data   Pointer to the data to use for the image
+    /// @param layout The alignment and border of the rows
     ///
-    Image( size_type width, size_type height );
+    Image( size_type width, size_type height, const image_layout& layout );
 
     ///
     /// @brief Constructs an image by copying the data from @p x to @p this
     ///
+    /// The copy has the same layout as @p x, border included.
+    ///
     /// @param x the image to copy
     ///
     Image( const Image& x );
 
-#ifdef OCR_COMPILER_HAS_CPP11_RVALUE
-
     ///
-    /// @brief Cosntructs an image by moving the data from @p x to @p this
+    /// @brief Constructs an image by moving the data from @p x to @p this
     ///
     /// @param x the image to move
     ///
     Image( Image&& x );
 
-#endif
+    ///
+    /// @brief Constructs an image by copying the pixels of a view
+    ///
+    /// @param view the pixels to copy
+    ///
+    explicit Image( const const_view_type& view );
 
     ///
     /// @brief Destructor for the image object
     ///
-    virtual ~Image();
+    ~Image();
+
+    ///
+    /// @brief Assigns the data of @p x to @p this, copying or moving it
+    ///
+    /// @param x the image to assign
+    ///
+    Image& operator = ( Image x );
+
+    ///
+    /// @brief Swaps the data of @p this with @p other
+    ///
+    /// @param other the image to swap with
+    ///
+    void swap( Image& other );
 
     //-------------------------------------------------------------------------
     // Capacity
@@ -109,21 +137,42 @@ namespace ocr {
     ///
     /// @return the size of the image in bytes
     ///
-    virtual size_type size() const ;
+    size_type size() const ;
 
     ///
     /// @brief Return the width of this image in pixels
     ///
     /// @return the width of the image
     ///
-    virtual size_type width() const ;
+    size_type width() const ;
 
     ///
     /// @brief Return the height of this image in pixels
     ///
     /// @return the height of the image
     ///
-    virtual size_type height() const ;
+    size_type height() const ;
+
+    ///
+    /// @brief Return the number of pixels from the start of one row to the
+    ///        start of the next
+    ///
+    /// @return the stride of the image
+    ///
+    size_type stride() const ;
+
+    ///
+    /// @brief Return the number of pixels of border on each side
+    ///
+    /// @return the border of the image
+    ///
+    size_type border() const ;
+
+    ///
+    /// @brief Return whether the rows are packed end to end, so that ptr()
+    ///        addresses every pixel as one array
+    ///
+    bool packed() const ;
 
     //------------------------------------------------------------------------
     // Element Access
@@ -144,6 +193,18 @@ namespace ocr {
     ///
     const pixel_type* ptr() const ;
 
+    ///
+    /// @brief Returns a pointer to the first pixel of row @p y, which is
+    ///        not checked
+    ///
+    /// @param y the row
+    ///
+    /// @return pointer to the row
+    ///
+    pixel_type* row( size_type y );
+
+    const pixel_type* row( size_type y ) const;
+
     ///
     /// @brief Retrieve the pixel at the specified coordinates
     ///
@@ -152,7 +213,7 @@ namespace ocr {
     ///
     /// @return the color value of the specified pixel
     ///
-    virtual pixel_type at( int x, int y ) const;
+    pixel_type at( int x, int y ) const;
 
     ubyte at_grayscale( int x, int y ) const;
 
@@ -164,7 +225,7 @@ namespace ocr {
     /// @param x the x-coordinate to set the pixel
     /// @param y the y-coordinate to set the pixel
     ///
-    virtual void set( size_type x, size_type y, pixel_type value );
+    void set( size_type x, size_type y, pixel_type value );
 
     void set_grayscale( std::size_t x, std::size_t y, ubyte value );
 
@@ -175,18 +236,61 @@ namespace ocr {
     ///
     /// @param uniform the pixel to fill this image with.
     ///
-    virtual void fill( pixel_type uniform );
+    void fill( pixel_type uniform );
 
-    virtual void fill_binary( ubyte uniform );
+    void fill_binary( ubyte uniform );
+
+    ///
+    /// @brief Fills the border around this image
+    ///
+    /// Call once the image itself has been written, so that neighbourhood
+    /// operations can then read up to border() pixels past every edge.
+    ///
+    /// @param policy how to fill the border
+    /// @param value  the value of the border for border_constant
+    ///
+    void fill_border( border_policy policy, pixel_type value = pixel_type(255,255,255) );
+
+    //------------------------------------------------------------------------
+    // Views
+    //------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns a view of the whole image
+    ///
+    /// @return the view
+    ///
+    view_type view();
+
+    const_view_type view() const;
+
+    ///
+    /// @brief Returns a view of the rectangle at (@p x, @p y)
+    ///
+    /// The rectangle must lie within the image.
+    ///
+    /// @return the view
+    ///
+    view_type view( size_type x, size_type y, size_type width, size_type height );
+
+    const_view_type view( size_type x, size_type y, size_type width, size_type height ) const;
 
     //-------------------------------------------------------------------------
-    // Protected Members
+    // Private Members
     //-------------------------------------------------------------------------
-  protected:
-
-    size_type   m_width;  ///< Width of the image
-    size_type   m_height; ///< Height of the image
-    pixel_type* m_data;   ///< Bytestream of data
+  private:
+
+    void allocate( const image_layout& layout );
+
+    size_type   m_width;   ///< Width of the image
+    size_type   m_height;  ///< Height of the image
+    size_type   m_stride;  ///< Pixels from one row to the next
+    size_type   m_border;  ///< Pixels of border on each side
+    size_type   m_align;   ///< Byte alignment of the rows
+    size_type   m_count;   ///< Pixels of storage, border and padding included
+    ubyte*      m_storage; ///< The storage, border and padding included
+    pixel_type* m_data;    ///< The pixel at (0,0)
   };
 
   //---------------------------------------------------------------------------
@@ -201,6 +305,44 @@ namespace ocr {
     return m_data;
   }
 
+  inline Image::pixel_type* Image::row( size_type y ){
+    return m_data + y * m_stride;
+  }
+
+  inline const Image::pixel_type* Image::row( size_type y ) const{
+    return m_data + y * m_stride;
+  }
+
+  inline Image::pixel_type Image::at( int x, int y ) const{
+    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+      return pixel_type(255,255,255);
+    }
+    return m_data[y * m_stride + x];
+  }
+
+  inline ubyte Image::at_grayscale( int x, int y ) const{
+    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+      return (ubyte) 255;
+    }
+    return m_data[y * m_stride + x].r; // assume all colors are the same intensity
+  }
+
+  inline ubyte Image::at_binary( int x, int y ) const{
+    return at_grayscale(x,y) == 0 ? 1 : 0;
+  }
+
+  inline void Image::set( size_type x, size_type y, pixel_type value ){
+    m_data[y * m_stride + x] = value;
+  }
+
+  inline void Image::set_grayscale( std::size_t x, std::size_t y, ubyte value ){
+    m_data[y * m_stride + x] = pixel_type( value, value, value );
+  }
+
+  inline void Image::set_binary( std::size_t x, std::size_t y, ubyte value ){
+    set_grayscale( x, y, (value == 0 ? 255 : 0) );
+  }
+
   inline Image::size_type Image::size() const{
     return (m_width * m_height * sizeof(pixel_type));
   }
@@ -213,6 +355,34 @@ namespace ocr {
     return m_height;
   }
 
+  inline Image::size_type Image::stride() const{
+    return m_stride;
+  }
+
+  inline Image::size_type Image::border() const{
+    return m_border;
+  }
+
+  inline bool Image::packed() const{
+    return m_stride == m_width;
+  }
+
+  inline Image::view_type Image::view(){
+    return view_type( m_data, m_width, m_height, m_stride );
+  }
+
+  inline Image::const_view_type Image::view() const{
+    return const_view_type( m_data, m_width, m_height, m_stride );
+  }
+
+  inline Image::view_type Image::view( size_type x, size_type y, size_type width, size_type height ){
+    return view().sub( x, y, width, height );
+  }
+
+  inline Image::const_view_type Image::view( size_type x, size_type y, size_type width, size_type height ) const{
+    return view().sub( x, y, width, height );
+  }
+
 }  // namespace ocr
 
 #endif /* OCR_IMAGE_HPP_ */
@@ -0,0 +1,68 @@
+/**
+ * @file Image_Layout.cpp
+ *
+ * @brief This source defines the geometry and storage of image layouts.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Image_Layout.cpp created
+ * - Image storage is drawn from the global Buffer_Pool
+ */
+#include "Image_Layout.hpp"
+#include "Buffer_Pool.hpp"
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Geometry
+  //---------------------------------------------------------------------------
+
+  static std::size_t gcd( std::size_t a, std::size_t b ){
+    while( b ){
+      const std::size_t r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  }
+
+  static std::size_t round_up( std::size_t value, std::size_t multiple ){
+    return ((value + multiple - 1) / multiple) * multiple;
+  }
+
+  image_geometry compute_geometry( const image_layout& layout,
+                                   std::size_t pixel_size,
+                                   std::size_t width,
+                                   std::size_t height ){
+    // The fewest pixels that fill a whole number of alignment units
+    const std::size_t unit = layout.alignment / gcd( layout.alignment, pixel_size );
+
+    image_geometry geometry;
+    geometry.lead   = round_up( layout.border, unit );
+    geometry.stride = round_up( geometry.lead + width + layout.border, unit );
+    geometry.origin = layout.border * geometry.stride + geometry.lead;
+    geometry.count  = geometry.stride * (height + 2 * layout.border);
+
+    return geometry;
+  }
+
+  //---------------------------------------------------------------------------
+  // Storage
+  //---------------------------------------------------------------------------
+
+  ubyte* allocate_image_storage( std::size_t bytes, std::size_t alignment ){
+    return Buffer_Pool::global().acquire( bytes, alignment );
+  }
+
+  void free_image_storage( ubyte* storage, std::size_t bytes, std::size_t alignment ){
+    Buffer_Pool::global().release( storage, bytes, alignment );
+  }
+
+}  // namespace ocr
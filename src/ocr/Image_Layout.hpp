@@ -0,0 +1,218 @@
+/**
+ * @file Image_Layout.hpp
+ *
+ * @brief This header defines how the rows of an image are laid out in
+ *        memory: their alignment, their stride, and the border around them.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Image_Layout.hpp created
+ * - Image storage is drawn from the global Buffer_Pool
+ */
+#ifndef OCR_IMAGE_LAYOUT_HPP_
+#define OCR_IMAGE_LAYOUT_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+
+#include <cstddef> // std::size_t
+
+namespace ocr {
+
+  ///
+  /// @brief The alignment, in bytes, of the rows of an aligned image; the
+  ///        size of a cache line, and of the widest vector register
+  ///
+  const std::size_t VECTOR_ALIGNMENT = 64;
+
+  ///
+  /// @struct ocr::image_layout
+  ///
+  /// @brief Requests a layout for the rows of an image
+  ///
+  /// The default layout packs rows end to end with no border, so that the
+  /// pixels are one contiguous array. An aligned layout starts every row on
+  /// an @c alignment byte boundary and pads the stride to a multiple of it,
+  /// so vector loops can use aligned loads and run on into the padding
+  /// rather than stopping for the last few pixels. A border keeps @c border
+  /// pixels of addressable memory on every side of the image, so that a
+  /// neighbourhood operation can read past the edge without checking.
+  ///
+  struct image_layout{
+    std::size_t alignment; ///< Byte alignment of each row; 1 packs the rows
+    std::size_t border;    ///< Pixels of border on each side
+
+    image_layout();
+    image_layout( std::size_t alignment, std::size_t border );
+  };
+
+  ///
+  /// @brief Returns the layout of rows packed end to end, with no border
+  ///
+  image_layout packed_layout();
+
+  ///
+  /// @brief Returns the layout of rows aligned to VECTOR_ALIGNMENT
+  ///
+  /// @param border the pixels of border on each side
+  ///
+  image_layout aligned_layout( std::size_t border = 0 );
+
+  ///
+  /// @enum ocr::border_policy
+  ///
+  /// @brief How the border around an image is filled
+  ///
+  enum border_policy{
+    border_constant,  ///< Every border pixel has the same value
+    border_replicate  ///< Every border pixel copies the nearest edge pixel
+  };
+
+  ///
+  /// @struct ocr::image_geometry
+  ///
+  /// @brief Where the pixels of an image of a given layout lie in storage
+  ///
+  struct image_geometry{
+    std::size_t lead;   ///< Pixels in each row before column 0
+    std::size_t stride; ///< Pixels from the start of one row to the next
+    std::size_t origin; ///< Pixels from the start of storage to (0,0)
+    std::size_t count;  ///< Pixels of storage
+  };
+
+  ///
+  /// @brief Computes the geometry of an image
+  ///
+  /// @param layout     the requested layout
+  /// @param pixel_size the size of each pixel in bytes
+  /// @param width      the width of the image
+  /// @param height     the height of the image
+  /// @return the geometry
+  ///
+  image_geometry compute_geometry( const image_layout& layout,
+                                   std::size_t pixel_size,
+                                   std::size_t width,
+                                   std::size_t height );
+
+  ///
+  /// @brief Allocates storage for an image, aligned to @p alignment bytes
+  ///
+  /// Storage is drawn from Buffer_Pool::global(), so an image the same size
+  /// as one already freed reuses its storage.
+  ///
+  /// @param bytes     the size of the storage
+  /// @param alignment the alignment of the storage; a power of two
+  /// @return the storage, to be freed by free_image_storage
+  ///
+  ubyte* allocate_image_storage( std::size_t bytes, std::size_t alignment );
+
+  ///
+  /// @brief Frees storage from allocate_image_storage; null is ignored
+  ///
+  /// @param storage   the storage
+  /// @param bytes     the size it was allocated with
+  /// @param alignment the alignment it was allocated with
+  ///
+  void free_image_storage( ubyte* storage, std::size_t bytes, std::size_t alignment );
+
+  ///
+  /// @brief Fills the border around an image
+  ///
+  /// @param origin the pixel at (0,0)
+  /// @param width  the width of the image
+  /// @param height the height of the image
+  /// @param stride the pixels from the start of one row to the next
+  /// @param border the pixels of border on each side
+  /// @param policy how to fill the border
+  /// @param value  the value of the border for border_constant
+  ///
+  template<typename Pixel>
+  void fill_border( Pixel* origin,
+                    std::size_t width,
+                    std::size_t height,
+                    std::size_t stride,
+                    std::size_t border,
+                    border_policy policy,
+                    const Pixel& value );
+
+  //---------------------------------------------------------------------------
+  // Definitions
+  //---------------------------------------------------------------------------
+
+  inline image_layout::image_layout()
+    : alignment(1),
+      border(0)
+  {
+
+  }
+
+  inline image_layout::image_layout( std::size_t alignment, std::size_t border )
+    : alignment(alignment ? alignment : 1),
+      border(border)
+  {
+
+  }
+
+  inline image_layout packed_layout(){
+    return image_layout();
+  }
+
+  inline image_layout aligned_layout( std::size_t border ){
+    return image_layout( VECTOR_ALIGNMENT, border );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  void fill_border( Pixel* origin,
+                    std::size_t width,
+                    std::size_t height,
+                    std::size_t stride,
+                    std::size_t border,
+                    border_policy policy,
+                    const Pixel& value ){
+    if( border == 0 || width == 0 || height == 0 ){
+      return;
+    }
+
+    // The left and right of every row first, then whole rows above and below
+    for( std::size_t y = 0; y < height; ++y ){
+      Pixel* row = origin + y * stride;
+
+      const Pixel left  = (policy == border_replicate) ? row[0]         : value;
+      const Pixel right = (policy == border_replicate) ? row[width - 1] : value;
+
+      for( std::size_t b = 1; b <= border; ++b ){
+        *(row - b)             = left;
+        *(row + width + b - 1) = right;
+      }
+    }
+
+    const std::size_t span = width + 2 * border;
+    Pixel* first = origin - border;
+    Pixel* last  = origin + (height - 1) * stride - border;
+
+    for( std::size_t b = 1; b <= border; ++b ){
+      Pixel* above = first - b * stride;
+      Pixel* below = last  + b * stride;
+
+      for( std::size_t x = 0; x < span; ++x ){
+        above[x] = (policy == border_replicate) ? first[x] : value;
+        below[x] = (policy == border_replicate) ? last[x]  : value;
+      }
+    }
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_IMAGE_LAYOUT_HPP_ */
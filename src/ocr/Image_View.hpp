@@ -0,0 +1,253 @@
+/**
+ * @file Image_View.hpp
+ *
+ * @brief This header defines a non-owning view of the pixels of an image,
+ *        or of a rectangle within one.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Image_View.hpp created
+ */
+#ifndef OCR_IMAGE_VIEW_HPP_
+#define OCR_IMAGE_VIEW_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+#include "Color.hpp"
+
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::remove_const, std::is_convertible, std::enable_if
+
+namespace ocr {
+
+  ///
+  /// @struct ocr::Pixel_Traits
+  ///
+  /// @brief Describes a pixel format: the value read outside of an image
+  ///
+  template<typename Pixel>
+  struct Pixel_Traits;
+
+  template<>
+  struct Pixel_Traits<ubyte>{
+    static ubyte background(){ return 255; }
+  };
+
+  template<>
+  struct Pixel_Traits<Color_RGB>{
+    static Color_RGB background(){ return Color_RGB::WHITE; }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Image_View
+  ///
+  /// @brief A rectangle of pixels borrowed from an image
+  ///
+  /// A view is a pointer to its first pixel, its width and height, and the
+  /// stride (in pixels) between the starts of its rows. It owns nothing and
+  /// is cheap to copy, so a glyph's bounding box or the core rows of a band
+  /// can be handed to an operation without copying the pixels out of the
+  /// page. The view is only valid while the image it was taken from is.
+  ///
+  /// A view of const pixels reads only; a view of mutable pixels converts
+  /// to one.
+  ///
+  /// @tparam Pixel the type of each pixel, const qualified for reading only
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename Pixel>
+  class Image_View  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::size_t                             size_type;
+    typedef typename std::remove_const<Pixel>::type pixel_type;
+
+    //-------------------------------------------------------------------------
+    // Constructors
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs an empty view
+    ///
+    Image_View();
+
+    ///
+    /// @brief Constructs a view of @p height rows of @p width pixels
+    ///
+    /// @param data   the first pixel of the view
+    /// @param width  the width of the view
+    /// @param height the height of the view
+    /// @param stride the pixels from the start of one row to the next
+    ///
+    Image_View( Pixel* data, size_type width, size_type height, size_type stride );
+
+    ///
+    /// @brief Converts a view of mutable pixels to a view of const pixels
+    ///
+    template<typename Other>
+    Image_View( const Image_View<Other>& other,
+                typename std::enable_if<std::is_convertible<Other*,Pixel*>::value>::type* = 0 );
+
+    //-------------------------------------------------------------------------
+    // Capacity
+    //-------------------------------------------------------------------------
+  public:
+
+    size_type width() const;
+
+    size_type height() const;
+
+    size_type stride() const;
+
+    bool empty() const;
+
+    //-------------------------------------------------------------------------
+    // Element Access
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns the first pixel of the view
+    ///
+    Pixel* ptr() const;
+
+    ///
+    /// @brief Returns the first pixel of row @p y of the view
+    ///
+    Pixel* row( size_type y ) const;
+
+    ///
+    /// @brief Retrieve the pixel at the specified coordinates, or the
+    ///        background if they are outside of the view
+    ///
+    pixel_type at( int x, int y ) const;
+
+    ///
+    /// @brief Returns the view of the rectangle at (@p x, @p y) of this view
+    ///
+    /// The rectangle must lie within this view.
+    ///
+    /// @param x      the left column of the rectangle
+    /// @param y      the top row of the rectangle
+    /// @param width  the width of the rectangle
+    /// @param height the height of the rectangle
+    ///
+    Image_View sub( size_type x, size_type y, size_type width, size_type height ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    Pixel*    m_data;   ///< The first pixel of the view
+    size_type m_width;  ///< Width of the view
+    size_type m_height; ///< Height of the view
+    size_type m_stride; ///< Pixels from the start of one row to the next
+  };
+
+  //---------------------------------------------------------------------------
+  // Definitions
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline Image_View<Pixel>::Image_View()
+    : m_data(nullptr),
+      m_width(0),
+      m_height(0),
+      m_stride(0)
+  {
+
+  }
+
+  template<typename Pixel>
+  inline Image_View<Pixel>::Image_View( Pixel* data,
+                                        size_type width,
+                                        size_type height,
+                                        size_type stride )
+    : m_data(data),
+      m_width(width),
+      m_height(height),
+      m_stride(stride)
+  {
+
+  }
+
+  template<typename Pixel>
+  template<typename Other>
+  inline Image_View<Pixel>::Image_View( const Image_View<Other>& other,
+                                        typename std::enable_if<std::is_convertible<Other*,Pixel*>::value>::type* )
+    : m_data(other.ptr()),
+      m_width(other.width()),
+      m_height(other.height()),
+      m_stride(other.stride())
+  {
+
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline typename Image_View<Pixel>::size_type Image_View<Pixel>::width() const{
+    return m_width;
+  }
+
+  template<typename Pixel>
+  inline typename Image_View<Pixel>::size_type Image_View<Pixel>::height() const{
+    return m_height;
+  }
+
+  template<typename Pixel>
+  inline typename Image_View<Pixel>::size_type Image_View<Pixel>::stride() const{
+    return m_stride;
+  }
+
+  template<typename Pixel>
+  inline bool Image_View<Pixel>::empty() const{
+    return m_width == 0 || m_height == 0;
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline Pixel* Image_View<Pixel>::ptr() const{
+    return m_data;
+  }
+
+  template<typename Pixel>
+  inline Pixel* Image_View<Pixel>::row( size_type y ) const{
+    return m_data + y * m_stride;
+  }
+
+  template<typename Pixel>
+  inline typename Image_View<Pixel>::pixel_type Image_View<Pixel>::at( int x, int y ) const{
+    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+      return Pixel_Traits<pixel_type>::background();
+    }
+    return m_data[y * m_stride + x];
+  }
+
+  template<typename Pixel>
+  inline Image_View<Pixel> Image_View<Pixel>::sub( size_type x,
+                                                   size_type y,
+                                                   size_type width,
+                                                   size_type height ) const{
+    return Image_View( m_data + y * m_stride + x, width, height, m_stride );
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_IMAGE_VIEW_HPP_ */
@@ -13,12 +13,50 @@
  *
  * Sep 26, 2015: 
  * - Image_Operator.cpp created
+ *
+ * Oct 17, 2026:
+ * - Operations read from views and move their results out
+ * - Only the border ring goes through the edge handling
+ * - The kernel is flipped once, at construction
+ * - Separable kernels run as two 1-D passes
+ * - The interior runs through vectorized row primitives
+ * - Large images are operated on in tiles, across a thread pool
+ * - Chains run fused per tile, and may be pre-convolved into fewer kernels
+ * - Integer kernels run in 16-bit fixed point
+ * - 3x3, 5x5 and 7x7 fixed point kernels are unrolled for their size
+ * - Large kernels are convolved through the FFT
+ * - Box, box Gaussian and recursive Gaussian blurs, at any size
+ * - Grayscale images are operated on as a single plane
+ * - Interior scratch is drawn from the buffer pool
+ * - A tile that throws no longer unwinds past the workers still running
+ * - Blur scratch, the recursive blur's page included, is drawn from the buffer pool
+ * - The edge ring of a large kernel sums exactly, as the FFT interior does
  */
 
 #include "Kernel_Image_Operator.hpp"
+#include "Buffer_Pool.hpp"
+#include "FFT.hpp"
+#include "simd.hpp"
+
+#include <algorithm>          // std::min, std::fill
+#include <atomic>             // std::atomic
+#include <cmath>              // std::fabs, std::floor, std::sqrt, std::ceil
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // std::ptrdiff_t
+#include <cstdint>            // std::uint64_t
+#include <exception>          // std::exception_ptr
+#include <mutex>              // std::mutex
+#include <utility>            // std::move
+#include <vector>             // std::vector
 
 namespace ocr {
 
+  //---------------------------------------------------------------------------
+  // Public Constants
+  //---------------------------------------------------------------------------
+
+  const f32 Kernel_Image_Operator::SEPARABLE_TOLERANCE = 1e-5f;
+
   //---------------------------------------------------------------------------
   // Constructor / Destructor
   //---------------------------------------------------------------------------
@@ -28,7 +66,11 @@ namespace ocr {
     :  m_width(kernel[0].size()),
       m_height(kernel.size()),
       m_abs_sum(0),
-      m_edge_case(e)
+      m_edge_case(e),
+      m_blur(blur_none),
+      m_threads(1),
+      m_tile_rows(DEFAULT_TILE_ROWS),
+      m_fuse_kernels(false)
   {
     m_kernel = new f32*[m_height];
     for( std::size_t i = 0; i < m_height; ++i ){
@@ -46,13 +88,19 @@ namespace ocr {
     if(m_abs_sum < 0){
       m_abs_sum = -m_abs_sum;
     }
+
+    prepare_kernel();
   }
 
   Kernel_Image_Operator::Kernel_Image_Operator( f32** kernel, std::size_t width, std::size_t height, edge_handling e)
     :  m_width(width),
       m_height(height),
       m_abs_sum(0), // set accumulator to 0
-      m_edge_case(e)
+      m_edge_case(e),
+      m_blur(blur_none),
+      m_threads(1),
+      m_tile_rows(DEFAULT_TILE_ROWS),
+      m_fuse_kernels(false)
   {
     // Allocate memory for operator
     m_kernel = new f32*[m_height];
@@ -72,12 +120,269 @@ namespace ocr {
     if(m_abs_sum < 0){
       m_abs_sum = -m_abs_sum;
     }
+
+    prepare_kernel();
+  }
+
+  Kernel_Image_Operator::Kernel_Image_Operator( blur_type blur, f32 size, edge_handling e )
+    :  m_kernel(nullptr),
+      m_width(1),
+      m_height(1),
+      m_abs_sum(1),
+      m_edge_case(e),
+      m_separable(false),
+      m_fixed_multiplier(1),
+      m_fixed_shift(0),
+      m_fixed_point(false),
+      m_blur(blur),
+      m_threads(1),
+      m_tile_rows(DEFAULT_TILE_ROWS),
+      m_fuse_kernels(false)
+  {
+    prepare_blur( size );
+  }
+
+  static bool is_integer( f32 value ){
+    return std::floor( value ) == value && std::fabs( value ) < 16777216.0f;
+  }
+
+  static u32 gcd( u32 a, u32 b ){
+    while( b ){
+      const u32 r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Kernel_Image_Operator::prepare_kernel(){
+    m_taps.resize( m_width * m_height );
+
+    for( std::size_t i = 0; i < m_width; ++i ){
+      for( std::size_t j = 0; j < m_height; ++j ){
+        m_taps[i * m_height + j] = m_kernel[m_width - i - 1][m_height - j - 1];
+      }
+    }
+
+    factor_kernel();
+    prepare_fixed_point();
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Kernel_Image_Operator::factor_kernel(){
+
+    // Factor the taps as taps_x[i] * taps_y[j], pivoting on the largest
+    m_separable = false;
+    m_taps_x.clear();
+    m_taps_y.clear();
+
+    std::size_t pivot = 0;
+    for( std::size_t k = 1; k < m_taps.size(); ++k ){
+      if( std::fabs( m_taps[k] ) > std::fabs( m_taps[pivot] ) ){
+        pivot = k;
+      }
+    }
+    const f32 largest = std::fabs( m_taps[pivot] );
+    if( largest == 0 ){
+      return;
+    }
+
+    const std::size_t p = pivot / m_height;
+    const std::size_t q = pivot % m_height;
+
+    // Take the vertical factor from the pivot's column. If it is integral,
+    // divide out its common factor so that an integer kernel factors into
+    // integers, which the passes below then sum exactly.
+    bool integral = true;
+    u32  divisor  = 0;
+    for( std::size_t j = 0; j < m_height && integral; ++j ){
+      const f32 tap = m_taps[p * m_height + j];
+      integral = is_integer( tap );
+      divisor  = gcd( divisor, (u32) std::fabs( tap ) );
+    }
+    const f32 common = (integral && divisor > 1) ? (f32) divisor : 1.0f;
+
+    m_taps_x.resize( m_width );
+    m_taps_y.resize( m_height );
+    for( std::size_t j = 0; j < m_height; ++j ){
+      m_taps_y[j] = m_taps[p * m_height + j] / common;
+    }
+    for( std::size_t i = 0; i < m_width; ++i ){
+      m_taps_x[i] = m_taps[i * m_height + q] / (m_taps[pivot] / common);
+    }
+
+    for( std::size_t i = 0; i < m_width; ++i ){
+      for( std::size_t j = 0; j < m_height; ++j ){
+        const f32 error = m_taps_x[i] * m_taps_y[j] - m_taps[i * m_height + j];
+        if( std::fabs( error ) > SEPARABLE_TOLERANCE * largest ){
+          m_taps_x.clear();
+          m_taps_y.clear();
+          return;
+        }
+      }
+    }
+
+    m_separable = true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // The integer sums in 16-bit lanes wrap around, but only the final sum is
+  // read back, and it is in range. Dividing by the absolute sum d is then a
+  // multiply by ceil(2^shift / d) and a shift right; the smallest shift that
+  // divides every sum the kernel can produce exactly as clamp_sum() does is
+  // found by trying each sum in turn. A power-of-two d needs no multiply.
+  //
+  // A separable kernel is left to separable_interior() once its two passes
+  // take under half the taps of the fixed point sum, which has only twice
+  // the lanes.
+  //
+  void Kernel_Image_Operator::prepare_fixed_point(){
+    m_fixed_point      = false;
+    m_fixed_multiplier = 1;
+    m_fixed_shift      = 0;
+    m_fixed_taps.clear();
+
+    if( m_separable && 2 * (m_width + m_height) < m_width * m_height ){
+      return;
+    }
+
+    // The largest and smallest sums over channels of 0 to 255
+    s32 highest = 0;
+    s32 lowest  = 0;
+    for( std::size_t k = 0; k < m_taps.size(); ++k ){
+      const f32 tap = m_taps[k];
+
+      // No tap beyond 128 fits 255 times over in 16 bits
+      if( !is_integer( tap ) || std::fabs( tap ) > 128 ){
+        return;
+      }
+      if( tap > 0 ){
+        highest += (s32) tap * 255;
+      }else{
+        lowest  += (s32) tap * 255;
+      }
+      if( highest > 32767 || lowest < -32768 ){
+        return;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+
+    // A negative sum divides to at most 0 and clamps to 0, so only the
+    // sums from 0 up need checking
+    for( u32 shift = 0; shift < 32; ++shift ){
+      const u32 divisor    = m_abs_sum ? (u32) m_abs_sum : 1;
+      const u32 multiplier = (u32) ((((std::uint64_t) 1 << shift) + divisor - 1) / divisor);
+
+      if( (std::uint64_t) highest * multiplier > 0xffffffffu ){
+        break;
+      }
+
+      bool exact = true;
+      for( s32 sum = 0; sum <= highest && exact; ++sum ){
+        const s32 expected = m_abs_sum ? (s32) (sum / m_abs_sum) : sum;
+        const u32 quotient = ((u32) sum * multiplier) >> shift;
+
+        exact = (std::min<u32>( quotient, 255 ) == (u32) std::min<s32>( expected, 255 ));
+      }
+
+      if( exact ){
+        m_fixed_taps.resize( m_taps.size() );
+        for( std::size_t k = 0; k < m_taps.size(); ++k ){
+          m_fixed_taps[k] = (u16) (s32) m_taps[k];
+        }
+        m_fixed_multiplier = multiplier;
+        m_fixed_shift      = shift;
+        m_fixed_point      = true;
+        return;
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // The boxes of a box Gaussian are Kovesi's: n boxes of odd widths w and
+  // w + 2, as many of each as brings the sum of their variances,
+  // (w^2 - 1) / 12 apiece, nearest to sigma^2. The recursive filter's
+  // coefficients are those of Young, van Vliet and van Ginkel (2002).
+  //
+  void Kernel_Image_Operator::prepare_blur( f32 size ){
+    const f64 sigma = (size > 0) ? size : 0;
+    std::size_t reach = 0;
+
+    switch( m_blur ){
+
+    case blur_box:
+      m_box_radii.assign( 1, (std::size_t) sigma );
+      reach = m_box_radii[0];
+      break;
+
+    //-------------------------------------------------------------------------
+
+    case blur_box_gaussian:{
+      const f64 n        = BOX_GAUSSIAN_PASSES;
+      const f64 variance = 12 * sigma * sigma;
+
+      std::size_t lower = (std::size_t) std::sqrt( variance / n + 1 );
+      if( lower % 2 == 0 ){
+        --lower;
+      }
+      const f64 w           = (f64) lower;
+      const f64 lower_boxes = std::floor( (variance - n * w * w - 4 * n * w - 3 * n) / (-4 * w - 4) + 0.5 );
+
+      for( std::size_t k = 0; k < BOX_GAUSSIAN_PASSES; ++k ){
+        m_box_radii.push_back( ((f64) k < lower_boxes ? lower : lower + 2) / 2 );
+        reach += m_box_radii.back();
+      }
+      break;
+    }
+
+    //-------------------------------------------------------------------------
+
+    case blur_recursive:{
+      const f64 s = (sigma < 0.5) ? 0.5 : sigma;
+      const f64 q = (s >= 2.5) ? 0.98711 * s - 0.96330
+                               : 3.97156 - 4.14554 * std::sqrt( 1 - 0.26891 * s );
+
+      const f64 b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+      const f64 b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+      const f64 b2 = -(1.4281 * q * q + 1.26661 * q * q * q);
+      const f64 b3 = 0.422205 * q * q * q;
+
+      m_recursive[0] = 1 - (b1 + b2 + b3) / b0;
+      m_recursive[1] = b1 / b0;
+      m_recursive[2] = b2 / b0;
+      m_recursive[3] = b3 / b0;
+      reach = (std::size_t) std::ceil( 4 * s );
+      break;
+    }
+
+    //-------------------------------------------------------------------------
+
+    default:
+      // There is no kernel to convolve with, so the page is copied, by a
+      // box of one pixel
+      m_blur = blur_box;
+      m_box_radii.assign( 1, 0 );
+      break;
+    }
+
+    m_width  = 2 * reach + 1;
+    m_height = 2 * reach + 1;
   }
 
+  //---------------------------------------------------------------------------
+
   Kernel_Image_Operator::~Kernel_Image_Operator(){
 
-    // Delete Memory for operator
-    for( std::size_t i = 0; i < m_height; ++i ){
+    // Delete Memory for operator; a blur has no kernel
+    for( std::size_t i = 0; m_kernel && i < m_height; ++i ){
       delete [] m_kernel[i];
     }
     delete [] m_kernel;
@@ -88,210 +393,1605 @@ namespace ocr {
   //---------------------------------------------------------------------------
 
   Image Kernel_Image_Operator::operate( const Image& image ) const{
+    return operate( image.view(), 1 );
+  }
 
-    // Double buffered image operations
-    Image buffers[] = {
-      Image(image),
-      Image(image.width(),image.height())
-    };
-    Image* active_buffer   = &buffers[0];
-    Image* inactive_buffer = &buffers[1];
+  Image Kernel_Image_Operator::operate( const Image::const_view_type& image ) const{
+    return operate( image, 1 );
+  }
+
+  Image Kernel_Image_Operator::operate( const Image& image, std::size_t n ) const{
+    return operate( image.view(), n );
+  }
+
+  Image Kernel_Image_Operator::operate( const Image::const_view_type& image, std::size_t n ) const{
+    return operate_image<Image>( image, n );
+  }
+
+  //---------------------------------------------------------------------------
+
+  Gray_Image Kernel_Image_Operator::operate( const Gray_Image& image ) const{
+    return operate( image.view(), 1 );
+  }
+
+  Gray_Image Kernel_Image_Operator::operate( const Gray_Image::const_view_type& image ) const{
+    return operate( image, 1 );
+  }
+
+  Gray_Image Kernel_Image_Operator::operate( const Gray_Image& image, std::size_t n ) const{
+    return operate( image.view(), n );
+  }
+
+  Gray_Image Kernel_Image_Operator::operate( const Gray_Image::const_view_type& image, std::size_t n ) const{
+    return operate_image<Gray_Image>( image, n );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Image_Type>
+  Image_Type Kernel_Image_Operator::operate_image( const typename Image_Type::const_view_type& image,
+                                                   std::size_t n ) const{
+    typedef typename Image_Type::const_view_type const_view_type;
+    typedef typename Image_Type::view_type       view_type;
+
+    execution_plan plan;
+    make_plan( n, plan );
+
+    const pass_list& passes = plan.passes;
+    if( passes.empty() ){
+      return Image_Type( image );
+    }
+
+    // A single pass on a single thread is the only one not worth tiling
+    const bool        tiled  = (m_threads > 1) || (passes.size() > 1);
+    const std::size_t width  = image.width();
+    const std::size_t height = image.height();
+    const std::size_t rows   = tiled ? m_tile_rows : height;
+    const std::size_t tiles  = rows ? (height + rows - 1) / rows : 0;
 
     //-------------------------------------------------------------------------
 
-    // Perform the operation, then swap the buffers
-    this->do_operation( *active_buffer, *inactive_buffer );
-    std::swap( active_buffer, inactive_buffer );
+    // A tile can only be taken through every pass on its own if no pass
+    // after the first wraps, and so reads rows from the far side of the
+    // page, and no pass is a recursive blur, which reads every row of it
+    bool flows = (tiles > 1);
+    for( std::size_t p = 0; p < passes.size(); ++p ){
+      flows = flows && (p == 0 || passes[p]->m_edge_case != edge_wrap);
+      flows = flows && (passes[p]->m_blur != blur_recursive);
+    }
+
+    if( flows ){
+      Image_Type      result( width, height, aligned_layout() );
+      const view_type target = result.view();
+
+      for_each_tile( tiles, [&]( std::size_t tile ){
+        const std::size_t first = tile * rows;
+        flow_tile<Image_Type>( passes, image, target, first, std::min( first + rows, height ) );
+      } );
+      return result;
+    }
 
     //-------------------------------------------------------------------------
 
-    // Perform the chained operation, then swap the buffers
+    // Otherwise one pass at a time over the whole page, double buffered; the
+    // first pass reads the view itself, and a single pass needs only the one
+    // buffer. The buffers' rows are aligned.
+    Image_Type buffers[] = {
+      Image_Type( width, height, aligned_layout() ),
+      Image_Type( passes.size() > 1 ? width : 0, passes.size() > 1 ? height : 0, aligned_layout() )
+    };
+    const_view_type source = image;
+    std::size_t     target = 0;
+
+    for( std::size_t p = 0; p < passes.size(); ++p ){
+      const Kernel_Image_Operator* pass = passes[p];
+      const view_type              out  = buffers[target].view();
+
+      if( pass->m_blur == blur_recursive ){
+        recursive_pass( *pass, source, out );
+      }else{
+        for_each_tile( tiles, [&]( std::size_t tile ){
+          const std::size_t first = tile * rows;
+          pass->do_operation( source, 0, out, 0, height, first, std::min( first + rows, height ) );
+        } );
+      }
+      source = out;
+      target ^= 1;
+    }
+
+    return std::move( buffers[target ^ 1] );
+  }
+
+  Image Kernel_Image_Operator::operate_band( const Image& band,
+                                             std::size_t first,
+                                             std::size_t rows ) const{
+    Image full = operate( band.view() );
+
+    if( first == 0 && rows == full.height() ){
+      return full;
+    }
+
+    // The halo rows only provide context; keep the rows that were asked for
+    return Image( full.view( 0, first, full.width(), rows ) );
+  }
+
+  //---------------------------------------------------------------------------
+
+  std::size_t Kernel_Image_Operator::halo() const{
+    std::size_t rows = m_height / 2;
+
+    // Each chained operation reads further rows around the previous result
     Operators::const_iterator iter = m_operators.cbegin();
     for( ; iter != m_operators.cend(); ++iter ){
-      (*iter)->do_operation( *active_buffer, *inactive_buffer );
-      std::swap( active_buffer, inactive_buffer );
+      rows += (*iter)->m_height / 2;
     }
+    return rows;
+  }
 
-    //-------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+
+  void Kernel_Image_Operator::set_threads( std::size_t threads ){
+    if( threads == 0 ){
+      threads = Thread_Pool::default_size();
+    }
+    if( threads == m_threads ){
+      return;
+    }
 
-    return *active_buffer;
+    // The calling thread works through tiles too, so the pool is one short
+    m_pool.reset( threads > 1 ? new Thread_Pool( threads - 1 ) : nullptr );
+    m_threads = threads;
   }
 
-  Image Kernel_Image_Operator::operate( const Image& image, std::size_t n ) const{
+  std::size_t Kernel_Image_Operator::threads() const{
+    return m_threads;
+  }
 
-    // Double buffered
-    Image buffers[] = {
-      Image(image),
-      Image(image.width(),image.height())
-    };
-    Image* active_buffer   = &buffers[0];
-    Image* inactive_buffer = &buffers[1];
+  void Kernel_Image_Operator::set_tile_rows( std::size_t rows ){
+    m_tile_rows = rows ? rows : 1;
+  }
 
-    //-------------------------------------------------------------------------
+  std::size_t Kernel_Image_Operator::tile_rows() const{
+    return m_tile_rows;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Kernel_Image_Operator::set_kernel_fusion( bool fuse ){
+    m_fuse_kernels = fuse;
+  }
+
+  bool Kernel_Image_Operator::kernel_fusion() const{
+    return m_fuse_kernels;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Kernel_Image_Operator::separable() const{
+    return m_separable;
+  }
+
+  bool Kernel_Image_Operator::fixed_point() const{
+    return m_fixed_point;
+  }
+
+  bool Kernel_Image_Operator::fft_convolved() const{
+    return m_blur == blur_none && !m_fixed_point && !m_separable &&
+           m_width * m_height >= FFT_CROSSOVER_AREA;
+  }
+
+  Kernel_Image_Operator::blur_type Kernel_Image_Operator::blur() const{
+    return m_blur;
+  }
+
+  //---------------------------------------------------------------------------
+  // Fusion
+  //---------------------------------------------------------------------------
+
+  void Kernel_Image_Operator::make_plan( std::size_t n, execution_plan& plan ) const{
+
+    // This operation n times first, then each of the chained operations
+    plan.passes.assign( n, this );
+    plan.passes.insert( plan.passes.end(), m_operators.cbegin(), m_operators.cend() );
+    plan.fused.clear();
 
-    // Do operation n times first
-    for( std::size_t i = 0; i < n; ++i ){
-      this->do_operation( *active_buffer, *inactive_buffer );
-      // swap the buffer pointers
-      std::swap( active_buffer, inactive_buffer );
+    if( !m_fuse_kernels || plan.passes.size() < 2 ){
+      return;
     }
 
     //-------------------------------------------------------------------------
 
-    Operators::const_iterator iter = m_operators.cbegin();
-    for( ; iter != m_operators.cend(); ++iter ){
-      (*iter)->do_operation( *active_buffer, *inactive_buffer );
-      // swap the buffer
-      std::swap( active_buffer, inactive_buffer );
+    // Fuse each pass onto the one before it for as long as that pays
+    pass_list passes;
+    const Kernel_Image_Operator* current = plan.passes[0];
+
+    for( std::size_t p = 1; p < plan.passes.size(); ++p ){
+      const Kernel_Image_Operator* next = plan.passes[p];
+
+      if( can_fuse( *current, *next ) ){
+        std::unique_ptr<Kernel_Image_Operator> fused( fuse( *current, *next ) );
+
+        if( fused->taps() <= current->taps() + next->taps() ){
+          current = fused.get();
+          plan.fused.push_back( std::move( fused ) );
+          continue;
+        }
+      }
+      passes.push_back( current );
+      current = next;
     }
+    passes.push_back( current );
 
-    //-------------------------------------------------------------------------
+    plan.passes.swap( passes );
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Kernel_Image_Operator::can_fuse( const Kernel_Image_Operator& first,
+                                        const Kernel_Image_Operator& second ){
+    if( first.m_blur != blur_none || second.m_blur != blur_none ){
+      return false;
+    }
+    if( first.m_edge_case != second.m_edge_case ){
+      return false;
+    }
 
-    return *active_buffer;
+    const Kernel_Image_Operator* ops[] = { &first, &second };
+    for( std::size_t o = 0; o < 2; ++o ){
+      const Kernel_Image_Operator& op = *ops[o];
+
+      if( op.m_width != op.m_height || !(op.m_width & 1) ){
+        return false;
+      }
+      for( std::size_t k = 0; k < op.m_taps.size(); ++k ){
+        if( op.m_taps[k] < 0 ){
+          return false;
+        }
+      }
+      if( op.m_abs_sum <= 0 ){
+        return false;
+      }
+    }
+    return true;
   }
 
   //---------------------------------------------------------------------------
 
   //
-  // This algorithm runs in O(m*n*i*j) where m and n are the width and height
-  // of the image respectively, and i and j are the width and height of the
-  // kernel matrix.
-  //
-  // Sadly there is no other way around dealing with this, due to the i*j being
-  // necessary for the accumulator.
+  // Both passes read their taps at offsets from the pixel, so the taps of
+  // the fused pass are every sum of an offset of the first and an offset of
+  // the second; the product of their weights is added at each. The fused
+  // pass divides by both of the passes' absolute sums.
   //
-  void Kernel_Image_Operator::do_operation( const Image& in_image, Image& out_image ) const{
+  Kernel_Image_Operator* Kernel_Image_Operator::fuse( const Kernel_Image_Operator& first,
+                                                      const Kernel_Image_Operator& second ){
+    const std::size_t size = first.m_width + second.m_width - 1;
 
-    const u32 offset_i = (m_width / 2);
-    const u32 offset_j = (m_height / 2);
+    std::vector<double> taps( size * size, 0.0 );
+    for( std::size_t i1 = 0; i1 < first.m_width; ++i1 ){
+      for( std::size_t j1 = 0; j1 < first.m_height; ++j1 ){
+        const double weight = first.m_taps[i1 * first.m_height + j1];
 
-    //-------------------------------------------------------------------------
+        for( std::size_t i2 = 0; i2 < second.m_width; ++i2 ){
+          for( std::size_t j2 = 0; j2 < second.m_height; ++j2 ){
+            taps[(i1 + i2) * size + (j1 + j2)] += weight * second.m_taps[i2 * second.m_height + j2];
+          }
+        }
+      }
+    }
 
-    // Allocate 2D array
-    pixel_type** values = new pixel_type*[m_height];
-    for( std::size_t i = 0; i < m_height; ++i ){
-      values[i] = new pixel_type[m_width];
+    // The constructor flips the kernel it is given, so give it unflipped
+    vector_2d_type kernel( size, std::vector<f32>( size ) );
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        kernel[i][j] = (f32) taps[(size - 1 - i) * size + (size - 1 - j)];
+      }
     }
 
-    //-------------------------------------------------------------------------
+    Kernel_Image_Operator* fused = new Kernel_Image_Operator( kernel, first.m_edge_case );
+    fused->m_abs_sum = first.m_abs_sum * second.m_abs_sum;
+    fused->prepare_fixed_point();
+    return fused;
+  }
 
-    for( u32 x = 0; x < in_image.width(); ++x ){
-      for( u32 y = 0; y < in_image.height(); ++y ){
-        const bool on_top_boundary    = (y < offset_j);
-        const bool on_right_boundary  = (x > (in_image.width() - 1 - offset_i));
-        const bool on_bottom_boundary = (y > (in_image.height() - 1 - offset_j));
-        const bool on_left_boundary   = (x < offset_i);
+  //---------------------------------------------------------------------------
 
-        s32 accumulator_r = 0;
-        s32 accumulator_g = 0;
-        s32 accumulator_b = 0;
+  std::size_t Kernel_Image_Operator::taps() const{
+    return m_separable ? m_width + m_height : m_width * m_height;
+  }
 
-        //---------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  // Tiles
+  //---------------------------------------------------------------------------
 
-        // If edge case crops, then just take the original pixel
-        if( (m_edge_case == edge_crop) && (
-              (x < offset_i) ||
-              (x > (in_image.width()  - offset_i - 1)) ||
-              (y < offset_j) ||
-              (y > (in_image.height() - offset_j - 1))
-            )
-          ){
-          out_image.set( x, y, pixel_type::BLACK );
-        }else{
+  //
+  // The calling thread claims tiles alongside the pool's workers, so a call
+  // finishes even while the pool is busy with another call's tiles, and it
+  // waits only for the workers it started.
+  //
+  // The workers refer to this call's locals, so it never returns before
+  // they have finished, even when a tile throws; the first exception stops
+  // any more tiles from being claimed, and is rethrown once every worker
+  // is done.
+  //
+  void Kernel_Image_Operator::for_each_tile( std::size_t tiles,
+                                             const std::function<void(std::size_t)>& task ) const{
+    const std::size_t helpers = (m_pool && tiles > 1) ? std::min( m_pool->size(), tiles - 1 ) : 0;
 
-          // Loop through the operators
-          for( s32 i = -offset_i; i <= (s32) offset_i; ++i ){
-            for( s32 j = -offset_j; j <= (s32) offset_j; ++j ){
-              const s32 index_i = i + offset_i;
-              const s32 index_j = j + offset_j;
-
-              // If on edge case, handle edge case
-              if( (on_top_boundary  && (j < 0)) ||
-                  (on_left_boundary && (i < 0)) ||
-                  (on_right_boundary && (i > 0)) ||
-                  (on_bottom_boundary && (j > 0))
-                ){
-
-                switch(m_edge_case){
-
-                case edge_extend:
-                  values[index_i][index_j] = in_image.at(
-                    on_left_boundary ? 0 : on_right_boundary  ? in_image.width() - 1  : x,
-                    on_top_boundary  ? 0 : on_bottom_boundary ? in_image.height() - 1 : y
-                  );
-                  break;
-
-                //---------------------------------------------------------------
-
-                case edge_is_gray:
-                  values[index_i][index_j] = pixel_type::GRAY;
-                  break;
-
-                //---------------------------------------------------------------
-
-                case edge_wrap:
-                  values[index_i][index_j] = in_image.at(
-                    on_left_boundary ? in_image.width()  + i - 1 : on_right_boundary  ? i : x,
-                    on_top_boundary  ? in_image.height() + j - 1 : on_bottom_boundary ? j : y
-                  );
-                  break;
-
-                //---------------------------------------------------------------
-
-                default:
-                  // Shouldn't happen
-                  break;
-                }
-              }else{
-                values[index_i][index_j] = in_image.at(x+i,y+j);
-              }
-            }
-          }
+    std::mutex              mutex;
+    std::condition_variable finished;
+    std::size_t             running = helpers;
+    std::exception_ptr      failure;
+
+    std::atomic<std::size_t> next( 0 );
+    auto work = [&](){
+      try{
+        for( std::size_t tile = next++; tile < tiles; tile = next++ ){
+          task( tile );
+        }
+      }catch( ... ){
+        next = tiles;
 
-          //---------------------------------------------------------------------
+        std::lock_guard<std::mutex> lock( mutex );
+        if( !failure ){
+          failure = std::current_exception();
+        }
+      }
+    };
 
-          // Calculate the sum of all operations
-          for( std::size_t i = 0; i < m_width; ++i ){
-            for( std::size_t j = 0; j < m_height; ++j ){
-              const std::size_t ki = m_width - i - 1;
-              const std::size_t kj = m_height - j - 1;
-              accumulator_r += m_kernel[ki][kj] * values[i][j].r;
-              accumulator_g += m_kernel[ki][kj] * values[i][j].g;
-              accumulator_b += m_kernel[ki][kj] * values[i][j].b;
-            }
-          }
+    for( std::size_t i = 0; i < helpers; ++i ){
+      try{
+        m_pool->submit( [&](){
+          work();
 
-          // Divide all sums by the absolute sum, if the sum is not 0
-          if(m_abs_sum){
-            accumulator_r /= m_abs_sum;
-            accumulator_g /= m_abs_sum;
-            accumulator_b /= m_abs_sum;
+          std::lock_guard<std::mutex> lock( mutex );
+          if( --running == 0 ){
+            finished.notify_one();
           }
+        } );
+      }catch( ... ){
+        // The tiles are left to the workers already started, and this thread
+        std::lock_guard<std::mutex> lock( mutex );
+        running -= helpers - i;
+        break;
+      }
+    }
+    work();
 
-          //---------------------------------------------------------------------
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      finished.wait( lock, [&](){ return running == 0; } );
+    }
 
-          // Clamp the sum between (0,255)
-          pixel_type sum(
-            ((accumulator_r > 255) ? 255 : ((accumulator_r < 0) ? 0 : accumulator_r)),
-            ((accumulator_g > 255) ? 255 : ((accumulator_g < 0) ? 0 : accumulator_g)),
-            ((accumulator_b > 255) ? 255 : ((accumulator_b < 0) ? 0 : accumulator_b))
-          );
+    if( failure ){
+      std::rethrow_exception( failure );
+    }
+  }
 
-          //---------------------------------------------------------------------
+  //---------------------------------------------------------------------------
 
-          out_image.set( x, y, sum );
-        }
-      }
+  //
+  // Each pass reads the rows of the one before it for half its kernel above
+  // and below, so the rows each pass must produce are found by walking back
+  // from the tile. Only the last pass writes to the page; the passes before
+  // it write to buffers of just their own rows, which are still in cache
+  // when the next pass reads them.
+  //
+  template<typename Image_Type>
+  void Kernel_Image_Operator::flow_tile( const pass_list& passes,
+                                         const typename Image_Type::const_view_type& source,
+                                         const typename Image_Type::view_type& target,
+                                         std::size_t first,
+                                         std::size_t last ) const{
+    typedef typename Image_Type::const_view_type const_view_type;
+
+    const std::size_t height = source.height();
+    const std::size_t count  = passes.size();
+
+    std::vector<std::size_t> begins( count );
+    std::vector<std::size_t> ends( count );
+    begins[count - 1] = first;
+    ends[count - 1]   = last;
+
+    for( std::size_t p = count - 1; p > 0; --p ){
+      const std::size_t reach = passes[p]->m_height / 2;
+
+      begins[p - 1] = (begins[p] > reach) ? begins[p] - reach : 0;
+      ends[p - 1]   = (ends[p] + reach < height) ? ends[p] + reach : height;
     }
 
     //-------------------------------------------------------------------------
 
-    // Delete 2D array
-    for( std::size_t i = 0; i < m_height; ++i ){
-      delete [] values[i];
+    Image_Type      buffers[] = { Image_Type( 0, 0 ), Image_Type( 0, 0 ) };
+    const_view_type in        = source;
+    std::size_t     in_top    = 0;
+
+    for( std::size_t p = 0; p + 1 < count; ++p ){
+      Image_Type& buffer = buffers[p & 1];
+      buffer = Image_Type( source.width(), ends[p] - begins[p], aligned_layout() );
+
+      passes[p]->do_operation( in, in_top, buffer.view(), begins[p], height, begins[p], ends[p] );
+      in     = buffer.view();
+      in_top = begins[p];
     }
-    delete [] values;
 
+    passes[count - 1]->do_operation( in, in_top, target, 0, height, first, last );
+  }
+
+  //---------------------------------------------------------------------------
+  // Row Primitives
+  //---------------------------------------------------------------------------
+
+  //
+  // The interior is computed a row of channels at a time. A row of pixels is
+  // widened to floats, r, g and b interleaved as they are in the image, and
+  // every tap is then one multiply-add across the whole row: the channels of
+  // a pixel share their taps, so the interleaving never has to be undone.
+  // A grayscale row is the same with one channel, so a tap reaches one value
+  // along the row for each pixel rather than three.
+  // Each primitive is compiled for AVX2, SSE4.1 and SSSE3 as well as the
+  // baseline target, and the best is picked when the program loads.
+  //
+
+  static_assert( sizeof(Kernel_Image_Operator::pixel_type) == 3,
+                 "the row primitives read the image as packed 3-byte pixels" );
+
+  // The values of each pixel of a row; every channel is a byte
+  template<typename Pixel>
+  static inline std::size_t channels_of(){
+    return sizeof(Pixel);
+  }
+
+  /// The floats of a row that the direct sum keeps in flight at once
+  static const std::size_t CHUNK_SIZE = 1536;
+
+  OCR_TARGET_CLONES
+  static void widen_row( const ubyte* OCR_RESTRICT src,
+                         f32* OCR_RESTRICT dst,
+                         std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      dst[k] = src[k];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  OCR_TARGET_CLONES
+  static void accumulate_row( f32* OCR_RESTRICT sums,
+                              const f32* OCR_RESTRICT src,
+                              f32 tap,
+                              std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      sums[k] += tap * src[k];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  // As accumulate_row, truncating toward zero after every tap as an integer
+  // accumulator would; the sums stay integral, and exact below 2^24
+  OCR_TARGET_CLONES
+  static void accumulate_row_truncated( f32* OCR_RESTRICT sums,
+                                        const f32* OCR_RESTRICT src,
+                                        f32 tap,
+                                        std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      sums[k] = (f32) (s32) (sums[k] + tap * src[k]);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  // clamp_sum() across a row: truncate, divide by the absolute sum, clamp
+  OCR_TARGET_CLONES
+  static void narrow_row( const f32* OCR_RESTRICT sums,
+                          ubyte* OCR_RESTRICT dst,
+                          f32 abs_sum,
+                          std::size_t count ){
+    if( abs_sum ){
+      for( std::size_t k = 0; k < count; ++k ){
+        const s32 value = (s32) ((f32) (s32) sums[k] / abs_sum);
+        dst[k] = (ubyte) ((value > 255) ? 255 : ((value < 0) ? 0 : value));
+      }
+    }else{
+      for( std::size_t k = 0; k < count; ++k ){
+        const s32 value = (s32) sums[k];
+        dst[k] = (ubyte) ((value > 255) ? 255 : ((value < 0) ? 0 : value));
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // The fixed point primitives hold channels and sums in 16-bit lanes, as
+  // unsigned so that the sums may wrap around on the way to a final sum
+  // that is in range, and that is then read back as signed.
+  //
+
+  OCR_TARGET_CLONES
+  static void widen_row_fixed( const ubyte* OCR_RESTRICT src,
+                               u16* OCR_RESTRICT dst,
+                               std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      dst[k] = src[k];
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  OCR_TARGET_CLONES
+  static void accumulate_row_fixed( u16* OCR_RESTRICT sums,
+                                    const u16* OCR_RESTRICT src,
+                                    u16 tap,
+                                    std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      sums[k] = (u16) (sums[k] + tap * src[k]);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  // clamp_sum() in fixed point: clamp a negative sum to 0, multiply, shift
+  static OCR_FORCE_INLINE ubyte narrow_fixed( u16 sum, u32 multiplier, u32 shift ){
+    const s16 value  = (s16) sum;
+    const u32 result = ((u32) ((value < 0) ? 0 : value) * multiplier) >> shift;
+    return (ubyte) ((result > 255) ? 255 : result);
+  }
+
+  OCR_TARGET_CLONES
+  static void narrow_row_fixed( const u16* OCR_RESTRICT sums,
+                                ubyte* OCR_RESTRICT dst,
+                                u32 multiplier,
+                                u32 shift,
+                                std::size_t count ){
+    for( std::size_t k = 0; k < count; ++k ){
+      dst[k] = narrow_fixed( sums[k], multiplier, shift );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Small Kernels
+  //---------------------------------------------------------------------------
+
+  //
+  // Square fixed point kernels of 3, 5 and 7 taps a side are summed by code
+  // unrolled at compile time for their size. The taps are copied into locals
+  // that are kept in registers, and each sum stays in a register from its
+  // first tap to its last, rather than being stored and reloaded between
+  // taps as with accumulate_row_fixed(). Past 25 taps there are too few
+  // registers for that, so a 7x7 is summed a column of taps at a time.
+  //
+  // The floating point sums gain nothing from this: truncating after every
+  // tap makes each sum a long chain of conversions, and the generic loops
+  // already keep a chunk's worth of them in flight.
+  //
+
+  static bool is_small_kernel( std::size_t width, std::size_t height ){
+    return width == height && (width == 3 || width == 5 || width == 7);
+  }
+
+  //---------------------------------------------------------------------------
+
+  // One chunk of an output row of a W x H kernel over C channels; rows[j] is
+  // the ring row that tap row j reads, from the chunk's leftmost tap
+  template<std::size_t W, std::size_t H, std::size_t C>
+  static OCR_FORCE_INLINE void convolve_row_fixed( const u16* const* rows,
+                                                   const u16* taps,
+                                                   u16* OCR_RESTRICT sums,
+                                                   ubyte* OCR_RESTRICT dst,
+                                                   u32 multiplier,
+                                                   u32 shift,
+                                                   std::size_t count ){
+    const u16* row[H];
+    for( std::size_t j = 0; j < H; ++j ){
+      row[j] = rows[j];
+    }
+
+    if( W * H <= 25 ){
+      u16 tap[W * H];
+      for( std::size_t t = 0; t < W * H; ++t ){
+        tap[t] = taps[t];
+      }
+
+      for( std::size_t k = 0; k < count; ++k ){
+        u16 sum = 0;
+        for( std::size_t i = 0; i < W; ++i ){
+          for( std::size_t j = 0; j < H; ++j ){
+            sum = (u16) (sum + tap[i * H + j] * row[j][k + i * C]);
+          }
+        }
+        dst[k] = narrow_fixed( sum, multiplier, shift );
+      }
+      return;
+    }
+
+    //-------------------------------------------------------------------------
+
+    for( std::size_t k = 0; k < count; ++k ){
+      sums[k] = 0;
+    }
+    for( std::size_t i = 0; i < W; ++i ){
+      u16 tap[H];
+      for( std::size_t j = 0; j < H; ++j ){
+        tap[j] = taps[i * H + j];
+      }
+
+      for( std::size_t k = 0; k < count; ++k ){
+        u16 sum = sums[k];
+        for( std::size_t j = 0; j < H; ++j ){
+          sum = (u16) (sum + tap[j] * row[j][k + i * C]);
+        }
+        sums[k] = sum;
+      }
+    }
+    for( std::size_t k = 0; k < count; ++k ){
+      dst[k] = narrow_fixed( sums[k], multiplier, shift );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  // convolve_row_fixed() for a kernel with is_small_kernel() sides of size,
+  // over 1 or 3 channels
+  OCR_TARGET_CLONES
+  static void convolve_small_row_fixed( std::size_t size,
+                                        std::size_t channels,
+                                        const u16* const* rows,
+                                        const u16* taps,
+                                        u16* OCR_RESTRICT sums,
+                                        ubyte* OCR_RESTRICT dst,
+                                        u32 multiplier,
+                                        u32 shift,
+                                        std::size_t count ){
+    if( channels == 1 ){
+      switch( size ){
+      case 3:  convolve_row_fixed<3,3,1>( rows, taps, sums, dst, multiplier, shift, count ); break;
+      case 5:  convolve_row_fixed<5,5,1>( rows, taps, sums, dst, multiplier, shift, count ); break;
+      case 7:  convolve_row_fixed<7,7,1>( rows, taps, sums, dst, multiplier, shift, count ); break;
+      default: break;
+      }
+      return;
+    }
+
+    switch( size ){
+    case 3:  convolve_row_fixed<3,3,3>( rows, taps, sums, dst, multiplier, shift, count ); break;
+    case 5:  convolve_row_fixed<5,5,3>( rows, taps, sums, dst, multiplier, shift, count ); break;
+    case 7:  convolve_row_fixed<7,7,3>( rows, taps, sums, dst, multiplier, shift, count ); break;
+    default: break;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Operation
+  //---------------------------------------------------------------------------
+
+  //
+  // Accumulators are integers that the float products are added to one at a
+  // time, so the order of the taps is part of the result; both paths below
+  // visit them in the same order.
+  //
+  static inline ubyte clamp_sum( s32 accumulator, f32 abs_sum ){
+    // Divide the sum by the absolute sum, if the sum is not 0
+    if(abs_sum){
+      accumulator /= abs_sum;
+    }
+
+    // Clamp the sum between (0,255)
+    return (ubyte) ((accumulator > 255) ? 255 : ((accumulator < 0) ? 0 : accumulator));
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // This algorithm runs in O(m*n*i*j) where m and n are the width and height
+  // of the image respectively, and i and j are the width and height of the
+  // kernel matrix.
+  //
+  // Only the ring of pixels within half a kernel of the edge needs the edge
+  // handling, so those go through border_pixel() one at a time. Every other
+  // pixel is left to direct_interior(), which sums whole rows at once with
+  // no bounds checks or branches, or for a separable kernel to
+  // separable_interior(), which runs in O(m*n*(i+j)). An integer kernel
+  // that is exact in fixed point goes to fixed_interior() instead, and a
+  // large kernel to fft_interior(), which runs in O(m*n*log(i*j)). A box
+  // blur is left to box_blur(), edge and all, in O(m*n).
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::do_operation( const Image_View<const Pixel>& in_image,
+                                            std::size_t in_top,
+                                            const Image_View<Pixel>& out_image,
+                                            std::size_t out_top,
+                                            std::size_t height,
+                                            std::size_t first,
+                                            std::size_t last ) const{
+
+    if( m_blur != blur_none ){
+      box_blur( in_image, in_top, out_image, out_top, height, first, last );
+      return;
+    }
+
+    const std::size_t width    = in_image.width();
+    const std::size_t offset_i = (m_width / 2);
+    const std::size_t offset_j = (m_height / 2);
+
+    //-------------------------------------------------------------------------
+
+    // Scratch for the border pixels' taps
+    std::vector<Pixel> values( m_width * m_height );
+
+    // The interior is [x_begin, x_end) x [y_begin, y_end) of the page, less
+    // the rows outside of [first, last); it is empty when the kernel is
+    // wider or taller than the page
+    const std::size_t x_begin = offset_i;
+    const std::size_t x_end   = (width  > 2 * offset_i) ? width  - offset_i : x_begin;
+    std::size_t       y_begin = offset_j;
+    std::size_t       y_end   = (height > 2 * offset_j) ? height - offset_j : y_begin;
+
+    y_begin = (y_begin < first) ? first : y_begin;
+    y_end   = (y_end   > last)  ? last  : y_end;
+
+    //-------------------------------------------------------------------------
+
+    for( std::size_t y = first; y < last; ++y ){
+      Pixel* out = out_image.row( y - out_top );
+
+      if( y < y_begin || y >= y_end || x_begin >= x_end ){
+        for( std::size_t x = 0; x < width; ++x ){
+          out[x] = border_pixel( in_image, in_top, height, x, y, &values[0] );
+        }
+        continue;
+      }
+
+      for( std::size_t x = 0; x < x_begin; ++x ){
+        out[x] = border_pixel( in_image, in_top, height, x, y, &values[0] );
+      }
+      for( std::size_t x = x_end; x < width; ++x ){
+        out[x] = border_pixel( in_image, in_top, height, x, y, &values[0] );
+      }
+    }
+
+    //-------------------------------------------------------------------------
+
+    if( x_begin < x_end && y_begin < y_end ){
+      if( m_fixed_point ){
+        fixed_interior( in_image, in_top, out_image, out_top, x_begin, x_end, y_begin, y_end );
+      }else if( m_separable ){
+        separable_interior( in_image, in_top, out_image, out_top, x_begin, x_end, y_begin, y_end );
+      }else if( fft_convolved() ){
+        fft_interior( in_image, in_top, out_image, out_top, x_begin, x_end, y_begin, y_end );
+      }else{
+        direct_interior( in_image, in_top, out_image, out_top, x_begin, x_end, y_begin, y_end );
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // The rows the kernel covers are widened into a ring as they are first
+  // needed. Each output row is then summed a chunk at a time, tap by tap in
+  // the order border_pixel() visits them, truncating after every tap, so the
+  // interior is bit-identical to summing one pixel at a time.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::direct_interior( const Image_View<const Pixel>& in_image,
+                                               std::size_t in_top,
+                                               const Image_View<Pixel>& out_image,
+                                               std::size_t out_top,
+                                               std::size_t x_begin,
+                                               std::size_t x_end,
+                                               std::size_t y_begin,
+                                               std::size_t y_end ) const{
+
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t offset_i = (m_width / 2);
+    const std::size_t offset_j = (m_height / 2);
+    const std::size_t row_size = in_image.width() * channels;
+    const std::size_t span     = (x_end - x_begin) * channels;
+
+    Scratch_Buffer<f32> ring( m_height * row_size );
+    Scratch_Buffer<f32> sums( (span < CHUNK_SIZE) ? span : CHUNK_SIZE );
+
+    for( std::size_t r = y_begin - offset_j; r < y_begin - offset_j + m_height - 1; ++r ){
+      widen_row( reinterpret_cast<const ubyte*>( in_image.row( r - in_top ) ),
+                 &ring[(r % m_height) * row_size],
+                 row_size );
+    }
+
+    for( std::size_t y = y_begin; y < y_end; ++y ){
+
+      // The last row output row y reads is the only one not yet widened
+      const std::size_t last = y - offset_j + m_height - 1;
+      widen_row( reinterpret_cast<const ubyte*>( in_image.row( last - in_top ) ),
+                 &ring[(last % m_height) * row_size],
+                 row_size );
+
+      ubyte* out = reinterpret_cast<ubyte*>( out_image.row( y - out_top ) + x_begin );
+
+      for( std::size_t chunk = 0; chunk < span; chunk += CHUNK_SIZE ){
+        const std::size_t count = (span - chunk < CHUNK_SIZE) ? span - chunk : CHUNK_SIZE;
+        const std::size_t left  = (x_begin - offset_i) * channels + chunk;
+
+        for( std::size_t k = 0; k < count; ++k ){
+          sums[k] = 0;
+        }
+
+        const f32* tap = &m_taps[0];
+        for( std::size_t i = 0; i < m_width; ++i ){
+          for( std::size_t j = 0; j < m_height; ++j, ++tap ){
+            const f32* row = &ring[((y - offset_j + j) % m_height) * row_size];
+
+            accumulate_row_truncated( &sums[0], row + left + i * channels, *tap, count );
+          }
+        }
+
+        narrow_row( &sums[0], out + chunk, m_abs_sum, count );
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // As direct_interior(), in 16-bit lanes. The sums of an integer kernel are
+  // exact in any order, so they need no truncating as they go.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::fixed_interior( const Image_View<const Pixel>& in_image,
+                                              std::size_t in_top,
+                                              const Image_View<Pixel>& out_image,
+                                              std::size_t out_top,
+                                              std::size_t x_begin,
+                                              std::size_t x_end,
+                                              std::size_t y_begin,
+                                              std::size_t y_end ) const{
+
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t offset_i = (m_width / 2);
+    const std::size_t offset_j = (m_height / 2);
+    const std::size_t row_size = in_image.width() * channels;
+    const std::size_t span     = (x_end - x_begin) * channels;
+    const bool        small    = is_small_kernel( m_width, m_height );
+
+    Scratch_Buffer<u16>        ring( m_height * row_size );
+    Scratch_Buffer<u16>        sums( (span < CHUNK_SIZE) ? span : CHUNK_SIZE );
+    Scratch_Buffer<const u16*> rows( m_height );
+
+    for( std::size_t r = y_begin - offset_j; r < y_begin - offset_j + m_height - 1; ++r ){
+      widen_row_fixed( reinterpret_cast<const ubyte*>( in_image.row( r - in_top ) ),
+                       &ring[(r % m_height) * row_size],
+                       row_size );
+    }
+
+    for( std::size_t y = y_begin; y < y_end; ++y ){
+
+      const std::size_t last = y - offset_j + m_height - 1;
+      widen_row_fixed( reinterpret_cast<const ubyte*>( in_image.row( last - in_top ) ),
+                       &ring[(last % m_height) * row_size],
+                       row_size );
+
+      ubyte* out = reinterpret_cast<ubyte*>( out_image.row( y - out_top ) + x_begin );
+
+      for( std::size_t chunk = 0; chunk < span; chunk += CHUNK_SIZE ){
+        const std::size_t count = (span - chunk < CHUNK_SIZE) ? span - chunk : CHUNK_SIZE;
+        const std::size_t left  = (x_begin - offset_i) * channels + chunk;
+
+        if( small ){
+          for( std::size_t j = 0; j < m_height; ++j ){
+            rows[j] = &ring[((y - offset_j + j) % m_height) * row_size] + left;
+          }
+          convolve_small_row_fixed( m_width, channels, &rows[0], &m_fixed_taps[0], &sums[0], out + chunk,
+                                    m_fixed_multiplier, m_fixed_shift, count );
+          continue;
+        }
+
+        for( std::size_t k = 0; k < count; ++k ){
+          sums[k] = 0;
+        }
+
+        const u16* tap = &m_fixed_taps[0];
+        for( std::size_t i = 0; i < m_width; ++i ){
+          for( std::size_t j = 0; j < m_height; ++j, ++tap ){
+            if( *tap ){
+              const u16* row = &ring[((y - offset_j + j) % m_height) * row_size];
+
+              accumulate_row_fixed( &sums[0], row + left + i * channels, *tap, count );
+            }
+          }
+        }
+
+        narrow_row_fixed( &sums[0], out + chunk, m_fixed_multiplier, m_fixed_shift, count );
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // Each input row is passed horizontally once, into a ring holding the last
+  // m_height rows of sums; each output row is then a vertical pass over the
+  // ring. The sums are exact for integer kernels.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::separable_interior( const Image_View<const Pixel>& in_image,
+                                                  std::size_t in_top,
+                                                  const Image_View<Pixel>& out_image,
+                                                  std::size_t out_top,
+                                                  std::size_t x_begin,
+                                                  std::size_t x_end,
+                                                  std::size_t y_begin,
+                                                  std::size_t y_end ) const{
+
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t offset_i = (m_width / 2);
+    const std::size_t offset_j = (m_height / 2);
+    const std::size_t row_size = in_image.width() * channels;
+    const std::size_t span     = (x_end - x_begin) * channels;
+    const std::size_t left     = (x_begin - offset_i) * channels;
+
+    Scratch_Buffer<f32> widened( row_size );
+    Scratch_Buffer<f32> ring( m_height * span );
+    Scratch_Buffer<f32> sums( span );
+
+    // The rows read for output rows [y_begin, y_end)
+    const std::size_t r_begin = y_begin - offset_j;
+    const std::size_t r_end   = y_end - offset_j + m_height - 1;
+
+    for( std::size_t r = r_begin; r < r_end; ++r ){
+
+      // Horizontal pass of row r
+      f32* row = &ring[(r % m_height) * span];
+
+      widen_row( reinterpret_cast<const ubyte*>( in_image.row( r - in_top ) ), &widened[0], row_size );
+      for( std::size_t k = 0; k < span; ++k ){
+        row[k] = 0;
+      }
+      for( std::size_t i = 0; i < m_width; ++i ){
+        accumulate_row( row, &widened[left + i * channels], m_taps_x[i], span );
+      }
+
+      //-----------------------------------------------------------------------
+
+      // Vertical pass, once the ring holds every row output row y reads
+      if( r + 1 < r_begin + m_height ){
+        continue;
+      }
+      const std::size_t y = r + 1 + offset_j - m_height;
+
+      for( std::size_t k = 0; k < span; ++k ){
+        sums[k] = 0;
+      }
+      for( std::size_t j = 0; j < m_height; ++j ){
+        accumulate_row( &sums[0], &ring[((y - offset_j + j) % m_height) * span], m_taps_y[j], span );
+      }
+
+      narrow_row( &sums[0], reinterpret_cast<ubyte*>( out_image.row( y - out_top ) + x_begin ), m_abs_sum, span );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  /// The fewest values across a block of fft_interior()
+  static const std::size_t FFT_MIN_BLOCK = 64;
+
+  // A sum within a rounding error of an integer is taken to be that integer,
+  // as it is exactly for an integer kernel
+  static inline f32 snap_sum( f64 sum ){
+    const f64 nearest = std::floor( sum + 0.5 );
+    return (f32) ((std::fabs( sum - nearest ) < 1e-6) ? nearest : sum);
+  }
+
+  //
+  // The interior is cut into blocks, and each is convolved in the frequency
+  // domain: the pixels the block's taps reach are transformed, multiplied
+  // by the transform of the kernel, and transformed back. The transforms
+  // wrap around, so only the outputs whose taps all fall within the block
+  // are kept; blocks of about four kernels across keep most of them, and
+  // the transform's cost per output grows again past that.
+  //
+  // The channels are real, as is the kernel, so two are transformed
+  // together as the real and imaginary parts of one block and stay apart.
+  // Along each band of blocks the channels are paired in turn: red and
+  // green, blue and the next block's red, and so on, or on a grayscale
+  // page one block and the next. The sums are gathered for the whole band
+  // and then narrowed a row at a time.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::fft_interior( const Image_View<const Pixel>& in_image,
+                                            std::size_t in_top,
+                                            const Image_View<Pixel>& out_image,
+                                            std::size_t out_top,
+                                            std::size_t x_begin,
+                                            std::size_t x_end,
+                                            std::size_t y_begin,
+                                            std::size_t y_end ) const{
+    typedef FFT::complex_type complex_type;
+
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t offset_i = (m_width / 2);
+    const std::size_t offset_j = (m_height / 2);
+    const std::size_t columns  = x_end - x_begin;
+    const std::size_t rows     = y_end - y_begin;
+    const std::size_t span     = columns * channels;
+
+    const FFT fft_x( FFT::fast_size( std::min( std::max( 4 * m_width, FFT_MIN_BLOCK ), columns + m_width - 1 ) ) );
+    const FFT fft_y( FFT::fast_size( std::min( std::max( 4 * m_height, FFT_MIN_BLOCK ), rows + m_height - 1 ) ) );
+
+    const std::size_t size_x  = fft_x.size();
+    const std::size_t size_y  = fft_y.size();
+    const std::size_t block_x = size_x - m_width + 1;
+    const std::size_t block_y = size_y - m_height + 1;
+    const std::size_t signals = ((columns + block_x - 1) / block_x) * channels;
+
+    Scratch_Buffer<complex_type> kernel( size_x * size_y );
+    Scratch_Buffer<complex_type> block( size_x * size_y );
+    Scratch_Buffer<complex_type> scratch( fft_2d_scratch( fft_x, fft_y ) );
+    Scratch_Buffer<f32>          sums( block_y * span );
+
+    // Tap (i, j) reads (x + i, y + j), so it goes at (-i, -j); the inverse
+    // transform's division by the size is folded in
+    const f64 scale = 1.0 / (f64) (size_x * size_y);
+    for( std::size_t i = 0; i < m_width; ++i ){
+      for( std::size_t j = 0; j < m_height; ++j ){
+        kernel[((size_y - j) % size_y) * size_x + (size_x - i) % size_x] = m_taps[i * m_height + j] * scale;
+      }
+    }
+    fft_2d( fft_x, fft_y, &kernel[0], &scratch[0], false );
+
+    //-------------------------------------------------------------------------
+
+    for( std::size_t by = y_begin; by < y_end; by += block_y ){
+      const std::size_t out_rows = std::min( block_y, y_end - by );
+      const std::size_t in_rows  = out_rows + m_height - 1;
+
+      for( std::size_t s = 0; s < signals; s += 2 ){
+        const std::size_t pair = std::min<std::size_t>( 2, signals - s );
+
+        std::fill( block.data(), block.data() + block.size(), complex_type() );
+
+        // Signal s goes in the real parts, and signal s + 1 the imaginary
+        for( std::size_t half = 0; half < pair; ++half ){
+          const std::size_t bx         = x_begin + ((s + half) / channels) * block_x;
+          const std::size_t c          = (s + half) % channels;
+          const std::size_t in_columns = std::min( block_x, x_end - bx ) + m_width - 1;
+
+          for( std::size_t r = 0; r < in_rows; ++r ){
+            const ubyte*  in = reinterpret_cast<const ubyte*>( in_image.row( by - offset_j + r - in_top ) + (bx - offset_i) ) + c;
+            complex_type* to = &block[r * size_x];
+
+            for( std::size_t u = 0; u < in_columns; ++u ){
+              to[u] = half ? complex_type( to[u].real(), in[u * channels] )
+                           : complex_type( in[u * channels], 0 );
+            }
+          }
+        }
+
+        fft_2d( fft_x, fft_y, &block[0], &scratch[0], false );
+        for( std::size_t k = 0; k < kernel.size(); ++k ){
+          block[k] = fft_multiply( block[k], kernel[k] );
+        }
+        fft_2d( fft_x, fft_y, &block[0], &scratch[0], true );
+
+        //---------------------------------------------------------------------
+
+        for( std::size_t half = 0; half < pair; ++half ){
+          const std::size_t bx          = x_begin + ((s + half) / channels) * block_x;
+          const std::size_t c           = (s + half) % channels;
+          const std::size_t out_columns = std::min( block_x, x_end - bx );
+
+          for( std::size_t v = 0; v < out_rows; ++v ){
+            const complex_type* from = &block[v * size_x];
+            f32*                to   = &sums[v * span + (bx - x_begin) * channels + c];
+
+            for( std::size_t u = 0; u < out_columns; ++u ){
+              to[u * channels] = snap_sum( half ? from[u].imag() : from[u].real() );
+            }
+          }
+        }
+      }
+
+      for( std::size_t v = 0; v < out_rows; ++v ){
+        narrow_row( &sums[v * span],
+                    reinterpret_cast<ubyte*>( out_image.row( by + v - out_top ) + x_begin ),
+                    m_abs_sum,
+                    span );
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Blurs
+  //---------------------------------------------------------------------------
+
+  /// The columns in each strip of a recursive blur's columns
+  static const std::size_t RECURSIVE_STRIP = 64;
+
+  // Rounds a filtered level to the nearest of 0 to 255
+  static inline ubyte round_level( f32 level ){
+    return (level <= 0) ? 0 : (level >= 255) ? 255 : (ubyte) (level + 0.5f);
+  }
+
+  //
+  // The boxes run down the page first: each keeps a running sum of whole
+  // rows, fed the rows that the box before it gives out. The rows that
+  // leave the first box are read again from the page, and those that leave
+  // the others are kept in a ring. Each row the last box gives out is run
+  // through the boxes across the row, and divided by the number of taps.
+  // The rows and columns off the page are read through the edge handling
+  // as they are needed. The sums are exact, so the result does not depend
+  // on the row a tile starts them from.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::box_blur( const Image_View<const Pixel>& in_image,
+                                        std::size_t in_top,
+                                        const Image_View<Pixel>& out_image,
+                                        std::size_t out_top,
+                                        std::size_t height,
+                                        std::size_t first,
+                                        std::size_t last ) const{
+    typedef std::uint64_t sum_type;
+
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t width    = in_image.width();
+    const std::size_t values   = width * channels;
+    const std::size_t reach    = m_height / 2;
+    const std::size_t boxes    = m_box_radii.size();
+
+    // The taps of the boxes along each direction
+    sum_type taps = 1;
+    for( std::size_t k = 0; k < boxes; ++k ){
+      taps *= 2 * m_box_radii[k] + 1;
+    }
+
+    const Scratch_Buffer<ubyte> gray( values, Color_RGB::GRAY.r );
+    const Scratch_Buffer<ubyte> none( values, 0 );
+
+    // The row that row p reads, p being off the page or on it
+    auto page_row = [&]( std::ptrdiff_t p ) -> const ubyte* {
+      const std::ptrdiff_t rows = (std::ptrdiff_t) height;
+
+      if( p < 0 || p >= rows ){
+        switch( m_edge_case ){
+        case edge_is_gray: return &gray[0];
+        case edge_wrap:    p = ((p % rows) + rows) % rows; break;
+        default:           p = (p < 0) ? 0 : rows - 1; break;
+        }
+      }
+      return reinterpret_cast<const ubyte*>( in_image.row( (std::size_t) p - in_top ) );
+    };
+
+    //-------------------------------------------------------------------------
+
+    // The ring of each box after the first, one after the other
+    std::size_t ring_size = 0;
+    for( std::size_t k = 1; k < boxes; ++k ){
+      ring_size += (2 * m_box_radii[k] + 1) * values;
+    }
+
+    Scratch_Buffer<sum_type>    sums( boxes * values, 0 );
+    Scratch_Buffer<sum_type>    rings( ring_size, 0 );
+    Scratch_Buffer<std::size_t> fed( boxes, 0 );
+
+    // A row with reach columns either side, and the next box's result
+    Scratch_Buffer<sum_type> lines( 2 * (width + 2 * reach) * channels );
+    sum_type*                line = lines.data();
+    sum_type*                next = line + (width + 2 * reach) * channels;
+
+    const std::ptrdiff_t begin = (std::ptrdiff_t) first - (std::ptrdiff_t) reach;
+    const std::ptrdiff_t end   = (std::ptrdiff_t) (last + reach);
+    std::size_t          y     = first;
+
+    for( std::ptrdiff_t p = begin; p < end; ++p ){
+      const std::size_t taps_0 = 2 * m_box_radii[0] + 1;
+      const ubyte*      in     = page_row( p );
+      const ubyte*      out    = (p - begin >= (std::ptrdiff_t) taps_0) ? page_row( p - taps_0 ) : &none[0];
+
+      for( std::size_t v = 0; v < values; ++v ){
+        sums[v] += in[v];
+        sums[v] -= out[v];
+      }
+      if( ++fed[0] < taps_0 ){
+        continue;
+      }
+
+      const sum_type* row   = &sums[0];
+      sum_type*       ring  = rings.data();
+      bool            ready = true;
+      for( std::size_t k = 1; k < boxes && ready; ++k ){
+        const std::size_t taps_k = 2 * m_box_radii[k] + 1;
+        sum_type*         slot   = ring + (fed[k] % taps_k) * values;
+        sum_type*         sum    = &sums[k * values];
+
+        for( std::size_t v = 0; v < values; ++v ){
+          sum[v]  += row[v];
+          sum[v]  -= slot[v];
+          slot[v]  = row[v];
+        }
+        ready = (++fed[k] >= taps_k);
+        row   = sum;
+        ring += taps_k * values;
+      }
+      if( !ready ){
+        continue;
+      }
+
+      //-----------------------------------------------------------------------
+
+      // Pad the row out to either side through the edge handling
+      std::copy( row, row + values, &line[reach * channels] );
+      for( std::size_t i = 0; i < reach; ++i ){
+        const std::ptrdiff_t columns = (std::ptrdiff_t) width;
+        const std::ptrdiff_t sides[] = { (std::ptrdiff_t) i - (std::ptrdiff_t) reach,
+                                         columns + (std::ptrdiff_t) i };
+
+        for( std::size_t side = 0; side < 2; ++side ){
+          const std::ptrdiff_t c  = sides[side];
+          sum_type*            to = &line[(c + (std::ptrdiff_t) reach) * channels];
+
+          if( m_edge_case == edge_is_gray ){
+            std::fill( to, to + channels, taps * Color_RGB::GRAY.r );
+            continue;
+          }
+          const std::ptrdiff_t from = (m_edge_case == edge_wrap) ? ((c % columns) + columns) % columns
+                                                                 : ((c < 0) ? 0 : columns - 1);
+          std::copy( row + from * channels, row + (from + 1) * channels, to );
+        }
+      }
+
+      std::size_t length = width + 2 * reach;
+      for( std::size_t k = 0; k < boxes; ++k ){
+        const std::size_t taps_k = 2 * m_box_radii[k] + 1;
+
+        std::fill( &next[0], &next[channels], 0 );
+        for( std::size_t i = 0; i < taps_k; ++i ){
+          for( std::size_t c = 0; c < channels; ++c ){
+            next[c] += line[i * channels + c];
+          }
+        }
+        length -= taps_k - 1;
+        for( std::size_t e = channels; e < length * channels; ++e ){
+          next[e] = next[e - channels] + line[e + channels * (taps_k - 1)] - line[e - channels];
+        }
+        std::swap( line, next );
+      }
+
+      //-----------------------------------------------------------------------
+
+      // Divide through a reciprocal, then correct the quotient by one if
+      // it rounded across an integer
+      const sum_type area       = taps * taps;
+      const f64      reciprocal = 1.0 / (f64) area;
+      ubyte*         result     = reinterpret_cast<ubyte*>( out_image.row( y - out_top ) );
+
+      for( std::size_t v = 0; v < values; ++v ){
+        sum_type quotient = (sum_type) ((f64) line[v] * reciprocal);
+
+        if( (quotient + 1) * area <= line[v] ){
+          ++quotient;
+        }else if( quotient * area > line[v] ){
+          --quotient;
+        }
+        result[v] = (ubyte) std::min<sum_type>( quotient, 255 );
+      }
+
+      if( m_edge_case == edge_crop ){
+        Pixel*     pixels = out_image.row( y - out_top );
+        const bool edge   = (y < reach || y + reach >= height);
+
+        for( std::size_t x = 0; x < width; ++x ){
+          if( edge || x < reach || x + reach >= width ){
+            pixels[x] = Pixel( Color_RGB::BLACK.r );
+          }
+        }
+      }
+      ++y;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // The rows are filtered across the pool a tile at a time, into a page of
+  // floats, and then its columns, side by side in strips of
+  // RECURSIVE_STRIP. The page is cut the same way for any number of
+  // threads, so the result is the same for any.
+  //
+  template<typename Pixel>
+  void Kernel_Image_Operator::recursive_pass( const Kernel_Image_Operator& pass,
+                                              const Image_View<const Pixel>& in_image,
+                                              const Image_View<Pixel>& out_image ) const{
+    const std::size_t channels = channels_of<Pixel>();
+    const std::size_t width    = in_image.width();
+    const std::size_t height   = in_image.height();
+    const std::size_t values   = width * channels;
+    const std::size_t rows     = m_tile_rows;
+    const std::size_t reach    = pass.m_height / 2;
+
+    if( width == 0 || height == 0 ){
+      return;
+    }
+
+    Scratch_Buffer<f32> page( values * height );
+
+    for_each_tile( (height + rows - 1) / rows, [&]( std::size_t tile ){
+      const std::size_t last = std::min( (tile + 1) * rows, height );
+
+      for( std::size_t y = tile * rows; y < last; ++y ){
+        const ubyte* in   = reinterpret_cast<const ubyte*>( in_image.row( y ) );
+        f32*         line = &page[y * values];
+
+        for( std::size_t v = 0; v < values; ++v ){
+          line[v] = in[v];
+        }
+        pass.recursive_lines( line, width, channels, channels );
+      }
+    } );
+
+    //-------------------------------------------------------------------------
+
+    for_each_tile( (width + RECURSIVE_STRIP - 1) / RECURSIVE_STRIP, [&]( std::size_t strip ){
+      const std::size_t x_begin = strip * RECURSIVE_STRIP;
+      const std::size_t x_end   = std::min( x_begin + RECURSIVE_STRIP, width );
+
+      pass.recursive_lines( &page[x_begin * channels], height, values, (x_end - x_begin) * channels );
+
+      for( std::size_t y = 0; y < height; ++y ){
+        const f32* line = &page[y * values];
+        Pixel*     out  = out_image.row( y );
+        const bool edge = (y < reach || y + reach >= height);
+
+        for( std::size_t x = x_begin; x < x_end; ++x ){
+          if( pass.m_edge_case == edge_crop && (edge || x < reach || x + reach >= width) ){
+            out[x] = Pixel( Color_RGB::BLACK.r );
+            continue;
+          }
+          ubyte* level = reinterpret_cast<ubyte*>( &out[x] );
+          for( std::size_t c = 0; c < channels; ++c ){
+            level[c] = round_level( line[x * channels + c] );
+          }
+        }
+      }
+    } );
+  }
+
+  //---------------------------------------------------------------------------
+
+  //
+  // Steps the recursion, w[n] = B x[n] + b1 w[n-1] + b2 w[n-2] + b3 w[n-3]
+  // with b1 to b3 over b0, over one value of each lane. The state holds
+  // w[n-1], w[n-2] and w[n-3] of every lane in turn.
+  //
+  template<bool Store>
+  static inline void recursive_step( const f64* coefficients,
+                                     f64* state,
+                                     std::size_t lanes,
+                                     const f32* in,
+                                     f32* out ){
+    f64* w1 = state;
+    f64* w2 = state + lanes;
+    f64* w3 = state + 2 * lanes;
+
+    for( std::size_t l = 0; l < lanes; ++l ){
+      const f64 w = coefficients[0] * in[l] + coefficients[1] * w1[l] +
+                    coefficients[2] * w2[l] + coefficients[3] * w3[l];
+      w3[l] = w2[l];
+      w2[l] = w1[l];
+      w1[l] = w;
+      if( Store ){
+        out[l] = (f32) w;
+      }
+    }
+  }
+
+  // Sets the state of every lane to that of a constant run of @p in, or of
+  // gray if there is none
+  static inline void settle_state( f64* state, std::size_t lanes, const f32* in ){
+    for( std::size_t l = 0; l < lanes; ++l ){
+      const f64 value = in ? in[l] : (f64) Color_RGB::GRAY.r;
+      state[l] = state[l + lanes] = state[l + 2 * lanes] = value;
+    }
+  }
+
+  //
+  // Each line is filtered forwards, and then backwards over what that
+  // gives. The forward pass starts from the steady state of the values
+  // before the line, or, wrapping, runs in over the last of them. It then
+  // runs on past the end over the values after the line, and the backward
+  // pass runs in over what that gives. The state is kept in doubles: for a
+  // large sigma B is small, and the feedback all but cancels it.
+  //
+  void Kernel_Image_Operator::recursive_lines( f32* data,
+                                               std::size_t length,
+                                               std::size_t stride,
+                                               std::size_t lanes ) const{
+    const std::size_t reach = m_height / 2;
+    const std::size_t warm  = (m_edge_case == edge_wrap) ? std::min( length, reach ) : reach;
+
+    Scratch_Buffer<f64> state( 3 * lanes );
+    Scratch_Buffer<f32> after( warm * lanes );
+    Scratch_Buffer<f32> tail( warm * lanes );
+
+    // The values after the line, before the forward pass overwrites them
+    for( std::size_t n = 0; n < warm; ++n ){
+      const f32* from = nullptr;
+
+      switch( m_edge_case ){
+      case edge_is_gray: break;
+      case edge_wrap:    from = data + n * stride; break;
+      default:           from = data + (length - 1) * stride; break;
+      }
+      for( std::size_t l = 0; l < lanes; ++l ){
+        after[n * lanes + l] = from ? from[l] : (f32) Color_RGB::GRAY.r;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+
+    switch( m_edge_case ){
+
+    case edge_is_gray:
+      settle_state( &state[0], lanes, nullptr );
+      break;
+
+    case edge_wrap:
+      settle_state( &state[0], lanes, data + (length - warm) * stride );
+      for( std::size_t n = length - warm; n < length; ++n ){
+        recursive_step<false>( m_recursive, &state[0], lanes, data + n * stride, nullptr );
+      }
+      break;
+
+    default:
+      settle_state( &state[0], lanes, data );
+      break;
+    }
+
+    for( std::size_t n = 0; n < length; ++n ){
+      recursive_step<true>( m_recursive, &state[0], lanes, data + n * stride, data + n * stride );
+    }
+
+    //-------------------------------------------------------------------------
+
+    if( warm > 0 ){
+      for( std::size_t n = 0; n < warm; ++n ){
+        recursive_step<true>( m_recursive, &state[0], lanes, &after[n * lanes], &tail[n * lanes] );
+      }
+      settle_state( &state[0], lanes, &tail[(warm - 1) * lanes] );
+      for( std::size_t n = warm; n-- > 0; ){
+        recursive_step<false>( m_recursive, &state[0], lanes, &tail[n * lanes], nullptr );
+      }
+    }else{
+      settle_state( &state[0], lanes, data + (length - 1) * stride );
+    }
+
+    for( std::size_t n = length; n-- > 0; ){
+      recursive_step<true>( m_recursive, &state[0], lanes, data + n * stride, data + n * stride );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  Pixel Kernel_Image_Operator::border_pixel( const Image_View<const Pixel>& in_image,
+                                             std::size_t in_top,
+                                             std::size_t height,
+                                             u32 x,
+                                             u32 y,
+                                             Pixel* values ) const{
+
+    const std::size_t channels = channels_of<Pixel>();
+
+    const u32 offset_i = (m_width / 2);
+    const u32 offset_j = (m_height / 2);
+    const int top      = (int) in_top;
+
+    const bool on_top_boundary    = (y < offset_j);
+    const bool on_right_boundary  = (x > (in_image.width() - 1 - offset_i));
+    const bool on_bottom_boundary = (y > (height - 1 - offset_j));
+    const bool on_left_boundary   = (x < offset_i);
+
+    s32 accumulators[3] = { 0, 0, 0 };
+
+    //-------------------------------------------------------------------------
+
+    // If edge case crops, then just take the original pixel
+    if( m_edge_case == edge_crop ){
+      return Pixel( Color_RGB::BLACK.r );
+    }
+
+    // Loop through the operators
+    for( s32 i = -offset_i; i <= (s32) offset_i; ++i ){
+      for( s32 j = -offset_j; j <= (s32) offset_j; ++j ){
+        Pixel& value = values[(i + offset_i) * m_height + (j + offset_j)];
+
+        // If on edge case, handle edge case
+        if( (on_top_boundary  && (j < 0)) ||
+            (on_left_boundary && (i < 0)) ||
+            (on_right_boundary && (i > 0)) ||
+            (on_bottom_boundary && (j > 0))
+          ){
+
+          switch(m_edge_case){
+
+          case edge_extend:
+            value = in_image.at(
+              on_left_boundary ? 0 : on_right_boundary  ? in_image.width() - 1 : x,
+              (int) (on_top_boundary ? 0 : on_bottom_boundary ? height - 1 : y) - top
+            );
+            break;
+
+          //-------------------------------------------------------------------
+
+          case edge_is_gray:
+            value = Pixel( Color_RGB::GRAY.r );
+            break;
+
+          //-------------------------------------------------------------------
+
+          case edge_wrap:
+            value = in_image.at(
+              on_left_boundary ? in_image.width() + i - 1 : on_right_boundary ? i : x,
+              (int) (on_top_boundary ? height + j - 1 : on_bottom_boundary ? j : y) - top
+            );
+            break;
+
+          //-------------------------------------------------------------------
+
+          default:
+            // Shouldn't happen
+            break;
+          }
+        }else{
+          value = in_image.at( x + i, y + j - top );
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+
+    // Calculate the sum of all operations; a separable kernel's is exact,
+    // to agree with separable_interior(), and a large kernel's is exact in
+    // double precision, to agree with fft_interior()
+    if( m_separable ){
+      f32 sums[3] = { 0, 0, 0 };
+      for( std::size_t k = 0; k < m_taps.size(); ++k ){
+        const ubyte* channel = reinterpret_cast<const ubyte*>( &values[k] );
+
+        for( std::size_t c = 0; c < channels; ++c ){
+          sums[c] += m_taps[k] * channel[c];
+        }
+      }
+      for( std::size_t c = 0; c < channels; ++c ){
+        accumulators[c] = (s32) sums[c];
+      }
+    }else if( fft_convolved() ){
+      f64 sums[3] = { 0, 0, 0 };
+      for( std::size_t k = 0; k < m_taps.size(); ++k ){
+        const ubyte* channel = reinterpret_cast<const ubyte*>( &values[k] );
+
+        for( std::size_t c = 0; c < channels; ++c ){
+          sums[c] += (f64) m_taps[k] * channel[c];
+        }
+      }
+      for( std::size_t c = 0; c < channels; ++c ){
+        accumulators[c] = (s32) snap_sum( sums[c] );
+      }
+    }else{
+      for( std::size_t k = 0; k < m_taps.size(); ++k ){
+        const ubyte* channel = reinterpret_cast<const ubyte*>( &values[k] );
+
+        for( std::size_t c = 0; c < channels; ++c ){
+          accumulators[c] += m_taps[k] * channel[c];
+        }
+      }
+    }
+
+    Pixel  result;
+    ubyte* channel = reinterpret_cast<ubyte*>( &result );
+    for( std::size_t c = 0; c < channels; ++c ){
+      channel[c] = clamp_sum( accumulators[c], m_abs_sum );
+    }
+    return result;
   }
 
   //---------------------------------------------------------------------------
@@ -13,6 +13,19 @@
  *
  * Sep 23, 2015: 
  * - Image Operator.hpp created
+ *
+ * Oct 17, 2026:
+ * - Operations read from views and move their results out
+ * - The kernel is flipped once, at construction
+ * - Separable kernels run as two 1-D passes
+ * - The interior runs through vectorized row primitives
+ * - Large images are operated on in tiles, across a thread pool
+ * - Chains run fused per tile, and may be pre-convolved into fewer kernels
+ * - Integer kernels run in 16-bit fixed point
+ * - 3x3, 5x5 and 7x7 fixed point kernels are unrolled for their size
+ * - Large kernels are convolved through the FFT
+ * - Box, box Gaussian and recursive Gaussian blurs, at any size
+ * - Grayscale images are operated on as a single plane
  */
 #ifndef OCR_KERNEL_IMAGE_OPERATOR_HPP_
 #define OCR_KERNEL_IMAGE_OPERATOR_HPP_
@@ -22,8 +35,12 @@
 #endif
 
 #include "Image.hpp"
+#include "Pixel_Image.hpp"
+#include "Thread_Pool.hpp"
 
+#include <functional> // std::function
 #include <list>
+#include <memory>     // std::unique_ptr
 #include <vector>
 
 namespace ocr {
@@ -46,6 +63,36 @@ namespace ocr {
     typedef Image::pixel_type             pixel_type;
     typedef std::vector<std::vector<f32>> vector_2d_type;
 
+    //-------------------------------------------------------------------------
+    // Public Constants
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief The largest difference, relative to the largest tap, between
+    ///        a kernel and the outer product it is factored into
+    ///
+    static const f32 SEPARABLE_TOLERANCE;
+
+    ///
+    /// @brief The rows of each tile, unless set_tile_rows() says otherwise
+    ///
+    static const std::size_t DEFAULT_TILE_ROWS = 64;
+
+    ///
+    /// @brief The fewest taps at which a kernel that is neither separable
+    ///        nor fixed point is convolved through the FFT
+    ///
+    /// On 2000x1500 pages the two break even at 19x19, and the transform is
+    /// faster from 21x21 on; see fft_convolved().
+    ///
+    static const std::size_t FFT_CROSSOVER_AREA = 21 * 21;
+
+    ///
+    /// @brief The boxes a box Gaussian blur takes in turn
+    ///
+    static const std::size_t BOX_GAUSSIAN_PASSES = 3;
+
     enum edge_handling{
       edge_extend,  ///< The nearest border pixels are conceptually extended as
                     ///< far as necessary to provide values for the convolution.
@@ -61,6 +108,13 @@ namespace ocr {
       edge_is_gray  ///< Outside the boundary is treated as gray
     };
 
+    enum blur_type{
+      blur_none,         ///< Not a blur; the operator convolves with its kernel
+      blur_box,          ///< The mean of a square of pixels
+      blur_box_gaussian, ///< A Gaussian, approximated by boxes in turn
+      blur_recursive     ///< A Gaussian, by Young and van Vliet's recursive filter
+    };
+
     //-------------------------------------------------------------------------
     // Constructor / Destructor / Assignment
     //-------------------------------------------------------------------------
@@ -81,9 +135,50 @@ namespace ocr {
     ///
     Kernel_Image_Operator( f32** kernel, std::size_t width, std::size_t height, edge_handling e = edge_extend );
 
+    ///
+    /// @brief Constructs an operator from an array of fixed size, such as
+    ///        those of Kernel_Library.hpp
+    ///
+    /// Square kernels of 3, 5 and 7 taps a side that run in fixed point are
+    /// summed by code unrolled for their size, with their taps held in
+    /// registers, whichever constructor they come from.
+    ///
     template<size_t N,size_t M>
     Kernel_Image_Operator( const f32 (&kernel)[N][M], edge_handling e = edge_extend );
 
+    ///
+    /// @brief Constructs a blur that costs the same per pixel at any size
+    ///
+    /// A box blur keeps a running sum over a square of @p size pixels to
+    /// each side, horizontally and vertically, adding the pixel that enters
+    /// it and taking away the one that leaves. A box Gaussian blur runs
+    /// BOX_GAUSSIAN_PASSES such boxes in turn, their widths picked for a
+    /// standard deviation of @p size. Both sum exactly, in integers, and
+    /// divide and truncate once at the end. A recursive Gaussian blur runs
+    /// Young and van Vliet's third order filter forwards and backwards
+    /// along each row and then each column, for a standard deviation of
+    /// @p size, at least 0.5, and rounds. It is within a few levels of a
+    /// true Gaussian from a standard deviation of about 3, and coarser
+    /// below that.
+    ///
+    /// Each tap that falls off the page is handled on its own, rather than
+    /// as the ring of a kernel is: edge_extend takes the nearest pixel of
+    /// the page, edge_wrap the pixel on the far side, and edge_is_gray gray;
+    /// edge_crop blackens every pixel within halo() of the edge. The
+    /// recursive filter, whose taps never end, instead runs in over halo()
+    /// pixels beyond each end, 4 standard deviations, taken the same way.
+    ///
+    /// A recursive blur reads the whole page, so it runs its rows and then
+    /// its columns across the page, rather than a tile at a time through a
+    /// chain, and operate_band() only approximates it. Blurs never fuse.
+    ///
+    /// @param blur the kind of blur; blur_none copies the page
+    /// @param size the radius of a box, in pixels, or the standard
+    ///             deviation of a Gaussian
+    /// @param e    Method to handle edge-cases of the image
+    ///
+    Kernel_Image_Operator( blur_type blur, f32 size, edge_handling e = edge_extend );
+
     ///
     ///
     ///
@@ -108,6 +203,14 @@ namespace ocr {
     ///
     Image operate( const Image& image ) const;
 
+    ///
+    /// @brief Perform the operation on the pixels of a view
+    ///
+    /// The view is read in place, so a rectangle of a larger image is
+    /// operated on without first being copied out of it.
+    ///
+    Image operate( const Image::const_view_type& image ) const;
+
     ///
     /// @brief Perform the operation on the supplied image 'n' times
     ///
@@ -115,21 +218,397 @@ namespace ocr {
     ///
     Image operate( const Image& image, std::size_t n ) const;
 
+    Image operate( const Image::const_view_type& image, std::size_t n ) const;
+
+    ///
+    /// @brief Perform the operation on a grayscale image, as a single plane
+    ///
+    /// Each channel of an Image is operated on alone, with the same taps, so
+    /// a page whose channels are all equal gives three equal results. A
+    /// Gray_Image holds just the one channel, and runs every path on it,
+    /// with a third of the arithmetic and memory traffic; the result is
+    /// identical to any channel of operating on the same page as an Image.
+    ///
+    Gray_Image operate( const Gray_Image& image ) const;
+
+    Gray_Image operate( const Gray_Image::const_view_type& image ) const;
+
+    Gray_Image operate( const Gray_Image& image, std::size_t n ) const;
+
+    Gray_Image operate( const Gray_Image::const_view_type& image, std::size_t n ) const;
+
+    ///
+    /// @brief Perform the operation on a band of rows read with a halo
+    ///
+    /// The band must carry at least halo() rows of context above and below
+    /// the rows being computed, unless they lie on the edge of the page. The
+    /// result is then identical to those rows of operate() on the whole
+    /// page. (edge_wrap wraps around the band rather than the page.)
+    ///
+    /// @param band   the band, including its halo rows
+    /// @param first  the band row of the first row to compute
+    /// @param rows   the number of rows to compute
+    /// @return the computed rows
+    ///
+    Image operate_band( const Image& band, std::size_t first, std::size_t rows ) const;
+
+    ///
+    /// @brief Returns the number of rows above and below each pixel that
+    ///        this operation and its chained operations read
+    ///
+    /// @return the halo a band needs for operate_band
+    ///
+    std::size_t halo() const;
+
+    ///
+    /// @brief Returns whether this kernel is separable, and so runs as a
+    ///        horizontal pass followed by a vertical pass, unless it runs in
+    ///        fixed point
+    ///
+    /// A kernel is separable when it is the outer product of a column and a
+    /// row, to within SEPARABLE_TOLERANCE of its largest tap; a Gaussian or
+    /// a box is, for instance. Each pixel then costs width + height taps
+    /// instead of width * height.
+    ///
+    /// A separable kernel's taps are summed in floating point and truncated
+    /// once, rather than truncated as each tap is added. For integer kernels
+    /// the two are identical. For fractional kernels, such as the generated
+    /// Gaussians, truncating each tap loses about half a level per tap, so
+    /// the separable result is brighter by about that much (about 11 levels
+    /// for a 5x5) and is the true convolution.
+    ///
+    bool separable() const;
+
+    ///
+    /// @brief Returns whether the interior runs in 16-bit fixed point
+    ///
+    /// A kernel of integer taps whose sums over 8-bit channels always fit in
+    /// 16 bits is summed in 16-bit integer lanes, twice as many to a vector
+    /// as floats, and the division by the absolute sum becomes a multiply
+    /// and a shift. The multiplier is checked at construction against every
+    /// sum the kernel can produce, to divide each exactly as the floating
+    /// point path does, so the result is bit-identical either way. A
+    /// separable kernel only runs in fixed point while its two passes would
+    /// take at least half as many taps, as for a 3x3.
+    ///
+    bool fixed_point() const;
+
+    ///
+    /// @brief Returns whether the interior is convolved through the FFT
+    ///
+    /// The direct sum costs a multiply for each tap at every pixel, so a
+    /// large kernel, with FFT_CROSSOVER_AREA taps or more, is instead
+    /// convolved a block at a time in the frequency domain, in O(log n) per
+    /// pixel. Separable and fixed point kernels are cheaper as they are.
+    ///
+    /// The sums are computed in double precision and are within a rounding
+    /// error of exact, so an integer kernel's result is identical to the
+    /// direct sum's. As for a separable kernel, a fractional kernel's sum is
+    /// truncated once, not as each tap is added, and so is brighter than
+    /// the direct sum by about half a level per tap.
+    ///
+    bool fft_convolved() const;
+
+    ///
+    /// @brief Returns the kind of blur this operator runs, or blur_none for
+    ///        a kernel
+    ///
+    blur_type blur() const;
+
     //-------------------------------------------------------------------------
-    // Private Methods
+    // Parallelism
     //-------------------------------------------------------------------------
-  private:
+  public:
+
+    ///
+    /// @brief Sets the number of threads that operate() runs on
+    ///
+    /// With more than one thread, the page is cut into tiles of whole rows
+    /// that are handed out to a thread pool owned by this operator, with the
+    /// calling thread taking tiles as well. Each tile is taken through this
+    /// operation and every chained operation before the next is started, so
+    /// that the rows it reads are still in cache; the rows around the tile
+    /// that the kernels reach into are recomputed by each tile that needs
+    /// them. If a chained operation wraps at the edge, and so reads the far
+    /// side of the page, each operation is instead finished over the whole
+    /// page before the next starts, still in parallel tiles.
+    ///
+    /// The result is identical for any number of threads and any tile size.
+    /// Only the settings of the operator that operate() is called on are
+    /// used; those of chained operators are not. One thread, the default,
+    /// operates on the calling thread alone.
+    ///
+    /// @param threads the number of threads; 0 uses one per hardware thread
+    ///
+    void set_threads( std::size_t threads );
+
+    std::size_t threads() const;
+
+    ///
+    /// @brief Sets the rows in each tile when running on several threads,
+    ///        or through a chain of operations
+    ///
+    /// Smaller tiles balance better across threads and stay in cache; larger
+    /// tiles recompute fewer rows around them for chained operations.
+    ///
+    /// @param rows the rows in each tile; at least 1
+    ///
+    void set_tile_rows( std::size_t rows );
+
+    std::size_t tile_rows() const;
 
+    //-------------------------------------------------------------------------
+    // Fusion
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Sets whether adjacent passes may be convolved together into a
+    ///        single kernel before operating
+    ///
+    /// Convolving a kernel with another gives the kernel of applying them
+    /// one after the other, so a chain of blurs can run as one pass. Two
+    /// passes are only fused if they have the same edge handling, are both
+    /// square with odd sides, have no negative taps (so the pass between
+    /// them could never have clamped) and the fused kernel takes no more
+    /// taps per pixel than the two did; separable kernels fuse into a
+    /// separable kernel, so chains of them collapse into one pass.
     ///
+    /// Fusing skips the truncation of the pass between, so the interior of
+    /// the result is brighter by about a level for each pass fused away.
+    /// Within half of the fused kernel of the edge, the edge handling is
+    /// applied once to the fused kernel rather than once per pass, and the
+    /// results there differ further. Fusion is off by default; whether or
+    /// not it is on, a chain runs one tile at a time through every pass.
     ///
-    void do_operation( const Image& in_image, Image& out_image ) const;
+    /// @param fuse whether to fuse kernels
+    ///
+    void set_kernel_fusion( bool fuse );
+
+    bool kernel_fusion() const;
 
     //-------------------------------------------------------------------------
     // Private Member Types
     //-------------------------------------------------------------------------
   private:
 
-    typedef std::list<const Kernel_Image_Operator*> Operators;
+    typedef std::list<const Kernel_Image_Operator*>   Operators;
+    typedef std::vector<const Kernel_Image_Operator*> pass_list;
+
+    ///
+    /// @struct execution_plan
+    ///
+    /// @brief The passes an operation makes, after fusion, and the fused
+    ///        operators that it owns
+    ///
+    struct execution_plan{
+      pass_list passes;
+      std::vector<std::unique_ptr<Kernel_Image_Operator>> fused;
+    };
+
+    //-------------------------------------------------------------------------
+    // Private Methods
+    //-------------------------------------------------------------------------
+  private:
+
+    ///
+    /// @brief Performs the operation @p n times, and then each chained
+    ///        operation, on an Image or a Gray_Image
+    ///
+    template<typename Image_Type>
+    Image_Type operate_image( const typename Image_Type::const_view_type& image,
+                              std::size_t n ) const;
+
+    ///
+    /// @brief Computes rows [@p first, @p last) of a page @p height rows tall
+    ///
+    /// Only some rows of the page need to be in memory: the input rows are
+    /// those from page row @p in_top, and the output rows those from page
+    /// row @p out_top. The input must hold every row the kernel reaches
+    /// from the rows being computed.
+    ///
+    /// A Pixel of one byte is one plane, and of three is r, g and b
+    /// interleaved; each channel is computed alone, with the same taps.
+    ///
+    template<typename Pixel>
+    void do_operation( const Image_View<const Pixel>& in_image,
+                       std::size_t in_top,
+                       const Image_View<Pixel>& out_image,
+                       std::size_t out_top,
+                       std::size_t height,
+                       std::size_t first,
+                       std::size_t last ) const;
+
+    ///
+    /// @brief Computes one pixel within half a kernel of the edge, applying
+    ///        the edge handling to the taps that fall outside of the image
+    ///
+    /// @param values scratch for the taps; m_width * m_height pixels
+    ///
+    template<typename Pixel>
+    Pixel border_pixel( const Image_View<const Pixel>& in_image,
+                        std::size_t in_top,
+                        std::size_t height,
+                        u32 x,
+                        u32 y,
+                        Pixel* values ) const;
+
+    ///
+    /// @brief Runs the kernel over the interior of the image, the pixels
+    ///        more than half a kernel from every edge
+    ///
+    template<typename Pixel>
+    void direct_interior( const Image_View<const Pixel>& in_image,
+                          std::size_t in_top,
+                          const Image_View<Pixel>& out_image,
+                          std::size_t out_top,
+                          std::size_t x_begin,
+                          std::size_t x_end,
+                          std::size_t y_begin,
+                          std::size_t y_end ) const;
+
+    ///
+    /// @brief Runs a separable kernel over the interior of the image, as a
+    ///        horizontal pass into a ring of rows and a vertical pass out
+    ///        of it
+    ///
+    template<typename Pixel>
+    void separable_interior( const Image_View<const Pixel>& in_image,
+                             std::size_t in_top,
+                             const Image_View<Pixel>& out_image,
+                             std::size_t out_top,
+                             std::size_t x_begin,
+                             std::size_t x_end,
+                             std::size_t y_begin,
+                             std::size_t y_end ) const;
+
+    ///
+    /// @brief Runs an integer kernel over the interior of the image, in
+    ///        16-bit fixed point
+    ///
+    template<typename Pixel>
+    void fixed_interior( const Image_View<const Pixel>& in_image,
+                         std::size_t in_top,
+                         const Image_View<Pixel>& out_image,
+                         std::size_t out_top,
+                         std::size_t x_begin,
+                         std::size_t x_end,
+                         std::size_t y_begin,
+                         std::size_t y_end ) const;
+
+    ///
+    /// @brief Runs the kernel over the interior of the image through the
+    ///        FFT, a block at a time
+    ///
+    template<typename Pixel>
+    void fft_interior( const Image_View<const Pixel>& in_image,
+                       std::size_t in_top,
+                       const Image_View<Pixel>& out_image,
+                       std::size_t out_top,
+                       std::size_t x_begin,
+                       std::size_t x_end,
+                       std::size_t y_begin,
+                       std::size_t y_end ) const;
+
+    ///
+    /// @brief Computes rows [@p first, @p last) of a box or box Gaussian
+    ///        blur, edge included, as do_operation() does for a kernel
+    ///
+    template<typename Pixel>
+    void box_blur( const Image_View<const Pixel>& in_image,
+                   std::size_t in_top,
+                   const Image_View<Pixel>& out_image,
+                   std::size_t out_top,
+                   std::size_t height,
+                   std::size_t first,
+                   std::size_t last ) const;
+
+    ///
+    /// @brief Runs the recursive blur @p pass over the whole page, its rows
+    ///        and then its columns across this operator's pool
+    ///
+    template<typename Pixel>
+    void recursive_pass( const Kernel_Image_Operator& pass,
+                         const Image_View<const Pixel>& in_image,
+                         const Image_View<Pixel>& out_image ) const;
+
+    ///
+    /// @brief Runs the recursive filter forwards and then backwards along
+    ///        @p lanes lines of @p length values at once, in place
+    ///
+    /// @param data   the first value of the first line
+    /// @param length the values along each line
+    /// @param stride the distance from one value of a line to the next
+    /// @param lanes  the lines, side by side
+    ///
+    void recursive_lines( f32* data,
+                          std::size_t length,
+                          std::size_t stride,
+                          std::size_t lanes ) const;
+
+    ///
+    /// @brief Plans the passes of this operation @p n times, then of each
+    ///        chained operation, fusing kernels if asked to
+    ///
+    void make_plan( std::size_t n, execution_plan& plan ) const;
+
+    ///
+    /// @brief Returns whether @p second can be fused onto @p first
+    ///
+    static bool can_fuse( const Kernel_Image_Operator& first,
+                          const Kernel_Image_Operator& second );
+
+    ///
+    /// @brief Returns the operator that applies @p first, then @p second
+    ///
+    static Kernel_Image_Operator* fuse( const Kernel_Image_Operator& first,
+                                        const Kernel_Image_Operator& second );
+
+    ///
+    /// @brief Returns the taps each interior pixel costs
+    ///
+    std::size_t taps() const;
+
+    ///
+    /// @brief Runs @p task for each of @p tiles tiles, across the pool
+    ///
+    void for_each_tile( std::size_t tiles,
+                        const std::function<void(std::size_t)>& task ) const;
+
+    ///
+    /// @brief Takes rows [@p first, @p last) of @p source through every
+    ///        pass, into the same rows of @p target
+    ///
+    template<typename Image_Type>
+    void flow_tile( const pass_list& passes,
+                    const typename Image_Type::const_view_type& source,
+                    const typename Image_Type::view_type& target,
+                    std::size_t first,
+                    std::size_t last ) const;
+
+    ///
+    /// @brief Stores the kernel flipped into m_taps, in the order that the
+    ///        taps are visited, and factors it if it is separable
+    ///
+    void prepare_kernel();
+
+    ///
+    /// @brief Factors m_taps into m_taps_x and m_taps_y, if it is separable
+    ///
+    void factor_kernel();
+
+    ///
+    /// @brief Quantizes m_taps into m_fixed_taps, with the multiplier and
+    ///        shift that divide by m_abs_sum, if the kernel is exact in
+    ///        16-bit fixed point and no cheaper as a separable kernel
+    ///
+    void prepare_fixed_point();
+
+    ///
+    /// @brief Picks the box radii or the recursive filter's coefficients of
+    ///        a blur of @p size, and sizes its reach
+    ///
+    void prepare_blur( f32 size );
 
     //-------------------------------------------------------------------------
     // Private Members
@@ -141,8 +620,24 @@ namespace ocr {
     std::size_t  m_height;          ///< The height of the kernel
     f32     m_abs_sum;         ///< The absolute sum of all kernel values
     edge_handling m_edge_case; ///< How to handle pixels on the edge
+    std::vector<f32> m_taps;   ///< The kernel, flipped; m_width * m_height
+    std::vector<f32> m_taps_x; ///< The horizontal factor of m_taps, if separable
+    std::vector<f32> m_taps_y; ///< The vertical factor of m_taps, if separable
+    bool    m_separable;       ///< Whether m_taps factors into m_taps_x, m_taps_y
+    std::vector<u16> m_fixed_taps; ///< m_taps as 16-bit integers, if fixed point
+    u32     m_fixed_multiplier; ///< Multiplies a fixed point sum...
+    u32     m_fixed_shift;      ///< ...then shifts it right, to divide it
+    bool    m_fixed_point;      ///< Whether the interior runs in fixed point
+    blur_type m_blur;           ///< The blur, or blur_none for a kernel
+    std::vector<std::size_t> m_box_radii; ///< The radius of each box, if a box blur
+    f64     m_recursive[4];     ///< B, then b1, b2 and b3 over b0, if recursive
 
     Operators m_operators;     ///< List of remaining operators to perform
+
+    std::size_t  m_threads;     ///< Threads that operate() runs on
+    std::size_t  m_tile_rows;   ///< Rows in each tile
+    std::unique_ptr<Thread_Pool> m_pool; ///< Workers, if m_threads > 1
+    bool         m_fuse_kernels; ///< Whether to fuse adjacent kernels
   };
 
   //---------------------------------------------------------------------------
@@ -154,7 +649,11 @@ namespace ocr {
     :  m_width(M),
       m_height(N),
       m_abs_sum(0), // set accumulator to 0
-      m_edge_case(e)
+      m_edge_case(e),
+      m_blur(blur_none),
+      m_threads(1),
+      m_tile_rows(DEFAULT_TILE_ROWS),
+      m_fuse_kernels(false)
   {
     // Allocate memory for operator
     m_kernel = new f32*[m_height];
@@ -174,6 +673,8 @@ namespace ocr {
     if(m_abs_sum < 0){
       m_abs_sum = -m_abs_sum;
     }
+
+    prepare_kernel();
   }
 
 } // namespace ocr
@@ -0,0 +1,175 @@
+/**
+ * @file Kernel_Library.hpp
+ *
+ * @brief This header defines the kernels shipped in data/kernels as
+ *        compile-time constants.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Kernel_Library.hpp created
+ */
+#ifndef OCR_KERNEL_LIBRARY_HPP_
+#define OCR_KERNEL_LIBRARY_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @namespace ocr::kernels
+  ///
+  /// @brief The kernels of data/kernels, tap for tap
+  ///
+  /// Each is an array of fixed size, so it is given straight to the
+  /// Kernel_Image_Operator constructor that takes one, without a file or a
+  /// parser:
+  ///
+  /// @code
+  /// Kernel_Image_Operator op( kernels::sharpen );
+  /// @endcode
+  ///
+  /// Every 3x3 kernel here runs in 16-bit fixed point. The unsharp kernel
+  /// overflows 16 bits, and the 5x5 Gaussian blur is cheaper as separable
+  /// passes, so those two run in floating point.
+  /////////////////////////////////////////////////////////////////////////////
+  namespace kernels {
+
+    //-------------------------------------------------------------------------
+    // identity.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 identity[3][3] = {
+      { 0, 0, 0 },
+      { 0, 1, 0 },
+      { 0, 0, 0 }
+    };
+
+    //-------------------------------------------------------------------------
+    // sharpen.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 sharpen[3][3] = {
+      {  0, -1,  0 },
+      { -1,  5, -1 },
+      {  0, -1,  0 }
+    };
+
+    constexpr f32 high_sharpen[3][3] = {
+      { -1, -1, -1 },
+      { -1,  9, -1 },
+      { -1, -1, -1 }
+    };
+
+    //-------------------------------------------------------------------------
+    // unsharp.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 unsharp[5][5] = {
+      {  1,  4,    6,  4, 1 },
+      {  4, 16,   24, 16, 4 },
+      { 16, 24, -476, 24, 6 },
+      {  4, 16,   24, 16, 4 },
+      {  1,  4,    6,  4, 1 }
+    };
+
+    //-------------------------------------------------------------------------
+    // low_pass.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 average_low_pass[3][3] = {
+      { 1, 1, 1 },
+      { 1, 1, 1 },
+      { 1, 1, 1 }
+    };
+
+    constexpr f32 weak_low_pass[3][3] = {
+      { 0, 1, 0 },
+      { 1, 4, 1 },
+      { 0, 1, 0 }
+    };
+
+    //-------------------------------------------------------------------------
+    // gaussian_blur.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 gaussian_blur_3x3[3][3] = {
+      { 1, 2, 1 },
+      { 2, 4, 2 },
+      { 1, 2, 1 }
+    };
+
+    constexpr f32 gaussian_blur_5x5[5][5] = {
+      { 1, 2,  4, 2, 1 },
+      { 2, 4,  8, 4, 2 },
+      { 4, 8, 16, 8, 4 },
+      { 2, 4,  8, 4, 2 },
+      { 1, 2,  4, 2, 1 }
+    };
+
+    //-------------------------------------------------------------------------
+    // edge_detection.kernel
+    //-------------------------------------------------------------------------
+
+    constexpr f32 edge_detection[3][3] = {
+      {  1, 0, -1 },
+      {  0, 0,  0 },
+      { -1, 0,  1 }
+    };
+
+    constexpr f32 top_edge_detection[3][3] = {
+      { -1, -1, -1 },
+      {  0,  0,  0 },
+      {  1,  1,  1 }
+    };
+
+    constexpr f32 right_edge_detection[3][3] = {
+      { 1, 0, -1 },
+      { 1, 0, -1 },
+      { 1, 0, -1 }
+    };
+
+    constexpr f32 bottom_edge_detection[3][3] = {
+      {  1,  1,  1 },
+      {  0,  0,  0 },
+      { -1, -1, -1 }
+    };
+
+    constexpr f32 left_edge_detection[3][3] = {
+      { -1, 0, 1 },
+      { -1, 0, 1 },
+      { -1, 0, 1 }
+    };
+
+    constexpr f32 average_edge_detection[3][3] = {
+      {  0, -1,  0 },
+      { -1,  4, -1 },
+      {  0, -1,  0 }
+    };
+
+    constexpr f32 high_edge_detection[3][3] = {
+      { -1, -1, -1 },
+      { -1,  8, -1 },
+      { -1, -1, -1 }
+    };
+
+    constexpr f32 sobel_edge_detection[3][3] = {
+      { -1, 0, 1 },
+      { -2, 0, 2 },
+      { -1, 0, 1 }
+    };
+
+  } // namespace kernels
+} // namespace ocr
+
+#endif /* OCR_KERNEL_LIBRARY_HPP_ */
@@ -0,0 +1,172 @@
+/**
+ * @file Mapped_File.cpp
+ *
+ * @brief This source defines the platform-specific file mapping routines.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Mapped_File.cpp created
+ */
+#include "Mapped_File.hpp"
+
+#if defined(_WIN32)
+# ifndef WIN32_LEAN_AND_MEAN
+#   define WIN32_LEAN_AND_MEAN
+# endif
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor
+  //---------------------------------------------------------------------------
+
+  Mapped_File::Mapped_File()
+    : m_data(NULL),
+      m_size(0)
+#if defined(_WIN32)
+      ,
+      m_file(NULL),
+      m_mapping(NULL)
+#endif
+  {
+
+  }
+
+  Mapped_File::~Mapped_File(){
+    close();
+  }
+
+  //---------------------------------------------------------------------------
+  // Mapping
+  //---------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+  bool Mapped_File::open( const char* filename ){
+    close();
+
+    HANDLE file = ::CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if( file == INVALID_HANDLE_VALUE ){
+      return false;
+    }
+
+    LARGE_INTEGER size;
+    if( !::GetFileSizeEx( file, &size ) || size.QuadPart == 0 ){
+      ::CloseHandle( file );
+      return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( mapping == NULL ){
+      ::CloseHandle( file );
+      return false;
+    }
+
+    void* view = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if( view == NULL ){
+      ::CloseHandle( mapping );
+      ::CloseHandle( file );
+      return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const ubyte*>(view);
+    m_size    = static_cast<std::size_t>(size.QuadPart);
+    return true;
+  }
+
+  void Mapped_File::close(){
+    if( m_data ){
+      ::UnmapViewOfFile( m_data );
+      ::CloseHandle( m_mapping );
+      ::CloseHandle( m_file );
+    }
+    m_data    = NULL;
+    m_size    = 0;
+    m_file    = NULL;
+    m_mapping = NULL;
+  }
+
+  void Mapped_File::release( const ubyte*, std::size_t ) const{
+    // Views of files are trimmed from the working set by the memory
+    // manager on its own; there is nothing to do here.
+  }
+
+#else
+
+  bool Mapped_File::open( const char* filename ){
+    close();
+
+    int fd = ::open( filename, O_RDONLY );
+    if( fd < 0 ){
+      return false;
+    }
+
+    struct stat info;
+    if( ::fstat( fd, &info ) != 0 || info.st_size <= 0 ){
+      ::close( fd );
+      return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* view = ::mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    // The mapping holds its own reference to the file
+    ::close( fd );
+
+    if( view == MAP_FAILED ){
+      return false;
+    }
+
+    // Files are consumed front to back; let the kernel read ahead
+    ::madvise( view, size, MADV_SEQUENTIAL );
+
+    m_data = static_cast<const ubyte*>(view);
+    m_size = size;
+    return true;
+  }
+
+  void Mapped_File::close(){
+    if( m_data ){
+      ::munmap( const_cast<ubyte*>(m_data), m_size );
+    }
+    m_data = NULL;
+    m_size = 0;
+  }
+
+  void Mapped_File::release( const ubyte* first, std::size_t length ) const{
+    static const std::size_t page_size = static_cast<std::size_t>(::sysconf( _SC_PAGESIZE ));
+
+    // Round inwards to whole pages, so that bytes outside the range (which
+    // may still be needed) are never dropped
+    const std::size_t begin = reinterpret_cast<std::size_t>(first);
+    const std::size_t end   = begin + length;
+    const std::size_t lo    = (begin + page_size - 1) & ~(page_size - 1);
+    const std::size_t hi    = end & ~(page_size - 1);
+
+    if( hi > lo ){
+      // The mapping is private and never written, so the pages are simply
+      // re-read from the file if they are touched again
+      ::madvise( reinterpret_cast<void*>(lo), hi - lo, MADV_DONTNEED );
+    }
+  }
+
+#endif
+
+}  // namespace ocr
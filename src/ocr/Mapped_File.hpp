@@ -0,0 +1,150 @@
+/**
+ * @file Mapped_File.hpp
+ *
+ * @brief This header defines a read-only memory mapping of a file on disk.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Mapped_File.hpp created
+ */
+#ifndef OCR_MAPPED_FILE_HPP_
+#define OCR_MAPPED_FILE_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+
+#include <cstddef> // std::size_t
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Mapped_File
+  ///
+  /// @brief A read-only view of an entire file, mapped into memory by the
+  ///        operating system.
+  ///
+  /// The contents are paged in on demand, so nothing is copied into the
+  /// process heap until it is actually touched.
+  /////////////////////////////////////////////////////////////////////////////
+  class Mapped_File  {
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a mapped file that does not refer to any file
+    ///
+    Mapped_File();
+
+    ///
+    /// @brief Destructor; unmaps the file, if one is mapped
+    ///
+    ~Mapped_File();
+
+    //-------------------------------------------------------------------------
+    // Mapping
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Maps the specified file into memory
+    ///
+    /// Any previously mapped file is unmapped first.
+    ///
+    /// @param filename the path to the file to map
+    /// @return true if the file was mapped
+    ///
+    bool open( const char* filename );
+
+    ///
+    /// @brief Unmaps the file
+    ///
+    void close();
+
+    ///
+    /// @brief Returns whether a file is currently mapped
+    ///
+    /// @return true if a file is mapped
+    ///
+    bool is_open() const;
+
+    ///
+    /// @brief Tells the operating system that a range of the file will not
+    ///        be read again, so that its pages can be dropped from memory
+    ///
+    /// The range stays mapped; touching it again simply pages it back in.
+    /// Only whole pages inside the range are released.
+    ///
+    /// @param first  the first byte of the range, inside the mapping
+    /// @param length the length of the range in bytes
+    ///
+    void release( const ubyte* first, std::size_t length ) const;
+
+    //-------------------------------------------------------------------------
+    // Element Access
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns a pointer to the first byte of the mapped file
+    ///
+    /// @return pointer to the mapped data
+    ///
+    const ubyte* data() const;
+
+    ///
+    /// @brief Returns the size of the mapped file in bytes
+    ///
+    /// @return the size of the mapping
+    ///
+    std::size_t size() const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    Mapped_File( const Mapped_File& );
+    Mapped_File& operator = ( const Mapped_File& );
+
+    const ubyte* m_data; ///< The first byte of the mapping
+    std::size_t  m_size; ///< The size of the mapping
+
+#if defined(_WIN32)
+    void* m_file;        ///< Handle to the open file
+    void* m_mapping;     ///< Handle to the file mapping object
+#endif
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline bool Mapped_File::is_open() const{
+    return m_data != NULL;
+  }
+
+  inline const ubyte* Mapped_File::data() const{
+    return m_data;
+  }
+
+  inline std::size_t Mapped_File::size() const{
+    return m_size;
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_MAPPED_FILE_HPP_ */
@@ -0,0 +1,91 @@
+/**
+ * @file Pixel_Image.cpp
+ *
+ * @brief This source defines the packed binary image.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Pixel_Image.cpp created
+ * - Packed rows are drawn from the global Buffer_Pool
+ */
+#include "Pixel_Image.hpp"
+
+#include <cstring> // std::memcpy, std::memset
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor / Assignment
+  //---------------------------------------------------------------------------
+
+  Pixel_Image<Packed_Bit>::Pixel_Image()
+    : m_width(0),
+      m_height(0),
+      m_row_bytes(0),
+      m_data(nullptr)
+  {
+
+  }
+
+  Pixel_Image<Packed_Bit>::Pixel_Image( size_type width, size_type height )
+    : m_width(width),
+      m_height(height),
+      m_row_bytes((width + 7) / 8),
+      m_data( allocate_image_storage( ((width + 7) / 8) * height, 1 ) )
+  {
+    std::memset( m_data, 0, m_row_bytes * m_height );
+  }
+
+  Pixel_Image<Packed_Bit>::Pixel_Image( const Pixel_Image& x )
+    : m_width(x.m_width),
+      m_height(x.m_height),
+      m_row_bytes(x.m_row_bytes),
+      m_data( allocate_image_storage( x.m_row_bytes * x.m_height, 1 ) )
+  {
+    std::memcpy( m_data, x.m_data, m_row_bytes * m_height );
+  }
+
+  Pixel_Image<Packed_Bit>::Pixel_Image( Pixel_Image&& x )
+    : m_width(x.m_width),
+      m_height(x.m_height),
+      m_row_bytes(x.m_row_bytes),
+      m_data(x.m_data)
+  {
+    x.m_width     = 0;
+    x.m_height    = 0;
+    x.m_row_bytes = 0;
+    x.m_data      = nullptr;
+  }
+
+  Pixel_Image<Packed_Bit>::~Pixel_Image(){
+    free_image_storage( m_data, m_row_bytes * m_height, 1 );
+  }
+
+  Pixel_Image<Packed_Bit>& Pixel_Image<Packed_Bit>::operator = ( Pixel_Image x ){
+    swap( x );
+    return (*this);
+  }
+
+  //---------------------------------------------------------------------------
+  // Element Access
+  //---------------------------------------------------------------------------
+
+  void Pixel_Image<Packed_Bit>::fill( pixel_type uniform ){
+    std::memset( m_data, uniform ? 0xff : 0x00, m_row_bytes * m_height );
+  }
+
+  void Pixel_Image<Packed_Bit>::swap( Pixel_Image& other ){
+    std::swap( m_width,     other.m_width );
+    std::swap( m_height,    other.m_height );
+    std::swap( m_row_bytes, other.m_row_bytes );
+    std::swap( m_data,      other.m_data );
+  }
+
+}  // namespace ocr
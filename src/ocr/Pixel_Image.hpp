@@ -0,0 +1,555 @@
+/**
+ * @file Pixel_Image.hpp
+ *
+ * @brief This header defines images generic over their pixel format,
+ *        including single channel 8 bit and packed 1 bit images.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Pixel_Image.hpp created
+ * - Images may be copied out of a view
+ */
+#ifndef OCR_PIXEL_IMAGE_HPP_
+#define OCR_PIXEL_IMAGE_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+#include "Color.hpp"
+#include "Image_Layout.hpp"
+#include "Image_View.hpp"
+
+#include <algorithm> // std::copy, std::fill, std::swap
+#include <cstddef>   // std::size_t
+
+namespace ocr {
+
+  ///
+  /// @struct ocr::Packed_Bit
+  ///
+  /// @brief Pixel format tag for binary images packed 8 pixels to a byte
+  ///
+  struct Packed_Bit{};
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Pixel_Image
+  ///
+  /// @brief An image of @p Pixel values, stored row after row
+  ///
+  /// Unlike Image, which keeps every format as 3 byte RGB pixels, each
+  /// format is stored at its own size: a grayscale image is one byte per
+  /// pixel, and a binary image (see the Packed_Bit specialization) one bit.
+  ///
+  /// Reading outside of the image gives the format's background (white);
+  /// writes are not checked.
+  ///
+  /// Rows are packed end to end unless an image_layout asks for aligned,
+  /// padded rows or a border, as for Image.
+  ///
+  /// @tparam Pixel the type of each pixel
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename Pixel>
+  class Pixel_Image  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::size_t              size_type;
+    typedef Pixel                    pixel_type;
+    typedef Image_View<Pixel>        view_type;
+    typedef Image_View<const Pixel>  const_view_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor / Assignment
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs an empty image
+    ///
+    Pixel_Image();
+
+    ///
+    /// @brief Constructs an image of the specified width and height, whose
+    ///        pixels are uninitialized
+    ///
+    /// @param width  The width of the image
+    /// @param height The height of the image
+    ///
+    Pixel_Image( size_type width, size_type height );
+
+    ///
+    /// @brief Constructs an image whose rows are laid out as @p layout asks,
+    ///        and whose pixels are uninitialized
+    ///
+    /// @param width  The width of the image
+    /// @param height The height of the image
+    /// @param layout The alignment and border of the rows
+    ///
+    Pixel_Image( size_type width, size_type height, const image_layout& layout );
+
+    Pixel_Image( const Pixel_Image& x );
+
+    Pixel_Image( Pixel_Image&& x );
+
+    ///
+    /// @brief Constructs an image by copying the pixels of a view
+    ///
+    /// @param view the pixels to copy
+    ///
+    explicit Pixel_Image( const const_view_type& view );
+
+    ~Pixel_Image();
+
+    Pixel_Image& operator = ( Pixel_Image x );
+
+    //-------------------------------------------------------------------------
+    // Capacity
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Return the size of this image in bytes
+    ///
+    size_type size() const;
+
+    size_type width() const;
+
+    size_type height() const;
+
+    ///
+    /// @brief Returns the number of pixels from one row to the next
+    ///
+    size_type stride() const;
+
+    size_type border() const;
+
+    //-------------------------------------------------------------------------
+    // Element Access
+    //-------------------------------------------------------------------------
+  public:
+
+    pixel_type* ptr();
+
+    const pixel_type* ptr() const;
+
+    ///
+    /// @brief Returns the first pixel of row @p y
+    ///
+    pixel_type* row( size_type y );
+
+    const pixel_type* row( size_type y ) const;
+
+    ///
+    /// @brief Retrieve the pixel at the specified coordinates, or the
+    ///        background if they are outside of the image
+    ///
+    pixel_type at( int x, int y ) const;
+
+    void set( size_type x, size_type y, pixel_type value );
+
+    void fill( pixel_type uniform );
+
+    ///
+    /// @brief Fills the border around this image
+    ///
+    /// @param policy how to fill the border
+    /// @param value  the value of the border for border_constant
+    ///
+    void fill_border( border_policy policy,
+                      pixel_type value = Pixel_Traits<Pixel>::background() );
+
+    void swap( Pixel_Image& other );
+
+    //-------------------------------------------------------------------------
+    // Views
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Returns a view of the whole image
+    ///
+    view_type view();
+
+    const_view_type view() const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    void allocate( const image_layout& layout );
+
+    size_type   m_width;   ///< Width of the image
+    size_type   m_height;  ///< Height of the image
+    size_type   m_stride;  ///< Pixels from one row to the next
+    size_type   m_border;  ///< Pixels of border on each side
+    size_type   m_align;   ///< Byte alignment of the rows
+    size_type   m_count;   ///< Pixels of storage, border and padding included
+    ubyte*      m_storage; ///< The storage, border and padding included
+    pixel_type* m_data;    ///< The pixel at (0,0)
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Pixel_Image<Packed_Bit>
+  ///
+  /// @brief A binary image, packed 8 pixels to a byte
+  ///
+  /// Each row starts on a byte of its own and stores its leftmost pixel in
+  /// the most significant bit; a set bit is ink. This is the layout of the
+  /// glyphs of a binary feature database, and the complement of a 1 bit
+  /// bitmap's rows.
+  ///
+  /// Pixels are read and written as 0 (background) or 1 (ink); reading
+  /// outside of the image gives background.
+  /////////////////////////////////////////////////////////////////////////////
+  template<>
+  class Pixel_Image<Packed_Bit>  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::size_t size_type;
+    typedef ubyte       pixel_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor / Assignment
+    //-------------------------------------------------------------------------
+  public:
+
+    Pixel_Image();
+
+    ///
+    /// @brief Constructs an image of the specified width and height with
+    ///        every pixel background
+    ///
+    /// @param width  The width of the image
+    /// @param height The height of the image
+    ///
+    Pixel_Image( size_type width, size_type height );
+
+    Pixel_Image( const Pixel_Image& x );
+
+    Pixel_Image( Pixel_Image&& x );
+
+    ~Pixel_Image();
+
+    Pixel_Image& operator = ( Pixel_Image x );
+
+    //-------------------------------------------------------------------------
+    // Capacity
+    //-------------------------------------------------------------------------
+  public:
+
+    size_type size() const;
+
+    size_type width() const;
+
+    size_type height() const;
+
+    ///
+    /// @brief Returns the number of bytes in each row
+    ///
+    size_type row_bytes() const;
+
+    //-------------------------------------------------------------------------
+    // Element Access
+    //-------------------------------------------------------------------------
+  public:
+
+    ubyte* ptr();
+
+    const ubyte* ptr() const;
+
+    ubyte* row( size_type y );
+
+    const ubyte* row( size_type y ) const;
+
+    pixel_type at( int x, int y ) const;
+
+    void set( size_type x, size_type y, pixel_type value );
+
+    void fill( pixel_type uniform );
+
+    void swap( Pixel_Image& other );
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    size_type m_width;     ///< Width of the image
+    size_type m_height;    ///< Height of the image
+    size_type m_row_bytes; ///< Bytes in each row
+    ubyte*    m_data;      ///< The packed rows
+  };
+
+  //---------------------------------------------------------------------------
+  // Image Types
+  //---------------------------------------------------------------------------
+
+  typedef Pixel_Image<ubyte>      Gray_Image;   ///< 8 bits per pixel
+  typedef Pixel_Image<Packed_Bit> Binary_Image; ///< 1 bit per pixel
+
+  //---------------------------------------------------------------------------
+  // Definitions: Pixel_Image<Pixel>
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image()
+    : m_width(0),
+      m_height(0)
+  {
+    allocate( packed_layout() );
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image( size_type width, size_type height )
+    : m_width(width),
+      m_height(height)
+  {
+    allocate( packed_layout() );
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image( size_type width,
+                                          size_type height,
+                                          const image_layout& layout )
+    : m_width(width),
+      m_height(height)
+  {
+    allocate( layout );
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image( const Pixel_Image& x )
+    : m_width(x.m_width),
+      m_height(x.m_height)
+  {
+    allocate( image_layout( x.m_align, x.m_border ) );
+
+    const pixel_type* from = reinterpret_cast<const pixel_type*>( x.m_storage );
+    std::copy( from, from + m_count, reinterpret_cast<pixel_type*>( m_storage ) );
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image( Pixel_Image&& x )
+    : m_width(x.m_width),
+      m_height(x.m_height),
+      m_stride(x.m_stride),
+      m_border(x.m_border),
+      m_align(x.m_align),
+      m_count(x.m_count),
+      m_storage(x.m_storage),
+      m_data(x.m_data)
+  {
+    x.m_width   = 0;
+    x.m_height  = 0;
+    x.m_stride  = 0;
+    x.m_border  = 0;
+    x.m_count   = 0;
+    x.m_storage = nullptr;
+    x.m_data    = nullptr;
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::Pixel_Image( const const_view_type& view )
+    : m_width(view.width()),
+      m_height(view.height())
+  {
+    allocate( packed_layout() );
+
+    for( size_type y = 0; y < m_height; ++y ){
+      std::copy( view.row(y), view.row(y) + m_width, row(y) );
+    }
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>::~Pixel_Image(){
+    free_image_storage( m_storage, m_count * sizeof(pixel_type), m_align );
+  }
+
+  template<typename Pixel>
+  inline void Pixel_Image<Pixel>::allocate( const image_layout& layout ){
+    const image_geometry geometry = compute_geometry( layout, sizeof(pixel_type), m_width, m_height );
+
+    m_stride  = geometry.stride;
+    m_border  = layout.border;
+    m_align   = layout.alignment;
+    m_count   = geometry.count;
+    m_storage = allocate_image_storage( m_count * sizeof(pixel_type), m_align );
+    m_data    = reinterpret_cast<pixel_type*>( m_storage ) + geometry.origin;
+  }
+
+  template<typename Pixel>
+  inline Pixel_Image<Pixel>& Pixel_Image<Pixel>::operator = ( Pixel_Image x ){
+    swap( x );
+    return (*this);
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::size_type Pixel_Image<Pixel>::size() const{
+    return m_width * m_height * sizeof(pixel_type);
+  }
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::size_type Pixel_Image<Pixel>::width() const{
+    return m_width;
+  }
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::size_type Pixel_Image<Pixel>::height() const{
+    return m_height;
+  }
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::size_type Pixel_Image<Pixel>::stride() const{
+    return m_stride;
+  }
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::size_type Pixel_Image<Pixel>::border() const{
+    return m_border;
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline Pixel* Pixel_Image<Pixel>::ptr(){
+    return m_data;
+  }
+
+  template<typename Pixel>
+  inline const Pixel* Pixel_Image<Pixel>::ptr() const{
+    return m_data;
+  }
+
+  template<typename Pixel>
+  inline Pixel* Pixel_Image<Pixel>::row( size_type y ){
+    return m_data + y * m_stride;
+  }
+
+  template<typename Pixel>
+  inline const Pixel* Pixel_Image<Pixel>::row( size_type y ) const{
+    return m_data + y * m_stride;
+  }
+
+  template<typename Pixel>
+  inline Pixel Pixel_Image<Pixel>::at( int x, int y ) const{
+    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+      return Pixel_Traits<Pixel>::background();
+    }
+    return m_data[y * m_stride + x];
+  }
+
+  template<typename Pixel>
+  inline void Pixel_Image<Pixel>::set( size_type x, size_type y, pixel_type value ){
+    m_data[y * m_stride + x] = value;
+  }
+
+  template<typename Pixel>
+  inline void Pixel_Image<Pixel>::fill( pixel_type uniform ){
+    for( size_type y = 0; y < m_height; ++y ){
+      std::fill( row(y), row(y) + m_width, uniform );
+    }
+  }
+
+  template<typename Pixel>
+  inline void Pixel_Image<Pixel>::fill_border( border_policy policy, pixel_type value ){
+    ocr::fill_border( m_data, m_width, m_height, m_stride, m_border, policy, value );
+  }
+
+  template<typename Pixel>
+  inline void Pixel_Image<Pixel>::swap( Pixel_Image& other ){
+    std::swap( m_width,   other.m_width );
+    std::swap( m_height,  other.m_height );
+    std::swap( m_stride,  other.m_stride );
+    std::swap( m_border,  other.m_border );
+    std::swap( m_align,   other.m_align );
+    std::swap( m_count,   other.m_count );
+    std::swap( m_storage, other.m_storage );
+    std::swap( m_data,    other.m_data );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::view_type Pixel_Image<Pixel>::view(){
+    return view_type( m_data, m_width, m_height, m_stride );
+  }
+
+  template<typename Pixel>
+  inline typename Pixel_Image<Pixel>::const_view_type Pixel_Image<Pixel>::view() const{
+    return const_view_type( m_data, m_width, m_height, m_stride );
+  }
+
+  //---------------------------------------------------------------------------
+  // Definitions: Pixel_Image<Packed_Bit>
+  //---------------------------------------------------------------------------
+
+  inline Pixel_Image<Packed_Bit>::size_type Pixel_Image<Packed_Bit>::size() const{
+    return m_row_bytes * m_height;
+  }
+
+  inline Pixel_Image<Packed_Bit>::size_type Pixel_Image<Packed_Bit>::width() const{
+    return m_width;
+  }
+
+  inline Pixel_Image<Packed_Bit>::size_type Pixel_Image<Packed_Bit>::height() const{
+    return m_height;
+  }
+
+  inline Pixel_Image<Packed_Bit>::size_type Pixel_Image<Packed_Bit>::row_bytes() const{
+    return m_row_bytes;
+  }
+
+  //---------------------------------------------------------------------------
+
+  inline ubyte* Pixel_Image<Packed_Bit>::ptr(){
+    return m_data;
+  }
+
+  inline const ubyte* Pixel_Image<Packed_Bit>::ptr() const{
+    return m_data;
+  }
+
+  inline ubyte* Pixel_Image<Packed_Bit>::row( size_type y ){
+    return m_data + y * m_row_bytes;
+  }
+
+  inline const ubyte* Pixel_Image<Packed_Bit>::row( size_type y ) const{
+    return m_data + y * m_row_bytes;
+  }
+
+  inline Pixel_Image<Packed_Bit>::pixel_type Pixel_Image<Packed_Bit>::at( int x, int y ) const{
+    if( x < 0 || x >= (int) m_width || y < 0 || y >= (int) m_height ){
+      return 0;
+    }
+    return (m_data[y * m_row_bytes + (x >> 3)] >> (7 - (x & 7))) & 1;
+  }
+
+  inline void Pixel_Image<Packed_Bit>::set( size_type x, size_type y, pixel_type value ){
+    ubyte&      byte = m_data[y * m_row_bytes + (x >> 3)];
+    const ubyte mask = (ubyte) (0x80u >> (x & 7));
+
+    byte = value ? (ubyte) (byte | mask) : (ubyte) (byte & ~mask);
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_PIXEL_IMAGE_HPP_ */
@@ -0,0 +1,138 @@
+/**
+ * @file Recognition_Pipeline.cpp
+ *
+ * @brief This source defines the stage threads of the recognition pipeline.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognition_Pipeline.cpp created
+ */
+#include "Recognition_Pipeline.hpp"
+#include "BMP_Loader.hpp"
+
+#include <thread> // std::thread
+
+namespace ocr {
+
+  typedef std::chrono::steady_clock                pipeline_clock;
+  typedef std::chrono::duration<double,std::milli> milliseconds;
+
+  //---------------------------------------------------------------------------
+  // Constructor
+  //---------------------------------------------------------------------------
+
+  Recognition_Pipeline::Recognition_Pipeline( const Recognizer& recognizer, std::size_t depth )
+    : m_recognizer(&recognizer),
+      m_depth(depth)
+  {
+    for( std::size_t i = 0; i < stage_count; ++i ){
+      m_busy[i] = 0.0;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Execution
+  //---------------------------------------------------------------------------
+
+  void Recognition_Pipeline::run( const std::vector<std::string>& inputs, const sink_type& sink ){
+    for( std::size_t i = 0; i < stage_count; ++i ){
+      m_busy[i] = 0.0;
+    }
+
+    // A null page marks the end of the job as it passes down the pipeline
+    queue_type decoded( m_depth );
+    queue_type prepared( m_depth );
+    queue_type extracted( m_depth );
+    queue_type classified( m_depth );
+
+    const Recognizer& recognizer = *m_recognizer;
+
+    std::thread decode( [&]{
+      for( std::size_t i = 0; i < inputs.size(); ++i ){
+        pipeline_clock::time_point start = pipeline_clock::now();
+
+        page* p = new page();
+        p->index        = i;
+        p->input        = inputs[i];
+        p->result       = NULL;
+        p->milliseconds = 0.0;
+        p->start        = start;
+        p->status       = recognizer.load( p->input.c_str(), p->image );
+
+        m_busy[stage_decode] += milliseconds( pipeline_clock::now() - start ).count();
+        decoded.push( p );
+      }
+      decoded.push( NULL );
+    } );
+
+    std::thread prepare( [&]{
+      run_stage( stage_prepare, decoded, prepared, [&]( page& p ){
+        recognizer.prepare( p.image );
+      } );
+    } );
+
+    std::thread extract( [&]{
+      run_stage( stage_extract, prepared, extracted, [&]( page& p ){
+        recognizer.extract( *p.image.binary, p.features, p.bounds );
+      } );
+    } );
+
+    std::thread classify( [&]{
+      run_stage( stage_classify, extracted, classified, [&]( page& p ){
+        p.result = new Binary_Image( p.image.binary->width(), p.image.binary->height() );
+        Recognizer::release( p.image );
+
+        recognizer.classify( p.features, p.bounds, *p.result );
+      } );
+    } );
+
+    //-------------------------------------------------------------------------
+    // Output
+    //-------------------------------------------------------------------------
+
+    for( page* p = classified.pop(); p != NULL; p = classified.pop() ){
+      pipeline_clock::time_point start = pipeline_clock::now();
+
+      p->milliseconds = milliseconds( start - p->start ).count();
+      sink( *p );
+
+      Recognizer::release( p->image );
+      if( p->result ){
+        destroy_image( &p->result );
+      }
+      delete p;
+
+      m_busy[stage_output] += milliseconds( pipeline_clock::now() - start ).count();
+    }
+
+    decode.join();
+    prepare.join();
+    extract.join();
+    classify.join();
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Pipeline::run_stage( stage s, queue_type& in, queue_type& out, const work_type& work ){
+    for( page* p = in.pop(); p != NULL; p = in.pop() ){
+      pipeline_clock::time_point start = pipeline_clock::now();
+
+      // Pages that failed to load pass straight through to the output
+      if( p->status == IS_SUCCESS ){
+        work( *p );
+      }
+
+      m_busy[s] += milliseconds( pipeline_clock::now() - start ).count();
+      out.push( p );
+    }
+    out.push( NULL );
+  }
+
+}  // namespace ocr
@@ -0,0 +1,156 @@
+/**
+ * @file Recognition_Pipeline.hpp
+ *
+ * @brief This header defines a staged pipeline that recognizes a sequence of
+ *        pages with every stage running on its own thread.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognition_Pipeline.hpp created
+ */
+#ifndef OCR_RECOGNITION_PIPELINE_HPP_
+#define OCR_RECOGNITION_PIPELINE_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "Bounded_Queue.hpp"
+#include "Feature_Loader.hpp"
+#include "Pixel_Image.hpp"
+#include "Recognizer.hpp"
+
+#include <chrono>     // std::chrono
+#include <cstddef>    // std::size_t
+#include <functional> // std::function
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Recognition_Pipeline
+  ///
+  /// @brief Recognizes a sequence of pages in five stages that run at once
+  ///
+  /// Each stage of Recognizer (load, prepare, extract, classify) runs on a
+  /// thread of its own, and the output stage runs on the calling thread.
+  /// Pages move from one stage to the next through bounded queues, so while
+  /// one page is being classified the next is being labeled and the one
+  /// after that decoded from disk. A full queue holds the stage feeding it
+  /// back, which bounds the pages in flight (and so the memory used) and
+  /// lets throughput settle at the pace of the slowest stage.
+  ///
+  /// Pages reach the output stage in the order they were given.
+  /////////////////////////////////////////////////////////////////////////////
+  class Recognition_Pipeline  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief The stages of the pipeline, in order
+    ///
+    enum stage{
+      stage_decode,
+      stage_prepare,
+      stage_extract,
+      stage_classify,
+      stage_output,
+      stage_count
+    };
+
+    ///
+    /// @brief A page as it moves through the pipeline
+    ///
+    struct page{
+      std::size_t         index;        ///< Position of the page in the job
+      std::string         input;        ///< Path of the page's bitmap
+      int                 status;       ///< Status of the load (see image_status)
+      Recognizer::page_image image;     ///< The page, until it is classified
+      Binary_Image*       result;       ///< The recognized page, once classified
+      feature_collection  features;     ///< Features of the page's glyphs
+      boundary_collection bounds;       ///< Boundaries of the page's glyphs
+      double              milliseconds; ///< Time from decode to output
+      std::chrono::steady_clock::time_point start; ///< When decoding began
+    };
+
+    ///
+    /// @brief Receives each page in order once it is recognized
+    ///
+    /// Pages that failed to load arrive with a status other than IS_SUCCESS
+    /// and no result.
+    ///
+    typedef std::function<void(page&)> sink_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a pipeline that recognizes with @p recognizer
+    ///
+    /// @param recognizer the recognizer, which must outlive the pipeline
+    /// @param depth      the pages each queue holds before its producer waits
+    ///
+    explicit Recognition_Pipeline( const Recognizer& recognizer, std::size_t depth = 4 );
+
+    //-------------------------------------------------------------------------
+    // Execution
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Recognizes every page in @p inputs, handing each to @p sink
+    ///
+    /// @param inputs the paths of the bitmaps to recognize
+    /// @param sink   the output stage; called on the calling thread
+    ///
+    void run( const std::vector<std::string>& inputs, const sink_type& sink );
+
+    ///
+    /// @brief Returns the time a stage spent working during the last run
+    ///
+    /// The busiest stage is the one that limits the pipeline's throughput.
+    ///
+    /// @param s the stage
+    /// @return the time in milliseconds, excluding time spent waiting
+    ///
+    double busy( stage s ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    typedef Bounded_Queue<page*>       queue_type;
+    typedef std::function<void(page&)> work_type;
+
+    void run_stage( stage s, queue_type& in, queue_type& out, const work_type& work );
+
+    const Recognizer* m_recognizer;       ///< Recognizes every page
+    std::size_t       m_depth;            ///< Capacity of every queue
+    double            m_busy[stage_count]; ///< Working time of each stage
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline double Recognition_Pipeline::busy( stage s ) const{
+    return m_busy[s];
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_RECOGNITION_PIPELINE_HPP_ */
@@ -0,0 +1,660 @@
+/**
+ * @file Recognition_Server.cpp
+ *
+ * @brief This source defines the socket handling and request protocol of the
+ *        recognition server.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognition_Server.cpp created
+ * - Connections are waited on with poll(), and whole requests handed to
+ *   the pool
+ * - FILE paths are resolved under the root, and the socket is chmod'ed
+ */
+#include "Recognition_Server.hpp"
+#include "BMP_Loader.hpp"
+#include "Image.hpp"
+
+#include <algorithm> // std::min
+#include <chrono>    // std::chrono
+#include <cstring>   // std::memcpy, std::memmove, std::strlen
+#include <iomanip>   // std::setprecision
+#include <iostream>  // std::cerr
+#include <map>       // std::map
+#include <memory>    // std::unique_ptr
+#include <sstream>   // std::ostringstream
+#include <vector>    // std::vector
+
+#if !defined(_WIN32)
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+# include <sys/un.h>
+# include <cerrno>
+# include <climits>
+# include <csignal>
+# include <cstdlib>
+# include <fcntl.h>
+# include <poll.h>
+# include <unistd.h>
+#endif
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Connections
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief A buffered reader and writer over one client's socket
+  ///
+  /// Bytes are received by serve() as they arrive, and a request is only
+  /// taken out of the buffer once the whole of it, payload and all, is in.
+  /// While a worker answers it, the connection is left alone by serve().
+  ///
+  struct Recognition_Server::connection{
+    typedef std::chrono::steady_clock clock;
+
+    /// The outcomes of receive()
+    enum { received_some, received_none, received_end };
+
+    /// The outcomes of take_request()
+    enum { request_ready, request_partial, request_invalid };
+
+    int               fd;       ///< The client's socket
+    std::vector<char> buffer;   ///< Bytes received but not yet consumed
+    std::size_t       begin;    ///< First unconsumed byte of @c buffer
+    std::size_t       end;      ///< One past the last received byte
+    clock::time_point deadline; ///< When the connection closes if still silent
+    bool              busy;     ///< Whether a worker is answering a request
+    bool              keep;     ///< Whether to keep the connection once answered
+    std::string       request;  ///< The request line being answered
+    const char*       payload;  ///< The bytes following a DATA line, if valid
+    std::size_t       length;   ///< The bytes at @c payload
+
+    explicit connection( int fd );
+
+    int  receive();
+    int  take_request();
+    bool write( const char* data, std::size_t length );
+  };
+
+  //---------------------------------------------------------------------------
+
+  /// The buffer each connection starts with, and returns to after a large
+  /// payload
+  static const std::size_t CONNECTION_BUFFER_SIZE = 1u << 16;
+
+  ///
+  /// @brief Parses the length of a DATA request
+  ///
+  /// @param text   the request line after "DATA "
+  /// @param length set to the length
+  /// @return true if the length is one that is accepted
+  ///
+  static bool parse_data_length( const std::string& text, std::size_t* length ){
+    std::istringstream header( text );
+
+    return (header >> *length) && header.eof() &&
+           *length > 0 && *length <= Recognition_Server::MAX_DATA_LENGTH;
+  }
+
+#if !defined(_WIN32)
+
+  Recognition_Server::connection::connection( int fd )
+    : fd(fd),
+      buffer(CONNECTION_BUFFER_SIZE),
+      begin(0),
+      end(0),
+      busy(false),
+      keep(true),
+      payload(NULL),
+      length(0)
+  {
+
+  }
+
+  //---------------------------------------------------------------------------
+
+  int Recognition_Server::connection::receive(){
+    // Move anything unconsumed to the front to make room after it
+    if( begin == end ){
+      begin = end = 0;
+    }else if( begin > 0 && end == buffer.size() ){
+      std::memmove( &buffer[0], &buffer[begin], end - begin );
+      end  -= begin;
+      begin = 0;
+    }
+
+    for(;;){
+      const ssize_t received = ::recv( fd, &buffer[end], buffer.size() - end, MSG_DONTWAIT );
+      if( received > 0 ){
+        end += (std::size_t) received;
+        return received_some;
+      }
+      if( received < 0 && errno == EINTR ){
+        continue;
+      }
+      if( received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ){
+        return received_none;
+      }
+      return received_end;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  int Recognition_Server::connection::take_request(){
+    // A large payload is not held on to once it has been answered
+    if( begin == end && buffer.size() > CONNECTION_BUFFER_SIZE ){
+      std::vector<char>( CONNECTION_BUFFER_SIZE ).swap( buffer );
+      begin = end = 0;
+    }
+
+    std::size_t newline = begin;
+    while( newline < end && buffer[newline] != '\n' ){
+      ++newline;
+    }
+    if( newline == end ){
+      return (end - begin >= MAX_LINE_LENGTH) ? request_invalid : request_partial;
+    }
+
+    std::string line( &buffer[begin], newline - begin );
+    if( !line.empty() && line[line.size()-1] == '\r' ){
+      line.erase( line.size() - 1 );
+    }
+
+    // A DATA request is not whole until its payload has arrived; an invalid
+    // length is answered at once, with an error
+    const char* data = NULL;
+    std::size_t size = 0;
+    if( line.compare( 0, 5, "DATA " ) == 0 && parse_data_length( line.substr( 5 ), &size ) ){
+      const std::size_t whole = (newline + 1 - begin) + size;
+
+      if( end - begin < whole ){
+        if( buffer.size() - begin < whole ){
+          std::memmove( &buffer[0], &buffer[begin], end - begin );
+          end  -= begin;
+          begin = 0;
+          if( buffer.size() < whole ){
+            buffer.resize( whole );
+          }
+        }
+        return request_partial;
+      }
+      data = &buffer[newline + 1];
+    }
+
+    // The payload stays in the buffer, untouched until the request has been
+    // answered
+    request = line;
+    payload = data;
+    length  = size;
+    begin   = newline + 1 + size;
+    return request_ready;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Recognition_Server::connection::write( const char* data, std::size_t length ){
+    while( length ){
+      const ssize_t sent = ::send( fd, data, length, 0 );
+      if( sent < 0 ){
+        if( errno == EINTR ){
+          continue;
+        }
+        return false;
+      }
+      data   += sent;
+      length -= (std::size_t) sent;
+    }
+    return true;
+  }
+
+#endif
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor
+  //---------------------------------------------------------------------------
+
+  Recognition_Server::Recognition_Server( const Recognizer& recognizer, std::size_t threads )
+    : m_recognizer(&recognizer),
+      m_pool(threads),
+      m_socket(-1),
+      m_stopping(false),
+      m_requests(0)
+  {
+    m_wake[0] = m_wake[1] = -1;
+  }
+
+  Recognition_Server::~Recognition_Server(){
+#if !defined(_WIN32)
+    if( m_socket >= 0 ){
+      ::close( m_socket );
+      ::unlink( m_path.c_str() );
+    }
+    if( m_wake[0] >= 0 ){
+      ::close( m_wake[0] );
+      ::close( m_wake[1] );
+    }
+#endif
+  }
+
+  //---------------------------------------------------------------------------
+  // Serving
+  //---------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+  bool Recognition_Server::set_root( const char* ){
+    return false;
+  }
+
+  bool Recognition_Server::listen( const char* ){
+    return false;
+  }
+
+  void Recognition_Server::serve(){
+
+  }
+
+  void Recognition_Server::stop(){
+    m_stopping = true;
+  }
+
+  bool Recognition_Server::resolve( const std::string&, std::string& ) const{
+    return false;
+  }
+
+  bool Recognition_Server::dispatch( connection& ){
+    return false;
+  }
+
+  void Recognition_Server::answer( connection& ){
+
+  }
+
+  void Recognition_Server::wake(){
+
+  }
+
+#else
+
+  bool Recognition_Server::set_root( const char* directory ){
+    char resolved[PATH_MAX];
+
+    struct stat status;
+    if( ::realpath( directory, resolved ) == NULL ||
+        ::stat( resolved, &status ) != 0 || !S_ISDIR(status.st_mode) ){
+      return false;
+    }
+
+    m_root = resolved;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Recognition_Server::resolve( const std::string& path, std::string& resolved ) const{
+    if( m_root.empty() ){
+      return false;
+    }
+
+    // Links and '..' are followed before checking where the path leads
+    char real[PATH_MAX];
+    const std::string joined = m_root + "/" + path;
+    if( ::realpath( joined.c_str(), real ) == NULL ){
+      return false;
+    }
+
+    const std::string  result = real;
+    const std::string& root   = (m_root == "/") ? std::string() : m_root;
+    if( result.compare( 0, root.size(), root ) != 0 ||
+        result.size() <= root.size() || result[root.size()] != '/' ){
+      return false;
+    }
+
+    resolved = result;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Recognition_Server::listen( const char* path ){
+    sockaddr_un address;
+    std::memset( &address, 0, sizeof(address) );
+
+    if( std::strlen( path ) >= sizeof(address.sun_path) ){
+      return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy( address.sun_path, path );
+
+    // Only ever replace a socket, never some other file
+    struct stat status;
+    if( ::stat( path, &status ) == 0 ){
+      if( !S_ISSOCK(status.st_mode) ){
+        return false;
+      }
+      ::unlink( path );
+    }
+
+    // serve() is woken through a pipe, by stop() and by the workers
+    if( m_wake[0] < 0 ){
+      if( ::pipe( m_wake ) != 0 ){
+        m_wake[0] = m_wake[1] = -1;
+        return false;
+      }
+      ::fcntl( m_wake[0], F_SETFL, ::fcntl( m_wake[0], F_GETFL ) | O_NONBLOCK );
+      ::fcntl( m_wake[1], F_SETFL, ::fcntl( m_wake[1], F_GETFL ) | O_NONBLOCK );
+    }
+
+    const int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+    if( fd < 0 ){
+      return false;
+    }
+    if( ::bind( fd, (sockaddr*) &address, sizeof(address) ) != 0 ){
+      ::close( fd );
+      return false;
+    }
+
+    // Nothing can connect before listen(), so the socket is never open to
+    // others for longer than the umask allows
+    if( ::chmod( path, S_IRUSR | S_IWUSR ) != 0 ||
+        ::listen( fd, SOMAXCONN ) != 0 ){
+      ::close( fd );
+      ::unlink( path );
+      return false;
+    }
+
+    // Connections are accepted as poll() reports them, and a client that
+    // has already gone must not block accept()
+    ::fcntl( fd, F_SETFL, ::fcntl( fd, F_GETFL ) | O_NONBLOCK );
+
+    m_socket = fd;
+    m_path   = path;
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Server::serve(){
+    typedef connection::clock                          clock;
+    typedef std::map<int, std::unique_ptr<connection>> connection_map;
+
+    // A client that hangs up early must not take the whole server down
+    std::signal( SIGPIPE, SIG_IGN );
+
+    const clock::duration idle_timeout = std::chrono::seconds( IDLE_TIMEOUT );
+
+    connection_map      connections;
+    std::vector<pollfd> fds;
+
+    while( !m_stopping ){
+
+      // Take back the connections whose request has been answered; a
+      // further request that has already arrived is answered straight away
+      std::vector<connection*> answered;
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        answered.swap( m_answered );
+      }
+      for( std::size_t i = 0; i < answered.size(); ++i ){
+        connection& client = *answered[i];
+
+        client.busy     = false;
+        client.deadline = clock::now() + idle_timeout;
+        if( !client.keep || !dispatch( client ) ){
+          ::close( client.fd );
+          connections.erase( client.fd );
+        }
+      }
+
+      //-----------------------------------------------------------------------
+
+      // Wait on the socket, the wake pipe and every idle connection, for no
+      // longer than the first of them may stay silent
+      const clock::time_point now = clock::now();
+      int timeout = -1;
+
+      fds.clear();
+      fds.push_back( pollfd() );
+      fds.back().fd     = m_socket;
+      fds.back().events = POLLIN;
+      fds.push_back( pollfd() );
+      fds.back().fd     = m_wake[0];
+      fds.back().events = POLLIN;
+
+      for( connection_map::iterator iter = connections.begin(); iter != connections.end(); ++iter ){
+        const connection& client = *iter->second;
+        if( client.busy ){
+          continue;
+        }
+        fds.push_back( pollfd() );
+        fds.back().fd     = client.fd;
+        fds.back().events = POLLIN;
+
+        const long long left = (client.deadline > now)
+          ? std::chrono::duration_cast<std::chrono::milliseconds>( client.deadline - now ).count() + 1
+          : 0;
+        if( timeout < 0 || left < timeout ){
+          timeout = (int) left;
+        }
+      }
+
+      if( ::poll( &fds[0], fds.size(), timeout ) < 0 ){
+        if( errno == EINTR ){
+          continue;
+        }
+        break;
+      }
+
+      if( fds[1].revents ){
+        char drained[64];
+        while( ::read( m_wake[0], drained, sizeof(drained) ) > 0 ){ }
+      }
+
+      if( fds[0].revents ){
+        int client;
+        while( (client = ::accept( m_socket, NULL, NULL )) >= 0 ){
+          // Replies are written with blocking sends, which give up on a
+          // client that stops reading
+          ::fcntl( client, F_SETFL, ::fcntl( client, F_GETFL ) & ~O_NONBLOCK );
+
+          timeval limit;
+          limit.tv_sec  = IDLE_TIMEOUT;
+          limit.tv_usec = 0;
+          ::setsockopt( client, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit) );
+
+          std::unique_ptr<connection>& entry = connections[client];
+          entry.reset( new connection( client ) );
+          entry->deadline = clock::now() + idle_timeout;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+
+      // Receive what each connection has sent, and answer any request that
+      // is now whole; close the connections that have ended or gone silent
+      const clock::time_point polled = clock::now();
+
+      for( std::size_t i = 2; i < fds.size(); ++i ){
+        connection& client = *connections[fds[i].fd];
+        bool        open   = true;
+
+        if( fds[i].revents ){
+          const int received = client.receive();
+          if( received == connection::received_some ){
+            client.deadline = polled + idle_timeout;
+          }
+          open = dispatch( client ) &&
+                 (client.busy || received != connection::received_end);
+        }
+        if( open && !client.busy && polled >= client.deadline ){
+          open = false;
+        }
+
+        if( !open ){
+          ::close( client.fd );
+          connections.erase( fds[i].fd );
+        }
+      }
+    }
+
+    // Requests being answered still get their reply
+    m_pool.wait();
+
+    for( connection_map::iterator iter = connections.begin(); iter != connections.end(); ++iter ){
+      ::close( iter->first );
+    }
+    m_answered.clear();
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Server::stop(){
+    m_stopping = true;
+
+    // write() is async-signal-safe, and makes a waiting poll() return
+    wake();
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Server::wake(){
+    if( m_wake[1] >= 0 ){
+      const char byte = 0;
+      const ssize_t written = ::write( m_wake[1], &byte, 1 );
+      (void) written; // A full pipe will wake serve() anyway
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  bool Recognition_Server::dispatch( connection& client ){
+    switch( client.take_request() ){
+    case connection::request_partial:
+      return true;
+    case connection::request_invalid:
+      return false;
+    default:
+      break;
+    }
+
+    if( client.request == "QUIT" ){
+      return false;
+    }
+
+    client.busy = true;
+
+    connection* peer = &client;
+    m_pool.submit( [this, peer]{
+      answer( *peer );
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_answered.push_back( peer );
+      }
+      wake();
+    } );
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Server::answer( connection& peer ){
+    typedef std::chrono::steady_clock clock;
+
+    const std::string&      request = peer.request;
+    const clock::time_point start   = clock::now();
+    const std::size_t       id      = ++m_requests;
+
+    Binary_Image* result = NULL;
+    std::size_t glyphs = 0;
+    std::string error;
+    bool        keep   = true;
+
+    if( request.compare( 0, 5, "FILE " ) == 0 ){
+      const std::string input = request.substr( 5 );
+      std::string       path;
+
+      if( m_root.empty() ){
+        error = "file requests are disabled";
+      }else if( !resolve( input, path ) ||
+                m_recognizer->recognize( path.c_str(), &result, &glyphs ) != IS_SUCCESS ){
+        // Whether a path outside the root exists is not given away
+        error = "unable to load '" + input + "'";
+      }
+    }else if( request.compare( 0, 5, "DATA " ) == 0 ){
+      if( !peer.payload ){
+        // The payload cannot be skipped without a length to trust
+        error = "invalid length";
+        keep  = false;
+      }else if( m_recognizer->recognize( (const ubyte*) peer.payload, peer.length, &result, &glyphs ) != IS_SUCCESS ){
+        error = "not a supported bitmap";
+      }
+    }else{
+      error = "unknown request";
+    }
+
+    //-------------------------------------------------------------------------
+
+    std::string payload;
+    if( result ){
+      std::ostringstream stream;
+      save_bmp_image( stream, *result );
+      payload = stream.str();
+      destroy_image( &result );
+    }
+
+    const double milliseconds =
+      std::chrono::duration<double,std::milli>( clock::now() - start ).count();
+
+    std::ostringstream reply;
+    if( error.empty() ){
+      reply << "OK " << glyphs << ' '
+            << std::fixed << std::setprecision(3) << milliseconds << ' '
+            << payload.size() << '\n';
+    }else{
+      reply << "ERROR " << error << '\n';
+    }
+
+    const std::string header = reply.str();
+
+    std::ostringstream outcome;
+    if( error.empty() ){
+      outcome << glyphs << " glyphs";
+    }else{
+      outcome << "error, " << error;
+    }
+    log( id, request, outcome.str(), milliseconds );
+
+    peer.keep = peer.write( header.data(), header.size() ) &&
+                peer.write( payload.data(), payload.size() ) &&
+                keep;
+  }
+
+#endif
+
+  //---------------------------------------------------------------------------
+
+  void Recognition_Server::log( std::size_t id,
+                                const std::string& request,
+                                const std::string& outcome,
+                                double milliseconds ){
+    std::ostringstream line;
+    line << "#" << id << " " << request << ": " << outcome << " ("
+         << std::fixed << std::setprecision(3) << milliseconds << " ms)\n";
+
+    // One write per line keeps concurrent requests from interleaving
+    std::lock_guard<std::mutex> lock( m_mutex );
+    std::cerr << line.str() << std::flush;
+  }
+
+}  // namespace ocr
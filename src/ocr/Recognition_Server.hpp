@@ -0,0 +1,182 @@
+/**
+ * @file Recognition_Server.hpp
+ *
+ * @brief This header defines a server that recognizes pages sent to it over
+ *        a local (Unix domain) socket.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognition_Server.hpp created
+ * - Connections are multiplexed, and hold a worker only per request
+ * - FILE requests are confined to a root, and no longer write files
+ */
+#ifndef OCR_RECOGNITION_SERVER_HPP_
+#define OCR_RECOGNITION_SERVER_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "Recognizer.hpp"
+#include "Thread_Pool.hpp"
+
+#include <atomic>  // std::atomic
+#include <cstddef> // std::size_t
+#include <mutex>   // std::mutex
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Recognition_Server
+  ///
+  /// @brief Keeps a recognizer, and the database and filters behind it,
+  ///        resident and answers recognition requests over a Unix socket
+  ///
+  /// Every connection is waited on at once, by the thread that calls
+  /// serve(), and a request is only handed to a worker of the server's
+  /// thread pool once all of it has arrived; a connection holds a worker
+  /// just while one of its requests is being answered, so idle connections
+  /// never hold back the others. The requests of one connection are
+  /// answered in order. A connection that stays silent for IDLE_TIMEOUT
+  /// seconds is closed.
+  ///
+  /// Every request is a single header line, and every reply a single line
+  /// followed by any payload:
+  ///
+  ///   FILE <path>              recognize a bitmap under the root
+  ///   DATA <length>            recognize the <length> bitmap bytes that
+  ///                            follow the line
+  ///   QUIT                     close the connection
+  ///
+  ///   OK <glyphs> <milliseconds> <length>
+  ///                            followed by <length> bytes: the recognized
+  ///                            page as a 1 bpp bitmap
+  ///   ERROR <message>
+  ///
+  /// Anyone who can connect can make the server read files, so FILE paths
+  /// are resolved under a root directory, and refused if they lead outside
+  /// of it; without a root (see set_root()) only DATA requests are
+  /// answered. The server never writes a file, and its socket is only
+  /// open to the user running it.
+  ///
+  /// Latency is measured from receiving a request to having its reply ready,
+  /// and is also logged to standard error.
+  ///
+  /// Only POSIX systems are supported; elsewhere listen() always fails.
+  /////////////////////////////////////////////////////////////////////////////
+  class Recognition_Server  {
+
+    //-------------------------------------------------------------------------
+    // Constants
+    //-------------------------------------------------------------------------
+  public:
+
+    /// Largest bitmap accepted by a DATA request, in bytes
+    static const std::size_t MAX_DATA_LENGTH = 256u << 20;
+
+    /// Longest request line accepted, in bytes
+    static const std::size_t MAX_LINE_LENGTH = 4096;
+
+    /// Seconds a connection may stay silent, or take to accept a reply,
+    /// before it is closed
+    static const int IDLE_TIMEOUT = 30;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a server that answers with @p recognizer
+    ///
+    /// @param recognizer the recognizer, which must outlive the server
+    /// @param threads    the requests answered at once; 0 uses one per
+    ///                   hardware thread
+    ///
+    explicit Recognition_Server( const Recognizer& recognizer, std::size_t threads = 0 );
+
+    ///
+    /// @brief Closes the socket, and removes it from the file system
+    ///
+    ~Recognition_Server();
+
+    //-------------------------------------------------------------------------
+    // Serving
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Sets the directory that FILE request paths are read from
+    ///
+    /// @param directory the root directory
+    /// @return true if @p directory exists
+    ///
+    bool set_root( const char* directory );
+
+    ///
+    /// @brief Binds and listens on a socket at @p path
+    ///
+    /// A stale socket left at @p path by an earlier server is replaced. The
+    /// socket is made readable and writable by its owner alone, whatever
+    /// the umask.
+    ///
+    /// @param path the file system path of the socket
+    /// @return true if the server is listening
+    ///
+    bool listen( const char* path );
+
+    ///
+    /// @brief Accepts and answers connections until stop() is called
+    ///
+    /// Requests already being answered get their reply before this returns.
+    ///
+    void serve();
+
+    ///
+    /// @brief Makes serve() return
+    ///
+    /// This is safe to call from a signal handler.
+    ///
+    void stop();
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    struct connection;
+
+    // Not copyable
+    Recognition_Server( const Recognition_Server& );
+    Recognition_Server& operator = ( const Recognition_Server& );
+
+    bool resolve( const std::string& path, std::string& resolved ) const;
+    bool dispatch( connection& client );
+    void answer( connection& client );
+    void wake();
+    void log( std::size_t id, const std::string& request, const std::string& outcome, double milliseconds );
+
+    const Recognizer*        m_recognizer; ///< Recognizes every page
+    Thread_Pool              m_pool;       ///< Answers the requests
+    std::string              m_path;       ///< Path of the bound socket
+    std::string              m_root;       ///< Where FILE paths lead, or empty
+    int                      m_socket;     ///< The listening socket, or -1
+    int                      m_wake[2];    ///< A pipe that wakes serve()
+    std::atomic<bool>        m_stopping;   ///< Set once stop() is called
+    std::atomic<std::size_t> m_requests;   ///< Requests received so far
+    std::mutex               m_mutex;      ///< Guards the members below
+    std::vector<connection*> m_answered;   ///< Connections given back by workers
+  };
+
+}  // namespace ocr
+
+#endif /* OCR_RECOGNITION_SERVER_HPP_ */
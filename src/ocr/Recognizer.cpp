@@ -0,0 +1,278 @@
+/**
+ * @file Recognizer.cpp
+ *
+ * @brief This source defines the stages of recognizing a page.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognizer.cpp created
+ * - Grayscale pages are filtered as a single plane
+ */
+#include "Recognizer.hpp"
+#include "BMP_Loader.hpp"
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Constructor
+  //---------------------------------------------------------------------------
+
+  Recognizer::Recognizer( const Feature_Database& database,
+                          std::size_t horizontal_divs,
+                          std::size_t vertical_divs )
+    : m_database(&database),
+      m_horizontal_divs(horizontal_divs),
+      m_vertical_divs(vertical_divs),
+      m_threshold(-1)
+  {
+
+  }
+
+  //---------------------------------------------------------------------------
+  // Configuration
+  //---------------------------------------------------------------------------
+
+  Recognizer& Recognizer::add_filter( const Kernel_Image_Operator& op ){
+    m_filters.push_back( &op );
+    return (*this);
+  }
+
+  Recognizer& Recognizer::set_threshold( int threshold ){
+    m_threshold = threshold;
+    return (*this);
+  }
+
+  //---------------------------------------------------------------------------
+  // Page Images
+  //---------------------------------------------------------------------------
+
+  Recognizer::page_image::page_image()
+    : color(NULL),
+      gray(NULL),
+      binary(NULL)
+  {
+
+  }
+
+  void Recognizer::release( page_image& page ){
+    if( page.color ){
+      destroy_image( &page.color );
+    }
+    if( page.gray ){
+      destroy_image( &page.gray );
+    }
+    if( page.binary ){
+      destroy_image( &page.binary );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Thresholds
+  //---------------------------------------------------------------------------
+
+  //
+  // Each threshold packs its row straight into the binary page; a pixel is
+  // ink when its gray level is at or below the threshold.
+  //
+
+  static void threshold_row( const Image::pixel_type* src,
+                             ubyte* dst,
+                             std::size_t width,
+                             int threshold ){
+    for( std::size_t x = 0; x < width; ++x ){
+      const int gray = (src[x].r + src[x].g + src[x].b) / 3;
+
+      if( gray <= threshold ){
+        dst[x >> 3] = (ubyte) (dst[x >> 3] | (0x80u >> (x & 7)));
+      }
+    }
+  }
+
+  static void threshold_row( const ubyte* src,
+                             ubyte* dst,
+                             std::size_t width,
+                             int threshold ){
+    for( std::size_t x = 0; x < width; ++x ){
+      if( src[x] <= threshold ){
+        dst[x >> 3] = (ubyte) (dst[x >> 3] | (0x80u >> (x & 7)));
+      }
+    }
+  }
+
+  template<typename Image_Type>
+  static Binary_Image* threshold_image( const Image_Type& image, int threshold ){
+    Binary_Image* binary = new Binary_Image( image.width(), image.height() );
+
+    for( std::size_t y = 0; y < image.height(); ++y ){
+      threshold_row( image.row( y ), binary->row( y ), image.width(), threshold );
+    }
+    return binary;
+  }
+
+  //---------------------------------------------------------------------------
+  // Grayscale Pages
+  //---------------------------------------------------------------------------
+
+  // Whether every pixel's channels are equal; a color page gives up at its
+  // first colored pixel
+  static bool is_grayscale( const Image& image ){
+    for( std::size_t y = 0; y < image.height(); ++y ){
+      const Image::pixel_type* src = image.row( y );
+
+      for( std::size_t x = 0; x < image.width(); ++x ){
+        if( src[x].r != src[x].g || src[x].r != src[x].b ){
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // The single channel of a page whose channels are all equal
+  static Gray_Image* gray_plane( const Image& image ){
+    Gray_Image* gray = new Gray_Image( image.width(), image.height() );
+
+    for( std::size_t y = 0; y < image.height(); ++y ){
+      const Image::pixel_type* src = image.row( y );
+      ubyte*                   dst = gray->row( y );
+
+      for( std::size_t x = 0; x < image.width(); ++x ){
+        dst[x] = src[x].r;
+      }
+    }
+    return gray;
+  }
+
+  //---------------------------------------------------------------------------
+  // Stages
+  //---------------------------------------------------------------------------
+
+  int Recognizer::load( const char* filename, page_image& page ) const{
+    if( !m_filters.empty() ){
+      return load_bmp_image_color( filename, &page.color );
+    }else if( m_threshold >= 0 ){
+      return load_bmp_image_grayscale( filename, &page.gray );
+    }
+    return load_bmp_image_binary( filename, &page.binary );
+  }
+
+  //---------------------------------------------------------------------------
+
+  int Recognizer::load( const ubyte* data, std::size_t size, page_image& page ) const{
+    if( !m_filters.empty() ){
+      return load_bmp_image_color( data, size, &page.color );
+    }else if( m_threshold >= 0 ){
+      return load_bmp_image_grayscale( data, size, &page.gray );
+    }
+    return load_bmp_image_binary( data, size, &page.binary );
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognizer::prepare( page_image& page ) const{
+    const int threshold = (m_threshold < 0) ? DEFAULT_THRESHOLD : m_threshold;
+
+    // Each filter operates on every channel alone, so a gray page gives the
+    // same channel filtered as one plane; its threshold is that channel too
+    if( page.color && is_grayscale( *page.color ) ){
+      page.gray = gray_plane( *page.color );
+      destroy_image( &page.color );
+    }
+
+    if( page.color ){
+      for( std::size_t i = 0; i < m_filters.size(); ++i ){
+        Image* filtered = new Image( m_filters[i]->operate( *page.color ) );
+
+        destroy_image( &page.color );
+        page.color = filtered;
+      }
+      page.binary = threshold_image( *page.color, threshold );
+      destroy_image( &page.color );
+    }
+    if( page.gray ){
+      for( std::size_t i = 0; i < m_filters.size(); ++i ){
+        Gray_Image* filtered = new Gray_Image( m_filters[i]->operate( *page.gray ) );
+
+        destroy_image( &page.gray );
+        page.gray = filtered;
+      }
+      page.binary = threshold_image( *page.gray, threshold );
+      destroy_image( &page.gray );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognizer::extract( const Binary_Image& image,
+                            feature_collection& features,
+                            boundary_collection& bounds ) const{
+    load_features( image, features, bounds, m_horizontal_divs, m_vertical_divs );
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognizer::classify( const feature_collection& features,
+                             const boundary_collection& bounds,
+                             Binary_Image& result ) const{
+    result.fill(0);
+
+    m_database->analyze( result, bounds, features );
+  }
+
+  //---------------------------------------------------------------------------
+  // Recognition
+  //---------------------------------------------------------------------------
+
+  int Recognizer::recognize( const char* filename, Binary_Image** result, std::size_t* glyphs ) const{
+    page_image page;
+    int status = load( filename, page );
+
+    if( status != IS_SUCCESS ){
+      return status;
+    }
+
+    recognize_loaded( page, result, glyphs );
+    return IS_SUCCESS;
+  }
+
+  //---------------------------------------------------------------------------
+
+  int Recognizer::recognize( const ubyte* data, std::size_t size, Binary_Image** result, std::size_t* glyphs ) const{
+    page_image page;
+    int status = load( data, size, page );
+
+    if( status != IS_SUCCESS ){
+      return status;
+    }
+
+    recognize_loaded( page, result, glyphs );
+    return IS_SUCCESS;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Recognizer::recognize_loaded( page_image& page, Binary_Image** result, std::size_t* glyphs ) const{
+    prepare( page );
+
+    feature_collection  features;
+    boundary_collection bounds;
+    extract( *page.binary, features, bounds );
+
+    (*result) = new Binary_Image( page.binary->width(), page.binary->height() );
+    classify( features, bounds, **result );
+
+    if( glyphs ){
+      (*glyphs) = bounds.size();
+    }
+
+    release( page );
+  }
+
+}  // namespace ocr
@@ -0,0 +1,252 @@
+/**
+ * @file Recognizer.hpp
+ *
+ * @brief This header defines the end-to-end recognition of a page, from
+ *        bitmap to recognized glyphs.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Recognizer.hpp created
+ * - Grayscale pages are filtered as a single plane
+ */
+#ifndef OCR_RECOGNIZER_HPP_
+#define OCR_RECOGNIZER_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+#include "Feature_Database.hpp"
+#include "Feature_Loader.hpp"
+#include "Image.hpp"
+#include "Kernel_Image_Operator.hpp"
+#include "Pixel_Image.hpp"
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Recognizer
+  ///
+  /// @brief Runs the whole recognition of a page against a loaded database
+  ///
+  /// A page is recognized in four stages, each of which is also available
+  /// on its own:
+  ///
+  ///   load     decode the bitmap
+  ///   prepare  apply the filters in order, then threshold to binary
+  ///   extract  label the glyphs and measure their feature vectors
+  ///   classify draw the closest database glyph over each found glyph
+  ///
+  /// Pages are decoded in the narrowest form their preparation needs:
+  /// straight to packed binary, where only pure black is ink, when there are
+  /// no filters and no threshold; to grayscale when there is only a
+  /// threshold; and to color only when they are to be filtered. A page to
+  /// be filtered whose channels turn out to be all equal, as a grayscale
+  /// bitmap's are, is filtered as a single plane, with the same result for
+  /// a third of the work.
+  ///
+  /// The recognizer only reads its database and filters, which must outlive
+  /// it; any number of threads may recognize pages with one recognizer.
+  /////////////////////////////////////////////////////////////////////////////
+  class Recognizer  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::vector<const Kernel_Image_Operator*> filter_collection;
+
+    ///
+    /// @brief A page between stages; load() sets one of the images, and
+    ///        prepare() leaves only the binary one
+    ///
+    struct page_image{
+      Image*        color;  ///< The page, when it is to be filtered
+      Gray_Image*   gray;   ///< The page, when it is only to be thresholded or is gray
+      Binary_Image* binary; ///< The page, once it is binary
+
+      page_image();
+    };
+
+    //-------------------------------------------------------------------------
+    // Constants
+    //-------------------------------------------------------------------------
+  public:
+
+    /// Threshold used for filtered pages when none is set
+    static const int DEFAULT_THRESHOLD = 127;
+
+    //-------------------------------------------------------------------------
+    // Constructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Constructs a recognizer that classifies against @p database
+    ///
+    /// @param database        the database to classify against
+    /// @param horizontal_divs the horizontal divisions of each feature
+    /// @param vertical_divs   the vertical divisions of each feature
+    ///
+    explicit Recognizer( const Feature_Database& database,
+                         std::size_t horizontal_divs = 5,
+                         std::size_t vertical_divs   = 5 );
+
+    //-------------------------------------------------------------------------
+    // Configuration
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Adds a filter to apply to every page, after those already added
+    ///
+    /// @param op the filter
+    ///
+    Recognizer& add_filter( const Kernel_Image_Operator& op );
+
+    ///
+    /// @brief Sets the gray level at and below which a pixel becomes ink
+    ///
+    /// @param threshold the threshold (0-255), or -1 to decode unfiltered
+    ///                  pages straight to binary
+    ///
+    Recognizer& set_threshold( int threshold );
+
+    ///
+    /// @brief Returns the filters applied to every page, in order
+    ///
+    const filter_collection& filters() const;
+
+    ///
+    /// @brief Returns the threshold, or -1 if none is set
+    ///
+    int threshold() const;
+
+    //-------------------------------------------------------------------------
+    // Stages
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Decodes a page in the form that prepare() expects
+    ///
+    /// @param filename the path to the bitmap
+    /// @param page     the decoded page; release with release()
+    /// @return the status of the load (see image_status)
+    ///
+    int load( const char* filename, page_image& page ) const;
+
+    ///
+    /// @brief Decodes a page held in memory in the form that prepare() expects
+    ///
+    /// @param data the bytes of the bitmap file
+    /// @param size the number of bytes at @p data
+    /// @param page the decoded page; release with release()
+    /// @return the status of the load (see image_status)
+    ///
+    int load( const ubyte* data, std::size_t size, page_image& page ) const;
+
+    ///
+    /// @brief Filters and thresholds a loaded page to binary
+    ///
+    /// A color page whose channels are all equal is first moved to a
+    /// Gray_Image, and filtered as one plane.
+    ///
+    /// @param page the page from load(); left holding only its binary image
+    ///
+    void prepare( page_image& page ) const;
+
+    ///
+    /// @brief Labels the glyphs of a binary page and measures their features
+    ///
+    /// @param image    the binary page
+    /// @param features the feature vector of each glyph
+    /// @param bounds   the boundary of each glyph
+    ///
+    void extract( const Binary_Image& image,
+                  feature_collection& features,
+                  boundary_collection& bounds ) const;
+
+    ///
+    /// @brief Draws the recognized glyph over each boundary of @p result
+    ///
+    /// @param features the features from extract()
+    /// @param bounds   the boundaries from extract()
+    /// @param result   the output page, already sized to the input page
+    ///
+    void classify( const feature_collection& features,
+                   const boundary_collection& bounds,
+                   Binary_Image& result ) const;
+
+    ///
+    /// @brief Destroys every image a page holds
+    ///
+    static void release( page_image& page );
+
+    //-------------------------------------------------------------------------
+    // Recognition
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Runs every stage on a page
+    ///
+    /// @param filename the path to the bitmap
+    /// @param result   the recognized page; release with destroy_image
+    /// @param glyphs   if not null, receives the number of glyphs found
+    /// @return the status of the load (see image_status)
+    ///
+    int recognize( const char* filename, Binary_Image** result, std::size_t* glyphs = nullptr ) const;
+
+    ///
+    /// @brief Runs every stage on a page held in memory
+    ///
+    /// @param data   the bytes of the bitmap file
+    /// @param size   the number of bytes at @p data
+    /// @param result the recognized page; release with destroy_image
+    /// @param glyphs if not null, receives the number of glyphs found
+    /// @return the status of the load (see image_status)
+    ///
+    int recognize( const ubyte* data, std::size_t size, Binary_Image** result, std::size_t* glyphs = nullptr ) const;
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    void recognize_loaded( page_image& page, Binary_Image** result, std::size_t* glyphs ) const;
+
+    const Feature_Database* m_database;        ///< The database to classify against
+    filter_collection       m_filters;         ///< Filters applied in order
+    std::size_t             m_horizontal_divs; ///< Horizontal feature divisions
+    std::size_t             m_vertical_divs;   ///< Vertical feature divisions
+    int                     m_threshold;       ///< Ink threshold, or -1
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline const Recognizer::filter_collection& Recognizer::filters() const{
+    return m_filters;
+  }
+
+  inline int Recognizer::threshold() const{
+    return m_threshold;
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_RECOGNIZER_HPP_ */
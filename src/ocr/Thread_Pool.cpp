@@ -0,0 +1,106 @@
+/**
+ * @file Thread_Pool.cpp
+ *
+ * @brief This source defines the worker loop of the thread pool.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Thread_Pool.cpp created
+ */
+#include "Thread_Pool.hpp"
+
+namespace ocr {
+
+  //---------------------------------------------------------------------------
+  // Constructor / Destructor
+  //---------------------------------------------------------------------------
+
+  Thread_Pool::Thread_Pool( std::size_t threads )
+    : m_active(0),
+      m_stopping(false)
+  {
+    if( threads == 0 ){
+      threads = default_size();
+    }
+
+    m_threads.reserve( threads );
+    for( std::size_t i = 0; i < threads; ++i ){
+      m_threads.push_back( std::thread( &Thread_Pool::run, this ) );
+    }
+  }
+
+  Thread_Pool::~Thread_Pool(){
+    wait();
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_stopping = true;
+    }
+    m_task_ready.notify_all();
+
+    for( std::size_t i = 0; i < m_threads.size(); ++i ){
+      m_threads[i].join();
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // Tasks
+  //---------------------------------------------------------------------------
+
+  void Thread_Pool::submit( const task_type& task ){
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_tasks.push_back( task );
+    }
+    m_task_ready.notify_one();
+  }
+
+  void Thread_Pool::wait(){
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while( !m_tasks.empty() || m_active ){
+      m_idle.wait( lock );
+    }
+  }
+
+  std::size_t Thread_Pool::default_size(){
+    const std::size_t threads = std::thread::hardware_concurrency();
+
+    // hardware_concurrency may not know; fall back to a single worker
+    return threads ? threads : 1;
+  }
+
+  //---------------------------------------------------------------------------
+
+  void Thread_Pool::run(){
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    while( true ){
+      while( m_tasks.empty() && !m_stopping ){
+        m_task_ready.wait( lock );
+      }
+      if( m_tasks.empty() ){
+        return; // stopping, and nothing left to do
+      }
+
+      task_type task = m_tasks.front();
+      m_tasks.pop_front();
+      ++m_active;
+
+      lock.unlock();
+      task();
+      lock.lock();
+
+      --m_active;
+      if( m_tasks.empty() && !m_active ){
+        m_idle.notify_all();
+      }
+    }
+  }
+
+}  // namespace ocr
@@ -0,0 +1,126 @@
+/**
+ * @file Thread_Pool.hpp
+ *
+ * @brief This header defines a fixed-size pool of worker threads.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Thread_Pool.hpp created
+ */
+#ifndef OCR_THREAD_POOL_HPP_
+#define OCR_THREAD_POOL_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // std::size_t
+#include <deque>              // std::deque
+#include <functional>         // std::function
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+namespace ocr {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @class ocr::Thread_Pool
+  ///
+  /// @brief A fixed set of worker threads that run submitted tasks in the
+  ///        order they were submitted.
+  ///
+  /// Tasks must not throw. The destructor waits for every submitted task to
+  /// finish before joining the workers.
+  /////////////////////////////////////////////////////////////////////////////
+  class Thread_Pool  {
+
+    //-------------------------------------------------------------------------
+    // Public Member Types
+    //-------------------------------------------------------------------------
+  public:
+
+    typedef std::function<void()> task_type;
+
+    //-------------------------------------------------------------------------
+    // Constructor / Destructor
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Starts a pool of @p threads workers
+    ///
+    /// @param threads the number of workers; 0 uses one per hardware thread
+    ///
+    explicit Thread_Pool( std::size_t threads = 0 );
+
+    ///
+    /// @brief Waits for every task to finish, then stops the workers
+    ///
+    ~Thread_Pool();
+
+    //-------------------------------------------------------------------------
+    // Tasks
+    //-------------------------------------------------------------------------
+  public:
+
+    ///
+    /// @brief Queues a task to be run by the next idle worker
+    ///
+    /// @param task the task to run
+    ///
+    void submit( const task_type& task );
+
+    ///
+    /// @brief Blocks until every submitted task has finished
+    ///
+    void wait();
+
+    ///
+    /// @brief Returns the number of workers in the pool
+    ///
+    std::size_t size() const;
+
+    ///
+    /// @brief Returns the number of workers a pool starts by default
+    ///
+    static std::size_t default_size();
+
+    //-------------------------------------------------------------------------
+    // Private Members
+    //-------------------------------------------------------------------------
+  private:
+
+    // Not copyable
+    Thread_Pool( const Thread_Pool& );
+    Thread_Pool& operator = ( const Thread_Pool& );
+
+    void run();
+
+    std::vector<std::thread> m_threads;    ///< The workers
+    std::deque<task_type>    m_tasks;      ///< Tasks waiting for a worker
+    std::mutex               m_mutex;      ///< Guards every member below
+    std::condition_variable  m_task_ready; ///< Signalled when a task is queued
+    std::condition_variable  m_idle;       ///< Signalled when the pool drains
+    std::size_t              m_active;     ///< Tasks currently running
+    bool                     m_stopping;   ///< Set when the pool is destroyed
+  };
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  inline std::size_t Thread_Pool::size() const{
+    return m_threads.size();
+  }
+
+}  // namespace ocr
+
+#endif /* OCR_THREAD_POOL_HPP_ */
@@ -0,0 +1,240 @@
+/**
+ * @file Traversal.hpp
+ *
+ * @brief This header defines the row-major traversals shared by the
+ *        per-pixel and neighbourhood loops of the library.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - Traversal.hpp created
+ */
+#ifndef OCR_TRAVERSAL_HPP_
+#define OCR_TRAVERSAL_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+#include "base_types.hpp"
+#include "Image_Layout.hpp"
+#include "Image_View.hpp"
+#include "simd.hpp"
+
+#include <cstddef> // std::size_t, std::ptrdiff_t
+
+namespace ocr {
+
+  //
+  // Images are stored row after row, so the pixels of a row share cache
+  // lines and the next pixel along it is already loaded; the next pixel
+  // down a column is a whole stride away, on another line and, for a page,
+  // often another page of memory. Every loop over the pixels of an image
+  // should therefore walk along rows on the inside. These traversals do,
+  // and prefetch the rows they are about to reach, so that a large page is
+  // streamed at the bandwidth of memory rather than read at its latency.
+  //
+
+  ///
+  /// @brief The rows ahead of the one being visited that are prefetched
+  ///
+  const std::size_t PREFETCH_ROWS = 2;
+
+  //---------------------------------------------------------------------------
+  // Rows and Pixels
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Hints that every cache line of a row of @p width pixels is
+  ///        about to be read
+  ///
+  /// @param row   the first pixel of the row
+  /// @param width the pixels in the row
+  ///
+  template<typename Pixel>
+  void prefetch_row( const Pixel* row, std::size_t width );
+
+  ///
+  /// @brief Calls @p f( y, row ) for each row of @p view, top to bottom
+  ///
+  /// @param view the pixels to visit
+  /// @param f    the function to call with the index and first pixel of
+  ///             each row
+  ///
+  template<typename Pixel, typename Function>
+  void for_each_row( const Image_View<Pixel>& view, Function f );
+
+  ///
+  /// @brief Calls @p f( pixel ) for each pixel of @p view, along each row
+  ///        in turn
+  ///
+  /// @param view the pixels to visit
+  /// @param f    the function to call with a reference to each pixel
+  ///
+  template<typename Pixel, typename Function>
+  void for_each_pixel( const Image_View<Pixel>& view, Function f );
+
+  //---------------------------------------------------------------------------
+  // Neighbourhoods
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Calls @p f( y, rows ) for each row of @p view, where rows holds
+  ///        the 2 * Radius + 1 rows around it, from Radius rows above to
+  ///        Radius rows below
+  ///
+  /// A neighbourhood operation reads each row 2 * Radius + 1 times, once
+  /// for each row it is near, and walking the rows in order keeps all of
+  /// them in cache in between. The rows above the first and below the last
+  /// are read from the image's border, which must be at least @p Radius
+  /// rows deep (see image_layout).
+  ///
+  /// @tparam Radius the rows read above and below each row
+  /// @param  view   the pixels to visit
+  /// @param  f      the function to call with the index of each row and
+  ///                the rows around it
+  ///
+  template<std::size_t Radius, typename Pixel, typename Function>
+  void for_each_row_window( const Image_View<Pixel>& view, Function f );
+
+  //---------------------------------------------------------------------------
+  // Columns
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Returns the columns of values of type @p T that share one cache
+  ///        line of each row
+  ///
+  template<typename T>
+  std::size_t column_block();
+
+  ///
+  /// @brief Calls @p f( column, x ) for each column of a row-major array,
+  ///        with the column gathered into contiguous memory, and then
+  ///        stores the column back
+  ///
+  /// An operation that runs down columns would read one value from each
+  /// cache line it loads. Instead, the columns are gathered column_block()
+  /// at a time, every value of each line it loads, row by row, and then
+  /// handed on one at a time.
+  ///
+  /// @param data    the array, row after row
+  /// @param width   the columns of the array
+  /// @param height  the rows of the array
+  /// @param stride  the values from one row to the next
+  /// @param columns column_block<T>() * height values of scratch
+  /// @param f       the function to call with each column and its index,
+  ///                which may change the column in place
+  ///
+  template<typename T, typename Function>
+  void for_each_column( T* data,
+                        std::size_t width,
+                        std::size_t height,
+                        std::size_t stride,
+                        T* columns,
+                        Function f );
+
+  //---------------------------------------------------------------------------
+  // Inline Definitions
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel>
+  inline void prefetch_row( const Pixel* row, std::size_t width ){
+    const char* bytes = reinterpret_cast<const char*>( row );
+
+    for( std::size_t b = 0; b < width * sizeof(Pixel); b += VECTOR_ALIGNMENT ){
+      OCR_PREFETCH( bytes + b );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename Pixel, typename Function>
+  inline void for_each_row( const Image_View<Pixel>& view, Function f ){
+    const std::size_t height = view.height();
+
+    for( std::size_t y = 0; y < height; ++y ){
+      if( y + PREFETCH_ROWS < height ){
+        prefetch_row( view.row( y + PREFETCH_ROWS ), view.width() );
+      }
+      f( y, view.row( y ) );
+    }
+  }
+
+  template<typename Pixel, typename Function>
+  inline void for_each_pixel( const Image_View<Pixel>& view, Function f ){
+    const std::size_t width = view.width();
+
+    for_each_row( view, [&]( std::size_t, Pixel* row ){
+      for( std::size_t x = 0; x < width; ++x ){
+        f( row[x] );
+      }
+    } );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<std::size_t Radius, typename Pixel, typename Function>
+  inline void for_each_row_window( const Image_View<Pixel>& view, Function f ){
+    const std::ptrdiff_t stride = (std::ptrdiff_t) view.stride();
+
+    Pixel* rows[2 * Radius + 1];
+
+    for_each_row( view, [&]( std::size_t y, Pixel* row ){
+      for( std::size_t k = 0; k <= 2 * Radius; ++k ){
+        rows[k] = row + ((std::ptrdiff_t) k - (std::ptrdiff_t) Radius) * stride;
+      }
+      f( y, (Pixel* const*) rows );
+    } );
+  }
+
+  //---------------------------------------------------------------------------
+
+  template<typename T>
+  inline std::size_t column_block(){
+    return (sizeof(T) < VECTOR_ALIGNMENT) ? VECTOR_ALIGNMENT / sizeof(T) : 1;
+  }
+
+  template<typename T, typename Function>
+  inline void for_each_column( T* data,
+                               std::size_t width,
+                               std::size_t height,
+                               std::size_t stride,
+                               T* columns,
+                               Function f ){
+    const std::size_t block = column_block<T>();
+
+    for( std::size_t x = 0; x < width; x += block ){
+      const std::size_t count = (width - x < block) ? width - x : block;
+
+      for( std::size_t y = 0; y < height; ++y ){
+        const T* from = data + y * stride + x;
+
+        for( std::size_t c = 0; c < count; ++c ){
+          columns[c * height + y] = from[c];
+        }
+      }
+
+      for( std::size_t c = 0; c < count; ++c ){
+        f( columns + c * height, x + c );
+      }
+
+      for( std::size_t y = 0; y < height; ++y ){
+        T* to = data + y * stride + x;
+
+        for( std::size_t c = 0; c < count; ++c ){
+          to[c] = columns[c * height + y];
+        }
+      }
+    }
+  }
+
+} // namespace ocr
+
+#endif /* OCR_TRAVERSAL_HPP_ */
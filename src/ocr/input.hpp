@@ -32,12 +32,15 @@ namespace ocr {
   ///
   /// @brief Clear the system screen
   ///
-  /// I hate having to do it using system() calls, but it's the simplest way
-  /// for a software project on short notice, instead of using curses or
-  /// windows api.
+  /// Terminals other than the Windows console understand the ANSI escapes,
+  /// which saves spawning a shell on every menu.
   ///
   inline void clear(){
+#if defined(_WIN32)
     if(system("cls")) system("clear");
+#else
+    std::cout << "\033[2J\033[H" << std::flush;
+#endif
   }
 
   template<typename T>
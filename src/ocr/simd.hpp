@@ -0,0 +1,109 @@
+/**
+ * @file simd.hpp
+ *
+ * @brief This header defines compiler hints used to vectorize the per-pixel
+ *        loops of the library.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - simd.hpp created
+ * - Functions are also cloned for SSE4.1
+ * - Added OCR_FORCE_INLINE
+ * - Added OCR_PREFETCH
+ */
+#ifndef OCR_SIMD_HPP_
+#define OCR_SIMD_HPP_
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif
+
+//----------------------------------------------------------------------------
+// Restrict
+//----------------------------------------------------------------------------
+
+///
+/// @def OCR_RESTRICT
+///
+/// @brief Promises the compiler that a pointer does not alias any other
+///        pointer in scope
+///
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+# define OCR_RESTRICT __restrict
+#else
+# define OCR_RESTRICT
+#endif
+
+//----------------------------------------------------------------------------
+// Inlining
+//----------------------------------------------------------------------------
+
+///
+/// @def OCR_FORCE_INLINE
+///
+/// @brief Inlines a function into every caller, so that a template body is
+///        compiled once into each of the target clones that call it
+///
+#if defined(__GNUC__) || defined(__clang__)
+# define OCR_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+# define OCR_FORCE_INLINE __forceinline
+#else
+# define OCR_FORCE_INLINE inline
+#endif
+
+//----------------------------------------------------------------------------
+// Function Multi-versioning
+//----------------------------------------------------------------------------
+
+///
+/// @def OCR_TARGET_CLONES
+///
+/// @brief Compiles a function once per supported instruction set, and picks
+///        the best version for the running CPU when the program is loaded
+///
+/// Loops over interleaved 3-byte pixels only vectorize once byte shuffles
+/// (SSSE3) are available, which the baseline x86-64 target does not
+/// guarantee; clamping 32-bit lanes needs the min and max of SSE4.1. Where
+/// the toolchain cannot dispatch at load time this expands to nothing and
+/// the function is compiled for the baseline target.
+///
+/// None of the targets contract a multiply and an add into an FMA, so every
+/// version of a function computes bit-identical floating point results.
+///
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__linux__)
+# define OCR_TARGET_CLONES \
+  __attribute__((target_clones("avx2","sse4.1","ssse3","default")))
+#else
+# define OCR_TARGET_CLONES
+#endif
+
+//----------------------------------------------------------------------------
+// Prefetching
+//----------------------------------------------------------------------------
+
+///
+/// @def OCR_PREFETCH
+///
+/// @brief Hints that the cache line holding an address is about to be read
+///
+/// The hint never faults, and expands to nothing where the toolchain has no
+/// way to give it.
+///
+#if defined(__GNUC__) || defined(__clang__)
+# define OCR_PREFETCH(address) __builtin_prefetch( (address), 0, 3 )
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <xmmintrin.h>
+# define OCR_PREFETCH(address) _mm_prefetch( (const char*) (address), _MM_HINT_T0 )
+#else
+# define OCR_PREFETCH(address) ((void) 0)
+#endif
+
+#endif /* OCR_SIMD_HPP_ */
@@ -0,0 +1,435 @@
+/**
+ * @file bmp_decoding.cpp
+ *
+ * @brief This test decodes small bitmaps held in memory, in every layout
+ *        the loader reads, and checks that malformed ones are rejected.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - bmp_decoding.cpp created
+ */
+#include "ocr/BMP_Loader.hpp"
+#include "ocr/Color.hpp"
+#include "ocr/Image.hpp"
+#include "ocr/Pixel_Image.hpp"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <cstdio>   // std::printf
+#include <cstring>  // std::memcpy
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+using namespace ocr;
+
+namespace {
+
+  typedef std::vector<ubyte> byte_vector;
+
+  const u32 BI_RGB       = 0;
+  const u32 BI_BITFIELDS = 3;
+
+  //---------------------------------------------------------------------------
+  // Bitmaps
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @struct bitmap
+  ///
+  /// @brief The fields of a bitmap to encode; @c rows holds each row's
+  ///        stored bytes, top row first, without padding
+  ///
+  struct bitmap{
+    s32                      width;
+    s32                      height;      ///< Negative for a top-down bitmap
+    u16                      bpp;
+    u32                      compression;
+    u32                      colors;      ///< The colors field of the header
+    std::vector<Color_RGB>   palette;
+    u32                      masks[3];    ///< Red, green and blue, for BI_BITFIELDS
+    std::vector<byte_vector> rows;
+  };
+
+  void put_u16( byte_vector& out, u16 value ){
+    out.push_back( (ubyte) value );
+    out.push_back( (ubyte) (value >> 8) );
+  }
+
+  void put_u32( byte_vector& out, u32 value ){
+    put_u16( out, (u16) value );
+    put_u16( out, (u16) (value >> 16) );
+  }
+
+  ///
+  /// @brief Encodes @p bmp as the bytes of a bitmap file
+  ///
+  byte_vector encode( const bitmap& bmp ){
+    const bool        masked   = (bmp.compression == BI_BITFIELDS);
+    const std::size_t row_size = (((std::size_t) bmp.width * bmp.bpp + 31) / 32) * 4;
+    const u32         offset   = (u32) (14 + 40 + (masked ? 12 : 0) + 4 * bmp.palette.size());
+    const std::size_t rows     = bmp.rows.size();
+
+    byte_vector out;
+    out.push_back( 'B' );
+    out.push_back( 'M' );
+    put_u32( out, (u32) (offset + row_size * rows) );
+    put_u16( out, 0 );
+    put_u16( out, 0 );
+    put_u32( out, offset );
+
+    put_u32( out, 40 );
+    put_u32( out, (u32) bmp.width );
+    put_u32( out, (u32) bmp.height );
+    put_u16( out, 1 );
+    put_u16( out, bmp.bpp );
+    put_u32( out, bmp.compression );
+    put_u32( out, (u32) (row_size * rows) );
+    put_u32( out, 2835 );
+    put_u32( out, 2835 );
+    put_u32( out, bmp.colors );
+    put_u32( out, 0 );
+
+    if( masked ){
+      put_u32( out, bmp.masks[0] );
+      put_u32( out, bmp.masks[1] );
+      put_u32( out, bmp.masks[2] );
+    }
+    for( std::size_t i = 0; i < bmp.palette.size(); ++i ){
+      out.push_back( bmp.palette[i].b );
+      out.push_back( bmp.palette[i].g );
+      out.push_back( bmp.palette[i].r );
+      out.push_back( 0 );
+    }
+
+    // Rows are stored bottom-up unless the height is negative
+    for( std::size_t i = 0; i < rows; ++i ){
+      const byte_vector& row = bmp.rows[(bmp.height < 0) ? i : rows - i - 1];
+      byte_vector        padded( row_size, 0 );
+
+      std::memcpy( &padded[0], &row[0], row.size() );
+      out.insert( out.end(), padded.begin(), padded.end() );
+    }
+    return out;
+  }
+
+  bitmap make_bitmap( s32 width, s32 height, u16 bpp ){
+    bitmap bmp;
+    bmp.width       = width;
+    bmp.height      = height;
+    bmp.bpp         = bpp;
+    bmp.compression = BI_RGB;
+    bmp.colors      = 0;
+    bmp.masks[0]    = bmp.masks[1] = bmp.masks[2] = 0;
+    return bmp;
+  }
+
+  ///
+  /// @brief Makes a palette of @p count distinct colors
+  ///
+  std::vector<Color_RGB> make_palette( std::size_t count ){
+    std::vector<Color_RGB> palette;
+    for( std::size_t i = 0; i < count; ++i ){
+      palette.push_back( Color_RGB( (ubyte) (i * 37 + 11), (ubyte) (255 - i), (ubyte) (i * 5) ) );
+    }
+    return palette;
+  }
+
+  ///
+  /// @brief Makes a palettized bitmap whose pixel (x, y) is the palette
+  ///        entry returned by @p index
+  ///
+  bitmap make_indexed( s32 width, s32 height, u16 bpp, std::size_t colors,
+                       u32 (*index)( s32, s32 ) ){
+    bitmap bmp  = make_bitmap( width, height, bpp );
+    bmp.colors  = (u32) colors;
+    bmp.palette = make_palette( colors );
+
+    const s32 rows = (height < 0) ? -height : height;
+    for( s32 y = 0; y < rows; ++y ){
+      byte_vector row( ((std::size_t) width * bpp + 7) / 8, 0 );
+      for( s32 x = 0; x < width; ++x ){
+        const std::size_t bit = (std::size_t) x * bpp;
+        row[bit / 8] |= (ubyte) (index( x, y ) << (8 - bpp - bit % 8));
+      }
+      bmp.rows.push_back( row );
+    }
+    return bmp;
+  }
+
+  u32 index_1( s32 x, s32 y ){ return (u32) ((x + y) % 2); }
+  u32 index_4( s32 x, s32 y ){ return (u32) ((x * 3 + y) % 16); }
+  u32 index_8( s32 x, s32 y ){ return (u32) ((x * 29 + y * 7) % 200); }
+
+  Color_RGB color_at( s32 x, s32 y ){
+    return Color_RGB( (ubyte) (x * 40 + y), (ubyte) (y * 50 + 3), (ubyte) (x * y * 9) );
+  }
+
+  ///
+  /// @brief Makes a 24 or 32 bit bitmap of color_at()
+  ///
+  bitmap make_direct( s32 width, s32 height, u16 bpp ){
+    bitmap bmp = make_bitmap( width, height, bpp );
+
+    const s32 rows = (height < 0) ? -height : height;
+    for( s32 y = 0; y < rows; ++y ){
+      byte_vector row;
+      for( s32 x = 0; x < width; ++x ){
+        const Color_RGB c = color_at( x, y );
+        row.push_back( c.b );
+        row.push_back( c.g );
+        row.push_back( c.r );
+        if( bpp == 32 ){
+          row.push_back( 0xff );
+        }
+      }
+      bmp.rows.push_back( row );
+    }
+    return bmp;
+  }
+
+  ///
+  /// @brief Makes a BI_BITFIELDS bitmap of @p values under @p masks
+  ///
+  bitmap make_masked( s32 width, s32 height, const u32 (&masks)[3],
+                      u32 (*value)( s32, s32 ) ){
+    bitmap bmp      = make_bitmap( width, height, 32 );
+    bmp.compression = BI_BITFIELDS;
+    bmp.masks[0]    = masks[0];
+    bmp.masks[1]    = masks[1];
+    bmp.masks[2]    = masks[2];
+
+    for( s32 y = 0; y < height; ++y ){
+      byte_vector row;
+      for( s32 x = 0; x < width; ++x ){
+        put_u32( row, value( x, y ) );
+      }
+      bmp.rows.push_back( row );
+    }
+    return bmp;
+  }
+
+  u32 value_10( s32 x, s32 y ){
+    return ((u32) (x * 100) << 20) | ((u32) (y * 300) << 10) | (u32) (x * y * 50);
+  }
+
+  u32 value_28( s32 x, s32 y ){
+    return (u32) (x * 0x2345671 + y * 0x1111111) & 0x0fffffffu;
+  }
+
+  ///
+  /// @brief Scales the bits of @p pixel under @p mask to 0-255
+  ///
+  ubyte scale_channel( u32 pixel, u32 mask ){
+    if( !mask ){
+      return 0;
+    }
+    u32 shift = 0;
+    while( !((mask >> shift) & 1u) ){
+      ++shift;
+    }
+    const std::uint64_t maximum = mask >> shift;
+    return (ubyte) ((((pixel & mask) >> shift) * (std::uint64_t) 255) / maximum);
+  }
+
+  //---------------------------------------------------------------------------
+  // Checks
+  //---------------------------------------------------------------------------
+
+  std::size_t g_failures = 0;
+  std::size_t g_checks   = 0;
+
+  void report( bool passed, const std::string& what ){
+    ++g_checks;
+    if( !passed ){
+      ++g_failures;
+      std::printf( "FAIL %s\n", what.c_str() );
+    }
+  }
+
+  bool same( const Color_RGB& a, const Color_RGB& b ){
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+  }
+
+  ///
+  /// @brief Decodes @p bytes in color and in gray, and checks every pixel
+  ///        against @p expected
+  ///
+  template<typename Expected>
+  void check_decode( const std::string& name, const byte_vector& bytes,
+                     std::size_t width, std::size_t height, Expected expected ){
+    Image* image = NULL;
+    const int status = load_bmp_image_color( &bytes[0], bytes.size(), &image );
+
+    report( status == IS_SUCCESS, name + ": loads" );
+    if( status != IS_SUCCESS ){
+      return;
+    }
+    report( image->width() == width && image->height() == height, name + ": size" );
+
+    bool matches = (image->width() == width && image->height() == height);
+    for( std::size_t y = 0; matches && y < height; ++y ){
+      for( std::size_t x = 0; matches && x < width; ++x ){
+        matches = same( image->at( (int) x, (int) y ), expected( (s32) x, (s32) y ) );
+      }
+    }
+    report( matches, name + ": color pixels" );
+    destroy_image( &image );
+
+    // Gray is the mean of the channels
+    Gray_Image* gray = NULL;
+    report( load_bmp_image_grayscale( &bytes[0], bytes.size(), &gray ) == IS_SUCCESS,
+            name + ": loads as gray" );
+    if( !gray ){
+      return;
+    }
+    matches = (gray->width() == width && gray->height() == height);
+    for( std::size_t y = 0; matches && y < height; ++y ){
+      for( std::size_t x = 0; matches && x < width; ++x ){
+        const Color_RGB c = expected( (s32) x, (s32) y );
+        matches = (gray->at( (int) x, (int) y ) == (c.r + c.g + c.b) / 3);
+      }
+    }
+    report( matches, name + ": gray pixels" );
+    destroy_image( &gray );
+  }
+
+  void check_rejected( const std::string& name, const byte_vector& bytes ){
+    Image*   image = NULL;
+    bmp_view view;
+
+    report( open_bmp_view( &bytes[0], bytes.size(), &view ) == IS_TYPE_INVALID,
+            name + ": view rejected" );
+    report( load_bmp_image_color( &bytes[0], bytes.size(), &image ) == IS_TYPE_INVALID,
+            name + ": load rejected" );
+    if( image ){
+      destroy_image( &image );
+    }
+  }
+
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Looks up the pixels of a palettized bitmap
+  ///
+  struct palette_lookup{
+    std::vector<Color_RGB> palette;
+    u32 (*index)( s32, s32 );
+
+    Color_RGB operator()( s32 x, s32 y ) const{
+      return palette[index( x, y )];
+    }
+  };
+
+  struct masked_lookup{
+    u32 masks[3];
+    u32 (*value)( s32, s32 );
+
+    Color_RGB operator()( s32 x, s32 y ) const{
+      const u32 pixel = value( x, y );
+      return Color_RGB( scale_channel( pixel, masks[0] ),
+                        scale_channel( pixel, masks[1] ),
+                        scale_channel( pixel, masks[2] ) );
+    }
+  };
+
+  void check_indexed( const std::string& name, s32 width, s32 height, u16 bpp,
+                      std::size_t colors, u32 (*index)( s32, s32 ) ){
+    const bitmap   bmp = make_indexed( width, height, bpp, colors, index );
+    palette_lookup lookup;
+    lookup.palette = bmp.palette;
+    lookup.index   = index;
+
+    check_decode( name, encode( bmp ), width, (height < 0) ? -height : height, lookup );
+  }
+
+  void check_masked( const std::string& name, s32 width, s32 height,
+                     const u32 (&masks)[3], u32 (*value)( s32, s32 ) ){
+    masked_lookup lookup;
+    lookup.masks[0] = masks[0];
+    lookup.masks[1] = masks[1];
+    lookup.masks[2] = masks[2];
+    lookup.value    = value;
+
+    check_decode( name, encode( make_masked( width, height, masks, value ) ), width, height, lookup );
+  }
+
+} // anonymous namespace
+
+int main(){
+
+  // Palettized, with widths that leave part of the last byte unused
+  check_indexed( "1 bpp", 11, 3, 1, 2, index_1 );
+  check_indexed( "1 bpp top-down", 11, -3, 1, 2, index_1 );
+  check_indexed( "4 bpp", 5, 4, 4, 16, index_4 );
+  check_indexed( "8 bpp", 7, 5, 8, 256, index_8 );
+  check_indexed( "8 bpp short table", 7, 5, 8, 200, index_8 );
+
+  // Direct color, with row padding for 24 bits
+  check_decode( "24 bpp", encode( make_direct( 5, 3, 24 ) ), 5, 3, color_at );
+  check_decode( "24 bpp top-down", encode( make_direct( 5, -3, 24 ) ), 5, 3, color_at );
+  check_decode( "32 bpp", encode( make_direct( 4, 3, 32 ) ), 4, 3, color_at );
+
+  // Bit fields of 10 bits each, and one of 28 bits, whose scale to 0-255
+  // takes more than 32 bits
+  const u32 masks_10[3] = { 0x3ff00000u, 0x000ffc00u, 0x000003ffu };
+  const u32 masks_28[3] = { 0x0fffffffu, 0, 0 };
+  check_masked( "bit fields 10", 6, 4, masks_10, value_10 );
+  check_masked( "bit fields 28", 6, 4, masks_28, value_28 );
+
+  //---------------------------------------------------------------------------
+
+  // An index past a short color table; one in the padding of the last byte
+  // is not a pixel, and is ignored
+  {
+    bitmap bmp = make_indexed( 5, 2, 4, 3, index_1 );
+    byte_vector padded = encode( bmp );
+    padded[padded.size() - 4 + 2] |= 0x0f; // the unused half of the top row's last byte
+    check_decode( "4 bpp padding", padded, 5, 2, palette_lookup{ bmp.palette, index_1 } );
+
+    bmp.rows[1][1] = 0x05;
+    check_rejected( "4 bpp index past table", encode( bmp ) );
+  }
+  {
+    bitmap bmp = make_indexed( 7, 5, 8, 200, index_8 );
+    bmp.rows[4][6] = 200;
+    check_rejected( "8 bpp index past table", encode( bmp ) );
+  }
+
+  // A row cut short by the end of the file
+  {
+    byte_vector bytes = encode( make_direct( 5, 3, 24 ) );
+    bytes.pop_back();
+    check_rejected( "truncated row", bytes );
+  }
+
+  // The most negative height, which cannot be negated
+  {
+    byte_vector bytes = encode( make_direct( 5, 3, 24 ) );
+    const u32 height = 0x80000000u;
+    std::memcpy( &bytes[22], &height, sizeof(height) );
+    check_rejected( "INT_MIN height", bytes );
+  }
+
+  // Neither a bitmap's magic nor a whole header
+  {
+    byte_vector bytes = encode( make_direct( 5, 3, 24 ) );
+    bytes[0] = 'X';
+    check_rejected( "bad magic", bytes );
+
+    bytes = encode( make_direct( 5, 3, 24 ) );
+    bytes.resize( 30 );
+    check_rejected( "truncated header", bytes );
+  }
+
+  std::printf( "%u of %u checks failed\n",
+               static_cast<unsigned>( g_failures ),
+               static_cast<unsigned>( g_checks ) );
+  return g_failures == 0 ? 0 : 1;
+}
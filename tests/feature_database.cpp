@@ -0,0 +1,307 @@
+/**
+ * @file feature_database.cpp
+ *
+ * @brief This test saves a feature database, loads it back and checks that
+ *        its classes and vectors come back unchanged, and that malformed
+ *        databases are rejected.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - feature_database.cpp created
+ */
+#include "ocr/Color.hpp"
+#include "ocr/Feature_Database.hpp"
+#include "ocr/Feature_Loader.hpp"
+#include "ocr/Feature_Vector.hpp"
+#include "ocr/Image.hpp"
+#include "ocr/Pixel_Image.hpp"
+
+#include <cstddef>  // std::size_t
+#include <cstdio>   // std::printf, std::remove
+#include <cstring>  // std::memcpy
+#include <fstream>  // std::ifstream, std::ofstream
+#include <iterator> // std::istreambuf_iterator
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+using namespace ocr;
+
+namespace {
+
+  typedef std::vector<ubyte> byte_vector;
+
+  const char* const SAVED    = "feature_database_saved.fdbx";
+  const char* const RESAVED  = "feature_database_resaved.fdbx";
+  const char* const MANGLED  = "feature_database_mangled.fdbx";
+
+  const std::size_t LENGTH = 7; ///< Components of each vector; not a multiple of the row alignment
+
+  //---------------------------------------------------------------------------
+  // Classes
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @struct sample_class
+  ///
+  /// @brief A glyph and its vectors, as inserted into the database
+  ///
+  struct sample_class{
+    sample_class( std::size_t width, std::size_t height )
+      : glyph(width, height)
+    {
+    }
+
+    Image              glyph;
+    feature_collection vectors;
+  };
+
+  ///
+  /// @brief Makes a class of a @p width by @p height glyph, with @p count
+  ///        vectors, all different for each @p seed
+  ///
+  sample_class make_class( std::size_t width, std::size_t height,
+                           std::size_t count, std::size_t seed ){
+    sample_class sample( width, height );
+
+    for( std::size_t y = 0; y < height; ++y ){
+      for( std::size_t x = 0; x < width; ++x ){
+        const bool ink = ((x * 3 + y * 5 + seed) % 7) < 3;
+        sample.glyph.set( x, y, ink ? Color_RGB::BLACK : Color_RGB( 255, 255, 255 ) );
+      }
+    }
+
+    for( std::size_t v = 0; v < count; ++v ){
+      Feature_Vector::feature_collection values;
+      for( std::size_t k = 0; k < LENGTH; ++k ){
+        // Exactly representable as a float, so it survives the narrowing
+        values.push_back( (double) (seed * 100 + v * 10 + k) / 8.0 - 20.0 );
+      }
+      sample.vectors.push_back( Feature_Vector( values ) );
+    }
+    return sample;
+  }
+
+  //---------------------------------------------------------------------------
+  // Files
+  //---------------------------------------------------------------------------
+
+  byte_vector read_file( const char* filename ){
+    std::ifstream file( filename, std::ios::in | std::ios::binary );
+    return byte_vector( std::istreambuf_iterator<char>( file ),
+                        std::istreambuf_iterator<char>() );
+  }
+
+  void write_file( const char* filename, const byte_vector& bytes ){
+    std::ofstream file( filename, std::ios::out | std::ios::binary );
+    file.write( (const char*) &bytes[0], bytes.size() );
+  }
+
+  u32 get_u32( const byte_vector& bytes, std::size_t offset ){
+    u32 value;
+    std::memcpy( &value, &bytes[offset], sizeof(value) );
+    return value;
+  }
+
+  void set_u32( byte_vector& bytes, std::size_t offset, u32 value ){
+    std::memcpy( &bytes[offset], &value, sizeof(value) );
+  }
+
+  //---------------------------------------------------------------------------
+  // Checks
+  //---------------------------------------------------------------------------
+
+  std::size_t g_failures = 0;
+  std::size_t g_checks   = 0;
+
+  void report( bool passed, const std::string& what ){
+    ++g_checks;
+    if( !passed ){
+      ++g_failures;
+      std::printf( "FAIL %s\n", what.c_str() );
+    }
+  }
+
+  ///
+  /// @brief Checks the classes written to @p bytes against @p samples,
+  ///        through the layout documented in Feature_Database.hpp
+  ///
+  bool same_classes( const byte_vector& bytes, const std::vector<sample_class>& samples ){
+    if( bytes.size() < 64 || get_u32( bytes, 0x0C ) != samples.size() ||
+        get_u32( bytes, 0x10 ) != LENGTH ){
+      return false;
+    }
+    const std::size_t stride        = get_u32( bytes, 0x14 );
+    const std::size_t class_offset  = get_u32( bytes, 0x1C );
+    const std::size_t glyph_offset  = get_u32( bytes, 0x20 );
+    const std::size_t vector_offset = get_u32( bytes, 0x24 );
+
+    if( stride < LENGTH || (vector_offset % 64) != 0 ){
+      return false;
+    }
+
+    for( std::size_t i = 0; i < samples.size(); ++i ){
+      const sample_class& sample = samples[i];
+      const std::size_t   entry  = class_offset + i * 24;
+      const std::size_t   width  = get_u32( bytes, entry + 0x00 );
+      const std::size_t   height = get_u32( bytes, entry + 0x04 );
+      const std::size_t   glyph  = glyph_offset + get_u32( bytes, entry + 0x08 );
+      const std::size_t   first  = get_u32( bytes, entry + 0x0C );
+      const std::size_t   count  = get_u32( bytes, entry + 0x10 );
+      const std::size_t   row    = (width + 7) / 8;
+
+      if( width != sample.glyph.width() || height != sample.glyph.height() ||
+          count != sample.vectors.size() ){
+        return false;
+      }
+
+      for( std::size_t y = 0; y < height; ++y ){
+        for( std::size_t x = 0; x < width; ++x ){
+          const bool ink = (bytes[glyph + y * row + x / 8] >> (7 - x % 8)) & 1;
+          if( ink != (sample.glyph.at( (int) x, (int) y ).r == 0) ){
+            return false;
+          }
+        }
+      }
+
+      for( std::size_t v = 0; v < count; ++v ){
+        for( std::size_t k = 0; k < LENGTH; ++k ){
+          f32 value;
+          std::memcpy( &value, &bytes[vector_offset + ((first + v) * stride + k) * sizeof(f32)], sizeof(value) );
+          if( value != (f32) sample.vectors[v][k] ){
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  ///
+  /// @brief Draws, through @p database, the closest glyph to every vector
+  ///        of @p samples, one beside the other
+  ///
+  Binary_Image draw( const Feature_Database& database, const std::vector<sample_class>& samples ){
+    feature_collection  features;
+    boundary_collection bounds;
+    int                 left = 1;
+
+    for( std::size_t i = 0; i < samples.size(); ++i ){
+      for( std::size_t v = 0; v < samples[i].vectors.size(); ++v ){
+        boundary bound;
+        bound.top    = 1;
+        bound.left   = left;
+        bound.bottom = (int) samples[i].glyph.height();
+        bound.right  = left + (int) samples[i].glyph.width() - 1;
+
+        features.push_back( samples[i].vectors[v] );
+        bounds.push_back( bound );
+        left = bound.right + 2;
+      }
+    }
+
+    Binary_Image image( left, 16 );
+    image.fill( 0 );
+    database.analyze( image, bounds, features );
+    return image;
+  }
+
+  bool same( const Binary_Image& a, const Binary_Image& b ){
+    bool ink = false;
+    for( std::size_t y = 0; y < a.height(); ++y ){
+      for( std::size_t x = 0; x < a.width(); ++x ){
+        if( a.at( (int) x, (int) y ) != b.at( (int) x, (int) y ) ){
+          return false;
+        }
+        ink = ink || a.at( (int) x, (int) y );
+      }
+    }
+    return ink;
+  }
+
+  ///
+  /// @brief Writes @p bytes with the field at @p offset set to @p value,
+  ///        and checks that the result does not load
+  ///
+  void check_rejected( const std::string& name, byte_vector bytes,
+                       std::size_t offset, u32 value ){
+    set_u32( bytes, offset, value );
+    write_file( MANGLED, bytes );
+
+    Feature_Database database;
+    report( !database.load( MANGLED ), name + ": rejected" );
+    report( database.size() == 0, name + ": no classes added" );
+  }
+
+} // anonymous namespace
+
+int main(){
+  std::vector<sample_class> samples;
+  samples.push_back( make_class( 5, 7, 2, 1 ) );
+  samples.push_back( make_class( 9, 4, 3, 2 ) );
+  samples.push_back( make_class( 12, 12, 1, 3 ) );
+  samples.push_back( make_class( 8, 1, 2, 4 ) );
+
+  Feature_Database original;
+  for( std::size_t i = 0; i < samples.size(); ++i ){
+    original.insert( samples[i].glyph, samples[i].vectors );
+  }
+
+  // What is saved holds every class and vector as inserted
+  report( original.save( SAVED ), "save" );
+  const byte_vector saved = read_file( SAVED );
+  report( same_classes( saved, samples ), "saved classes" );
+
+  // What is loaded holds the same, and saves to the same bytes
+  {
+    Feature_Database loaded;
+    report( loaded.load( SAVED ), "load" );
+    report( loaded.size() == samples.size(), "loaded class count" );
+    report( loaded.save( RESAVED ), "save loaded" );
+    report( read_file( RESAVED ) == saved, "loaded saves unchanged" );
+    report( same( draw( loaded, samples ), draw( original, samples ) ), "loaded glyphs" );
+
+    // Loading adds to what is there
+    report( loaded.load( SAVED ) && loaded.size() == 2 * samples.size(), "load twice" );
+  }
+
+  //---------------------------------------------------------------------------
+
+  // Sections past the end of the file
+  const u32 past_end = (u32) saved.size() + 64;
+  check_rejected( "class offset past end",  saved, 0x1C, past_end );
+  check_rejected( "glyph offset past end",  saved, 0x20, past_end );
+  check_rejected( "vector offset past end", saved, 0x24, past_end );
+  check_rejected( "too many classes",       saved, 0x0C, 0x10000000u );
+  check_rejected( "too many vectors",       saved, 0x18, 0x10000000u );
+
+  // A class whose glyph or vectors run past the end of their sections
+  const std::size_t entry = get_u32( saved, 0x1C );
+  check_rejected( "glyph past end",   saved, entry + 0x08, past_end );
+  check_rejected( "vectors past end", saved, entry + 0x0C, get_u32( saved, 0x18 ) );
+  check_rejected( "empty glyph",      saved, entry + 0x00, 0 );
+
+  // Neither the right magic nor version, nor a whole header
+  check_rejected( "bad magic",   saved, 0x00, 0 );
+  check_rejected( "bad version", saved, 0x08, 2 );
+  {
+    write_file( MANGLED, byte_vector( saved.begin(), saved.begin() + 32 ) );
+    Feature_Database database;
+    report( !database.load( MANGLED ), "truncated header: rejected" );
+  }
+
+  std::remove( SAVED );
+  std::remove( RESAVED );
+  std::remove( MANGLED );
+
+  std::printf( "%u of %u checks failed\n",
+               static_cast<unsigned>( g_failures ),
+               static_cast<unsigned>( g_checks ) );
+  return g_failures == 0 ? 0 : 1;
+}
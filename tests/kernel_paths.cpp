@@ -0,0 +1,558 @@
+/**
+ * @file kernel_paths.cpp
+ *
+ * @brief This test checks every path of Kernel_Image_Operator against a
+ *        scalar reference convolution, for every edge mode.
+ *
+ * @author agent (agent@local)
+ * @date   Oct 17, 2026
+ *
+ */
+
+/*
+ * Change Log:
+ *
+ * Oct 17, 2026:
+ * - kernel_paths.cpp created
+ * - Large fractional kernels are checked against an exact sum, ring and
+ *   interior apart
+ */
+#include "ocr/Color.hpp"
+#include "ocr/Image.hpp"
+#include "ocr/Kernel_Image_Operator.hpp"
+#include "ocr/Kernel_Library.hpp"
+#include "ocr/Pixel_Image.hpp"
+
+#include <cmath>    // std::exp, std::fabs, std::floor
+#include <cstddef>  // std::size_t
+#include <cstdio>   // std::printf
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+using namespace ocr;
+
+namespace {
+
+  typedef Kernel_Image_Operator::vector_2d_type kernel_type;
+  typedef Kernel_Image_Operator::edge_handling  edge_handling;
+
+  enum sum_type{
+    sum_per_tap, ///< Truncated as each tap is added
+    sum_exact    ///< Summed exactly, then truncated once
+  };
+
+  //---------------------------------------------------------------------------
+  // Reference
+  //---------------------------------------------------------------------------
+
+  ///
+  /// @brief Truncates an exact sum, held as a float as the operator holds
+  ///        its sums
+  ///
+  s32 truncate_once( f64 sum ){
+    const f64 nearest = std::floor( sum + 0.5 );
+    return (s32) (f32) ((std::fabs( sum - nearest ) < 1e-6) ? nearest : sum);
+  }
+
+  ///
+  /// @brief Convolves @p in with a square @p kernel one pixel at a time,
+  ///        as Kernel_Image_Operator did before it had any faster path
+  ///
+  /// Each tap is added to an integer accumulator, and so truncated as it is
+  /// added, and the sum is divided by the absolute sum of the kernel. With
+  /// sum_exact, the taps are instead summed in double precision and the sum
+  /// truncated once, as the separable and FFT paths do; a sum within a
+  /// rounding error of an integer is taken to be that integer.
+  ///
+  Image reference( const Image& in, const kernel_type& kernel, edge_handling e,
+                   sum_type sum = sum_per_tap ){
+    const u32 size   = static_cast<u32>( kernel.size() );
+    const u32 offset = size / 2;
+    const u32 width  = static_cast<u32>( in.width() );
+    const u32 height = static_cast<u32>( in.height() );
+
+    f32 abs_sum = 0;
+    for( u32 i = 0; i < size; ++i ){
+      for( u32 j = 0; j < size; ++j ){
+        abs_sum += kernel[i][j];
+      }
+    }
+    if( abs_sum < 0 ){
+      abs_sum = -abs_sum;
+    }
+
+    Image out( in.width(), in.height() );
+    std::vector<Color_RGB> values( size * size );
+
+    for( u32 x = 0; x < width; ++x ){
+      for( u32 y = 0; y < height; ++y ){
+        const bool on_top    = (y < offset);
+        const bool on_right  = (x > (width - 1 - offset));
+        const bool on_bottom = (y > (height - 1 - offset));
+        const bool on_left   = (x < offset);
+
+        if( e == Kernel_Image_Operator::edge_crop &&
+            (on_top || on_right || on_bottom || on_left) ){
+          out.set( x, y, Color_RGB::BLACK );
+          continue;
+        }
+
+        for( s32 i = -(s32) offset; i <= (s32) offset; ++i ){
+          for( s32 j = -(s32) offset; j <= (s32) offset; ++j ){
+            Color_RGB& value = values[(i + offset) * size + (j + offset)];
+
+            if( (on_top && j < 0) || (on_left && i < 0) ||
+                (on_right && i > 0) || (on_bottom && j > 0) ){
+              switch( e ){
+              case Kernel_Image_Operator::edge_extend:
+                value = in.at( on_left ? 0 : on_right  ? width - 1  : x,
+                               on_top  ? 0 : on_bottom ? height - 1 : y );
+                break;
+              case Kernel_Image_Operator::edge_wrap:
+                value = in.at( on_left ? width + i - 1  : on_right  ? i : x,
+                               on_top  ? height + j - 1 : on_bottom ? j : y );
+                break;
+              default:
+                value = Color_RGB::GRAY;
+                break;
+              }
+            }else{
+              value = in.at( x + i, y + j );
+            }
+          }
+        }
+
+        s32 r = 0;
+        s32 g = 0;
+        s32 b = 0;
+        if( sum == sum_exact ){
+          f64 sums[3] = { 0, 0, 0 };
+          for( u32 i = 0; i < size; ++i ){
+            for( u32 j = 0; j < size; ++j ){
+              const f64 tap = kernel[size - i - 1][size - j - 1];
+              const Color_RGB& value = values[i * size + j];
+              sums[0] += tap * value.r;
+              sums[1] += tap * value.g;
+              sums[2] += tap * value.b;
+            }
+          }
+          r = truncate_once( sums[0] );
+          g = truncate_once( sums[1] );
+          b = truncate_once( sums[2] );
+        }else{
+          for( u32 i = 0; i < size; ++i ){
+            for( u32 j = 0; j < size; ++j ){
+              const f32 tap = kernel[size - i - 1][size - j - 1];
+              const Color_RGB& value = values[i * size + j];
+              r += tap * value.r;
+              g += tap * value.g;
+              b += tap * value.b;
+            }
+          }
+        }
+        if( abs_sum ){
+          r /= abs_sum;
+          g /= abs_sum;
+          b /= abs_sum;
+        }
+
+        out.set( x, y, Color_RGB( r > 255 ? 255 : r < 0 ? 0 : r,
+                                  g > 255 ? 255 : g < 0 ? 0 : g,
+                                  b > 255 ? 255 : b < 0 ? 0 : b ) );
+      }
+    }
+    return out;
+  }
+
+  //---------------------------------------------------------------------------
+  // Inputs
+  //---------------------------------------------------------------------------
+
+  u32 g_seed = 12345;
+
+  u32 random(){
+    g_seed = g_seed * 1103515245u + 12345u;
+    return (g_seed >> 16) & 0x7fff;
+  }
+
+  ///
+  /// @brief Makes a page of noise, gradients and hard edges
+  ///
+  Image make_page( std::size_t width, std::size_t height ){
+    Image page( width, height );
+    for( std::size_t y = 0; y < height; ++y ){
+      for( std::size_t x = 0; x < width; ++x ){
+        page.set( x, y, Color_RGB( random() & 255,
+                                   (x * 7 + y * 3) & 255,
+                                   ((x / 8 + y / 8) & 1) ? 255 : 0 ) );
+      }
+    }
+    return page;
+  }
+
+  ///
+  /// @brief Makes a page whose channels all hold the red channel of @p page
+  ///
+  Image make_gray( const Image& page ){
+    Image gray( page.width(), page.height() );
+    for( std::size_t y = 0; y < page.height(); ++y ){
+      for( std::size_t x = 0; x < page.width(); ++x ){
+        const ubyte r = page.at( x, y ).r;
+        gray.set( x, y, Color_RGB( r, r, r ) );
+      }
+    }
+    return gray;
+  }
+
+  Gray_Image to_gray_image( const Image& page ){
+    Gray_Image gray( page.width(), page.height() );
+    for( std::size_t y = 0; y < page.height(); ++y ){
+      for( std::size_t x = 0; x < page.width(); ++x ){
+        gray.set( x, y, page.at( x, y ).r );
+      }
+    }
+    return gray;
+  }
+
+  template<std::size_t N>
+  kernel_type make_kernel( const f32 (&taps)[N][N] ){
+    kernel_type kernel( N, std::vector<f32>( N ) );
+    for( std::size_t i = 0; i < N; ++i ){
+      for( std::size_t j = 0; j < N; ++j ){
+        kernel[i][j] = taps[i][j];
+      }
+    }
+    return kernel;
+  }
+
+  ///
+  /// @brief Makes a kernel of small random integers, which is not separable
+  ///
+  kernel_type make_random_kernel( std::size_t size, s32 range ){
+    kernel_type kernel( size, std::vector<f32>( size ) );
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        kernel[i][j] = static_cast<f32>( (s32) (random() % (2 * range + 1)) - range );
+      }
+    }
+    kernel[size / 2][size / 2] += static_cast<f32>( size * size * range );
+    return kernel;
+  }
+
+  ///
+  /// @brief Makes the outer product of binomial coefficients, which is
+  ///        separable
+  ///
+  kernel_type make_binomial_kernel( std::size_t size ){
+    std::vector<f32> row( size, 1 );
+    for( std::size_t n = 1; n < size; ++n ){
+      for( std::size_t k = n - 1; k > 0; --k ){
+        row[k] += row[k - 1];
+      }
+    }
+    kernel_type kernel( size, std::vector<f32>( size ) );
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        kernel[i][j] = row[i] * row[j];
+      }
+    }
+    return kernel;
+  }
+
+  ///
+  /// @brief Makes a Gaussian of unit sum, nudged off the outer product so
+  ///        that it is not separable
+  ///
+  kernel_type make_nudged_gaussian( std::size_t size ){
+    const f64 sigma  = size / 6.0;
+    const f64 centre = (f64) (size / 2);
+
+    std::vector<f64> taps( size * size );
+    f64 total = 0;
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        const f64 di = i - centre;
+        const f64 dj = j - centre;
+        f64 tap = std::exp( -(di * di + dj * dj) / (2 * sigma * sigma) );
+        if( i == j ){
+          tap *= 1.25;
+        }
+        taps[i * size + j] = tap;
+        total += tap;
+      }
+    }
+
+    kernel_type kernel( size, std::vector<f32>( size ) );
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        kernel[i][j] = (f32) (taps[i * size + j] / total);
+      }
+    }
+    return kernel;
+  }
+
+  ///
+  /// @brief Makes a kernel of fractional taps, which is not separable
+  ///
+  kernel_type make_fractional_kernel( std::size_t size ){
+    kernel_type kernel( size, std::vector<f32>( size ) );
+    for( std::size_t i = 0; i < size; ++i ){
+      for( std::size_t j = 0; j < size; ++j ){
+        kernel[i][j] = static_cast<f32>( i * 3 + j ) - 2.5f;
+      }
+    }
+    return kernel;
+  }
+
+  //---------------------------------------------------------------------------
+  // Checks
+  //---------------------------------------------------------------------------
+
+  enum path_type{
+    path_direct,
+    path_fixed_point,
+    path_separable,
+    path_fft
+  };
+
+  const char* const PATH_NAMES[]  = { "direct", "fixed point", "separable", "fft" };
+  const char* const EDGE_NAMES[]  = { "extend", "wrap", "crop", "gray" };
+
+  const edge_handling EDGES[] = {
+    Kernel_Image_Operator::edge_extend,
+    Kernel_Image_Operator::edge_wrap,
+    Kernel_Image_Operator::edge_crop,
+    Kernel_Image_Operator::edge_is_gray
+  };
+
+  std::size_t g_failures = 0;
+  std::size_t g_checks   = 0;
+
+  void report( bool passed, const std::string& what ){
+    ++g_checks;
+    if( !passed ){
+      ++g_failures;
+      std::printf( "FAIL %s\n", what.c_str() );
+    }
+  }
+
+  bool same( const Image& a, const Image& b ){
+    if( a.width() != b.width() || a.height() != b.height() ){
+      return false;
+    }
+    for( std::size_t y = 0; y < a.height(); ++y ){
+      for( std::size_t x = 0; x < a.width(); ++x ){
+        const Color_RGB p = a.at( x, y );
+        const Color_RGB q = b.at( x, y );
+        if( p.r != q.r || p.g != q.g || p.b != q.b ){
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool same( const Gray_Image& a, const Image& b ){
+    if( a.width() != b.width() || a.height() != b.height() ){
+      return false;
+    }
+    for( std::size_t y = 0; y < a.height(); ++y ){
+      for( std::size_t x = 0; x < a.width(); ++x ){
+        if( a.at( x, y ) != b.at( x, y ).r ){
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  ///
+  /// @brief Checks whether the pixels of @p a and @p b agree, either those
+  ///        within @p reach of an edge or those farther in
+  ///
+  bool same_part( const Image& a, const Image& b, std::size_t reach, bool ring ){
+    for( std::size_t y = 0; y < a.height(); ++y ){
+      for( std::size_t x = 0; x < a.width(); ++x ){
+        const bool edge = (x < reach || y < reach ||
+                           x + reach >= a.width() || y + reach >= a.height());
+        if( edge != ring ){
+          continue;
+        }
+        const Color_RGB p = a.at( x, y );
+        const Color_RGB q = b.at( x, y );
+        if( p.r != q.r || p.g != q.g || p.b != q.b ){
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  Image to_image( const Gray_Image& gray ){
+    Image image( gray.width(), gray.height() );
+    for( std::size_t y = 0; y < gray.height(); ++y ){
+      for( std::size_t x = 0; x < gray.width(); ++x ){
+        const ubyte v = gray.at( x, y );
+        image.set( x, y, Color_RGB( v, v, v ) );
+      }
+    }
+    return image;
+  }
+
+  path_type path_of( const Kernel_Image_Operator& op ){
+    if( op.fixed_point() ) return path_fixed_point;
+    if( op.separable() )   return path_separable;
+    if( op.fft_convolved() ) return path_fft;
+    return path_direct;
+  }
+
+  ///
+  /// @brief Checks one kernel on one page, for every edge mode, on one
+  ///        thread and on several, in color and in gray
+  ///
+  void check( const std::string& name, const kernel_type& kernel,
+              path_type expected, const Image& page ){
+    const Image gray = make_gray( page );
+    const Gray_Image gray_page = to_gray_image( page );
+    const std::string size = std::to_string( page.width() ) + "x" +
+                             std::to_string( page.height() );
+
+    for( std::size_t e = 0; e < 4; ++e ){
+      const std::string what = name + " " + EDGE_NAMES[e] + " " + size;
+
+      Kernel_Image_Operator op( kernel, EDGES[e] );
+      const path_type path = path_of( op );
+      report( path == expected,
+              what + ": runs " + PATH_NAMES[path] + ", not " + PATH_NAMES[expected] );
+
+      const Image expected_color = reference( page, kernel, EDGES[e] );
+      const Image expected_gray  = reference( gray, kernel, EDGES[e] );
+      const Image expected_twice = reference( expected_color, kernel, EDGES[e] );
+
+      report( same( op.operate( page ), expected_color ), what + ": color" );
+      report( same( op.operate( gray_page ), expected_gray ), what + ": gray" );
+      report( same( op.operate( page, 2 ), expected_twice ), what + ": twice" );
+
+      op.set_threads( 3 );
+      op.set_tile_rows( 7 );
+      report( same( op.operate( page ), expected_color ), what + ": tiled color" );
+      report( same( op.operate( gray_page ), expected_gray ), what + ": tiled gray" );
+      report( same( op.operate( page, 2 ), expected_twice ), what + ": tiled twice" );
+    }
+  }
+
+  ///
+  /// @brief Checks a fractional kernel that sums exactly, for every edge
+  ///        mode, comparing the ring of pixels the edge handling reaches
+  ///        and the interior apart
+  ///
+  void check_exact( const std::string& name, const kernel_type& kernel,
+                    path_type expected, const Image& page ){
+    const Image gray = make_gray( page );
+    const Gray_Image gray_page = to_gray_image( page );
+    const std::size_t reach = kernel.size() / 2;
+    const std::string size = std::to_string( page.width() ) + "x" +
+                             std::to_string( page.height() );
+
+    for( std::size_t e = 0; e < 4; ++e ){
+      const std::string what = name + " " + EDGE_NAMES[e] + " " + size;
+
+      Kernel_Image_Operator op( kernel, EDGES[e] );
+      const path_type path = path_of( op );
+      report( path == expected,
+              what + ": runs " + PATH_NAMES[path] + ", not " + PATH_NAMES[expected] );
+
+      const Image expected_color = reference( page, kernel, EDGES[e], sum_exact );
+      const Image expected_gray  = reference( gray, kernel, EDGES[e], sum_exact );
+
+      for( std::size_t threads = 1; threads <= 3; threads += 2 ){
+        const std::string run = (threads == 1) ? ": " : ": tiled ";
+
+        op.set_threads( threads );
+        op.set_tile_rows( 7 );
+
+        const Image color = op.operate( page );
+        const Image mono  = to_image( op.operate( gray_page ) );
+        report( same_part( color, expected_color, reach, true ),  what + run + "color ring" );
+        report( same_part( color, expected_color, reach, false ), what + run + "color interior" );
+        report( same_part( mono, expected_gray, reach, true ),    what + run + "gray ring" );
+        report( same_part( mono, expected_gray, reach, false ),   what + run + "gray interior" );
+      }
+    }
+  }
+
+  ///
+  /// @brief Checks a chain of three kernels against the reference applied
+  ///        three times, for every edge mode
+  ///
+  void check_chain( const Image& page ){
+    const kernel_type blur    = make_kernel( kernels::gaussian_blur_3x3 );
+    const kernel_type sharpen = make_kernel( kernels::sharpen );
+    const kernel_type box     = make_binomial_kernel( 5 );
+
+    for( std::size_t e = 0; e < 4; ++e ){
+      const std::string what = std::string( "chain " ) + EDGE_NAMES[e];
+
+      Kernel_Image_Operator first( blur, EDGES[e] );
+      Kernel_Image_Operator second( sharpen, EDGES[e] );
+      Kernel_Image_Operator third( box, EDGES[e] );
+      first.chain( second ).chain( third );
+
+      const Image expected = reference( reference( reference( page, blur, EDGES[e] ),
+                                                   sharpen, EDGES[e] ),
+                                        box, EDGES[e] );
+
+      report( same( first.operate( page ), expected ), what );
+      first.set_threads( 3 );
+      first.set_tile_rows( 7 );
+      report( same( first.operate( page ), expected ), what + ": tiled" );
+    }
+  }
+
+} // anonymous namespace
+
+int main(){
+  const Image pages[] = {
+    make_page( 97, 61 ),
+    make_page( 40, 29 ),
+    make_page( 16, 9 )
+  };
+
+  for( std::size_t p = 0; p < 3; ++p ){
+    const Image& page = pages[p];
+
+    // 16-bit fixed point: integer kernels whose sums fit in 16 bits
+    check( "sharpen", make_kernel( kernels::sharpen ), path_fixed_point, page );
+    check( "gaussian 3x3", make_kernel( kernels::gaussian_blur_3x3 ), path_fixed_point, page );
+    check( "edge detection", make_kernel( kernels::edge_detection ), path_fixed_point, page );
+    check( "random 5x5", make_random_kernel( 5, 1 ), path_fixed_point, page );
+    check( "random 7x7", make_random_kernel( 7, 1 ), path_fixed_point, page );
+
+    // Separable passes
+    check( "gaussian 5x5", make_kernel( kernels::gaussian_blur_5x5 ), path_separable, page );
+    check( "binomial 9x9", make_binomial_kernel( 9 ), path_separable, page );
+
+    // Direct floating point sums
+    check( "unsharp", make_kernel( kernels::unsharp ), path_direct, page );
+    check( "fractional 5x5", make_fractional_kernel( 5 ), path_direct, page );
+    check( "fractional 15x15", make_fractional_kernel( 15 ), path_direct, page );
+  }
+
+  // The FFT, for kernels of FFT_CROSSOVER_AREA taps or more
+  check( "random 21x21", make_random_kernel( 21, 3 ), path_fft, pages[0] );
+  check( "random 25x25", make_random_kernel( 25, 3 ), path_fft, pages[1] );
+
+  // The FFT for fractional kernels, whose sums are truncated once, at the
+  // edges as well as within
+  Image uniform( 61, 47 );
+  uniform.fill( Color_RGB( 200, 200, 200 ) );
+  check_exact( "gaussian 23x23", make_nudged_gaussian( 23 ), path_fft, uniform );
+  check_exact( "gaussian 23x23", make_nudged_gaussian( 23 ), path_fft, pages[0] );
+
+  check_chain( pages[0] );
+
+  std::printf( "%u of %u checks failed\n",
+               static_cast<unsigned>( g_failures ),
+               static_cast<unsigned>( g_checks ) );
+  return g_failures == 0 ? 0 : 1;
+}